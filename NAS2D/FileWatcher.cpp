@@ -0,0 +1,50 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "FileWatcher.h"
+
+#include "Filesystem.h"
+#include "Utility.h"
+
+#include <stdexcept>
+
+
+using namespace NAS2D;
+
+
+/**
+ * Checks whether a file was modified, created or deleted since the last check.
+ *
+ * The first check of a file only records its modification time.
+ */
+bool FileWatcher::hasChanged(const std::string& filePath)
+{
+	auto& filesystem = Utility<Filesystem>::get();
+	auto writeTime = std::filesystem::file_time_type::min();
+	try
+	{
+		if (filesystem.exists(filePath))
+		{
+			writeTime = filesystem.lastWriteTime(filePath);
+		}
+	}
+	catch (const std::runtime_error&)
+	{
+		// Deleted since it was found, which counts as missing
+	}
+
+	const auto [iterator, isNew] = mWriteTimes.try_emplace(filePath, writeTime);
+	if (isNew || iterator->second == writeTime)
+	{
+		return false;
+	}
+
+	iterator->second = writeTime;
+	return true;
+}
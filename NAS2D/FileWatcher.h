@@ -0,0 +1,36 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+
+namespace NAS2D
+{
+	/**
+	 * Detects changes to files by comparing their modification times.
+	 *
+	 * Files are found through the Filesystem search paths. A missing file is
+	 * treated as having a modification time older than any existing file, so
+	 * deleting or creating a file counts as a change.
+	 *
+	 * \note	Not thread safe. Use from one thread at a time.
+	 */
+	class FileWatcher
+	{
+	public:
+		bool hasChanged(const std::string& filePath);
+
+	private:
+		std::map<std::string, std::filesystem::file_time_type> mWriteTimes{};
+	};
+} // namespace NAS2D
@@ -285,6 +285,31 @@ bool Filesystem::exists(const std::filesystem::path& path) const
 }
 
 
+/**
+ * Gets the time a file was last modified.
+ *
+ * \param	path	File path to check.
+ *
+ * \throw	std::runtime_error if the file does not exist.
+ */
+std::filesystem::file_time_type Filesystem::lastWriteTime(const std::filesystem::path& path) const
+{
+	const auto& filePath = findFirstPath(path, mSearchPaths);
+	if (filePath.empty())
+	{
+		throw std::runtime_error("Error reading file time: " + path.string() + " : File does not exist");
+	}
+
+	std::error_code errorCode;
+	const auto writeTime = std::filesystem::last_write_time(filePath, errorCode);
+	if (errorCode)
+	{
+		throw std::runtime_error("Error reading file time: " + path.string() + " : " + errorCode.message());
+	}
+	return writeTime;
+}
+
+
 /**
  * Deletes a specified file.
  *
@@ -54,6 +54,7 @@ namespace NAS2D
 		void makeDirectory(const std::filesystem::path& path);
 
 		bool exists(const std::filesystem::path& path) const;
+		std::filesystem::file_time_type lastWriteTime(const std::filesystem::path& path) const;
 		void del(const std::filesystem::path& path);
 
 		std::string readFile(const std::filesystem::path& filename) const;
@@ -58,6 +58,7 @@ Game::Game(const std::string& title, const std::string& appName, const std::stri
 					{"bitdepth", 32},
 					{"fullscreen", false},
 					{"vsync", true},
+					{"premultipliedalpha", false},
 				}},
 			},
 			{
@@ -0,0 +1,82 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "ShelfPacker.h"
+
+
+using namespace NAS2D;
+
+
+/**
+ * \param	size	Size of the area to pack into.
+ * \param	padding	Space left to the right and below each packed rectangle.
+ */
+ShelfPacker::ShelfPacker(Vector<int> size, int padding) :
+	mSize{size},
+	mPadding{padding}
+{
+}
+
+
+/**
+ * Finds a place for a rectangle.
+ *
+ * \return	Position of the rectangle, or an empty optional if there is no space left for it.
+ */
+std::optional<Point<int>> ShelfPacker::insert(Vector<int> itemSize)
+{
+	const auto paddedSize = itemSize + Vector{mPadding, mPadding};
+
+	Shelf* bestShelf = nullptr;
+	for (auto& shelf : mShelves)
+	{
+		if (shelf.height >= paddedSize.y && shelf.usedWidth + paddedSize.x <= mSize.x && (!bestShelf || shelf.height < bestShelf->height))
+		{
+			bestShelf = &shelf;
+		}
+	}
+
+	if (!bestShelf)
+	{
+		const auto shelfY = usedHeight();
+		if (paddedSize.x > mSize.x || shelfY + paddedSize.y > mSize.y)
+		{
+			return std::nullopt;
+		}
+		bestShelf = &mShelves.emplace_back(Shelf{shelfY, paddedSize.y, 0});
+	}
+
+	const auto position = Point{bestShelf->usedWidth, bestShelf->y};
+	bestShelf->usedWidth += paddedSize.x;
+	return position;
+}
+
+
+/**
+ * Removes all packed rectangles.
+ */
+void ShelfPacker::clear()
+{
+	mShelves.clear();
+}
+
+
+Vector<int> ShelfPacker::size() const
+{
+	return mSize;
+}
+
+
+/**
+ * Height of the area covered by shelves, including padding.
+ */
+int ShelfPacker::usedHeight() const
+{
+	return mShelves.empty() ? 0 : mShelves.back().y + mShelves.back().height;
+}
@@ -0,0 +1,52 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Point.h"
+#include "Vector.h"
+
+#include <optional>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Packs rectangles into a fixed size area using rows of shelves.
+	 *
+	 * Each shelf is as tall as the first rectangle placed on it. Rectangles
+	 * are placed left to right on the shortest shelf they fit on, and a new
+	 * shelf is opened below the last one when none fit. Works well for
+	 * rectangles of similar height, such as font glyphs and sprite frames.
+	 */
+	class ShelfPacker
+	{
+	public:
+		explicit ShelfPacker(Vector<int> size, int padding = 0);
+
+		std::optional<Point<int>> insert(Vector<int> itemSize);
+		void clear();
+
+		Vector<int> size() const;
+		int usedHeight() const;
+
+	private:
+		struct Shelf
+		{
+			int y;
+			int height;
+			int usedWidth;
+		};
+
+		Vector<int> mSize;
+		int mPadding;
+		std::vector<Shelf> mShelves{};
+	};
+} // namespace NAS2D
@@ -12,6 +12,7 @@
 #include "ContainerUtils.h"
 #include "Dictionary.h"
 #include "EventHandler.h"
+#include "FileWatcher.h"
 #include "Filesystem.h"
 #include "FpsCounter.h"
 #include "Game.h"
@@ -20,8 +21,10 @@
 #include "StringUtils.h"
 #include "StringValue.h"
 #include "Timer.h"
+#include "Utf8Range.h"
 #include "Utility.h"
 #include "Version.h"
+#include "WorkerPool.h"
 
 #include "Math/MathUtils.h"
 #include "Math/Trig.h"
@@ -30,11 +33,25 @@
 
 #include "Renderer/Renderer.h"
 
+#include "Resource/BakedFont.h"
+#include "Resource/BinaryData.h"
+#include "Resource/DynamicImage.h"
 #include "Resource/Font.h"
+#include "Resource/HotReload.h"
 #include "Resource/Image.h"
 #include "Resource/Music.h"
+#include "Resource/RichTextLayout.h"
+#include "Resource/SkeletalSprite.h"
+#include "Resource/Skeleton.h"
 #include "Resource/Sound.h"
 #include "Resource/Sprite.h"
+#include "Resource/SpriteAtlas.h"
+#include "Resource/SpriteDefinition.h"
+#include "Resource/SpriteSystem.h"
+#include "Resource/TextLayout.h"
+#include "Resource/TextLayoutCache.h"
+#include "Resource/TextMesh.h"
+#include "Resource/TextureManager.h"
 
 #include "Signal/SignalConnection.h"
 #include "Signal/Delegate.h"
@@ -12,6 +12,17 @@
 
 using namespace NAS2D;
 
+
+namespace
+{
+	constexpr uint8_t scaleByAlpha(uint8_t channel, uint8_t alpha)
+	{
+		// Rounded channel * alpha / 255 without a division
+		const auto product = static_cast<unsigned int>(channel) * alpha + 128u;
+		return static_cast<uint8_t>((product + (product >> 8)) >> 8);
+	}
+}
+
 const Color Color::Black{0, 0, 0};
 const Color Color::Blue{0, 0, 255};
 const Color Color::Green{0, 255, 0};
@@ -53,3 +64,13 @@ Color Color::alphaFade(uint8_t newAlpha) const
 {
 	return {red, green, blue, newAlpha};
 }
+
+
+/**
+ * Gets the color with red, green and blue scaled by alpha, as used when
+ * blending with premultiplied alpha.
+ */
+Color Color::premultiplied() const
+{
+	return {scaleByAlpha(red, alpha), scaleByAlpha(green, alpha), scaleByAlpha(blue, alpha), alpha};
+}
@@ -0,0 +1,127 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+/**
+ * \param	createFunction	Creates a new render target of a size and format.
+ * \param	deleteFunction	Deletes a render target created by createFunction.
+ * \param	maxFreeTargets	Number of released render targets kept for reuse.
+ */
+RenderTargetPool::RenderTargetPool(CreateFunction createFunction, DeleteFunction deleteFunction, std::size_t maxFreeTargets) :
+	mCreateFunction{std::move(createFunction)},
+	mDeleteFunction{std::move(deleteFunction)},
+	mMaxFreeTargets{maxFreeTargets}
+{
+}
+
+
+RenderTargetPool::~RenderTargetPool()
+{
+	clear();
+}
+
+
+/**
+ * Gets a render target of the given size and format, reusing a released one if available.
+ *
+ * \note	Contents of a reused target are undefined. Clear it before use if needed.
+ */
+RenderTarget RenderTargetPool::acquire(Vector<int> size, RenderTargetFormat format)
+{
+	const auto isMatch = [size, format](const RenderTarget& renderTarget) { return renderTarget.size == size && renderTarget.format == format; };
+	// Most recently released first, as it is the most likely to still be resident
+	const auto iterator = std::find_if(mFreeTargets.rbegin(), mFreeTargets.rend(), isMatch);
+
+	RenderTarget renderTarget;
+	if (iterator == mFreeTargets.rend())
+	{
+		renderTarget = mCreateFunction(size, format);
+	}
+	else
+	{
+		renderTarget = *iterator;
+		mFreeTargets.erase(std::next(iterator).base());
+	}
+
+	mAcquiredTargets.push_back(renderTarget);
+	return renderTarget;
+}
+
+
+/**
+ * Returns an acquired render target to the pool for later reuse.
+ *
+ * \throw	std::runtime_error if the target is not currently acquired from this pool.
+ */
+void RenderTargetPool::release(const RenderTarget& renderTarget)
+{
+	const auto isSame = [&renderTarget](const RenderTarget& acquiredTarget) { return acquiredTarget.frameBufferObjectId == renderTarget.frameBufferObjectId && acquiredTarget.textureId == renderTarget.textureId; };
+	const auto iterator = std::find_if(mAcquiredTargets.begin(), mAcquiredTargets.end(), isSame);
+	if (iterator == mAcquiredTargets.end())
+	{
+		throw std::runtime_error("RenderTargetPool::release called with a render target which is not acquired: " + std::to_string(renderTarget.frameBufferObjectId));
+	}
+
+	mFreeTargets.push_back(*iterator);
+	mAcquiredTargets.erase(iterator);
+
+	if (mFreeTargets.size() > mMaxFreeTargets)
+	{
+		mDeleteFunction(mFreeTargets.front());
+		mFreeTargets.erase(mFreeTargets.begin());
+	}
+}
+
+
+/**
+ * Number of render targets acquired and not yet released.
+ */
+std::size_t RenderTargetPool::acquiredCount() const
+{
+	return mAcquiredTargets.size();
+}
+
+
+/**
+ * Number of released render targets available for reuse.
+ */
+std::size_t RenderTargetPool::freeCount() const
+{
+	return mFreeTargets.size();
+}
+
+
+/**
+ * Deletes all render targets, including acquired ones, which become invalid.
+ *
+ * Called by the Renderer before its graphics context is destroyed.
+ */
+void RenderTargetPool::clear()
+{
+	for (const auto& renderTarget : mFreeTargets)
+	{
+		mDeleteFunction(renderTarget);
+	}
+	for (const auto& renderTarget : mAcquiredTargets)
+	{
+		mDeleteFunction(renderTarget);
+	}
+	mFreeTargets.clear();
+	mAcquiredTargets.clear();
+}
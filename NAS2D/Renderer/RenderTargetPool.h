@@ -0,0 +1,86 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Pixel format of the color attachment of a render target.
+	 */
+	enum class RenderTargetFormat
+	{
+		Rgba8,
+		Rgba16F,
+	};
+
+
+	/**
+	 * Offscreen frame buffer object and the texture it renders into.
+	 */
+	struct RenderTarget
+	{
+		unsigned int frameBufferObjectId{0u};
+		unsigned int textureId{0u};
+		Vector<int> size{0, 0};
+		RenderTargetFormat format{RenderTargetFormat::Rgba8};
+	};
+
+
+	/**
+	 * Reuses render targets across transient offscreen passes.
+	 *
+	 * Passes acquire a RenderTarget of a given size and format, and release
+	 * it when done. Released targets are kept and handed out again to later
+	 * requests of the same size and format, so passes such as post-processing
+	 * don't create and delete GL objects every use.
+	 *
+	 * The pool tracks acquired targets, so releasing a target twice, or one
+	 * it did not create, is an error. At most maxFreeTargets released targets
+	 * are kept; releasing more deletes the least recently released one.
+	 *
+	 * Targets are created and deleted by the functions given to the pool,
+	 * which keeps the pool independent of the graphics API.
+	 */
+	class RenderTargetPool
+	{
+	public:
+		using CreateFunction = std::function<RenderTarget(Vector<int> size, RenderTargetFormat format)>;
+		using DeleteFunction = std::function<void(const RenderTarget& renderTarget)>;
+
+		static constexpr std::size_t DefaultMaxFreeTargets{8};
+
+		RenderTargetPool(CreateFunction createFunction, DeleteFunction deleteFunction, std::size_t maxFreeTargets = DefaultMaxFreeTargets);
+		RenderTargetPool(const RenderTargetPool&) = delete;
+		RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+		~RenderTargetPool();
+
+		RenderTarget acquire(Vector<int> size, RenderTargetFormat format);
+		void release(const RenderTarget& renderTarget);
+
+		std::size_t acquiredCount() const;
+		std::size_t freeCount() const;
+
+		void clear();
+
+	private:
+		CreateFunction mCreateFunction;
+		DeleteFunction mDeleteFunction;
+		std::size_t mMaxFreeTargets;
+		std::vector<RenderTarget> mAcquiredTargets{};
+		std::vector<RenderTarget> mFreeTargets{}; /**< Least recently released first. */
+	};
+} // namespace NAS2D
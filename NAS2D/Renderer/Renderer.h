@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Color.h"
+#include "RenderTargetPool.h"
 #include "Window.h"
 #include "../Math/Point.h"
 #include "../Math/Vector.h"
@@ -27,11 +28,27 @@ namespace NAS2D
 
 	class Font;
 	class Image;
+	class RichTextLayout;
+	class TextLayout;
+	class TextMesh;
 
 	template <typename BaseType>
 	struct Rectangle;
 
 
+	/**
+	 * Placement of one sub image in a batch, see Renderer::drawSubImages.
+	 */
+	struct SubImageDraw
+	{
+		Point<float> position; /**< Top left corner before rotation. */
+		Point<float> sourcePosition;
+		Vector<float> size;
+		float degrees;
+		Color color;
+	};
+
+
 	class Renderer : public Window
 	{
 	public:
@@ -44,6 +61,7 @@ namespace NAS2D
 		virtual void drawImage(const Image& image, Point<float> position, float scale = 1.0, Color color = Color::Normal) = 0;
 		virtual void drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color = Color::Normal) = 0;
 		virtual void drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, float degrees, Color color = Color::Normal) = 0;
+		virtual void drawSubImages(const Image& image, const std::vector<SubImageDraw>& subImages) = 0;
 		virtual void drawImageRotated(const Image& image, Point<float> position, float degrees, Color color = Color::Normal, float scale = 1.0f) = 0;
 		virtual void drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color = Color::Normal) = 0;
 		virtual void drawImageRepeated(const Image& image, const Rectangle<float>& rect) = 0;
@@ -51,6 +69,9 @@ namespace NAS2D
 
 		virtual void drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint) = 0;
 
+		virtual RenderTarget acquireRenderTarget(Vector<int> size, RenderTargetFormat format = RenderTargetFormat::Rgba8) = 0;
+		virtual void releaseRenderTarget(const RenderTarget& renderTarget) = 0;
+
 		virtual void drawPoint(Point<float> position, Color color = Color::White) = 0;
 		virtual void drawLine(Point<float> startPosition, Point<float> endPosition, Color color = Color::White, int line_width = 1) = 0;
 		virtual void drawBox(const Rectangle<float>& rect, Color color = Color::White) = 0;
@@ -60,7 +81,11 @@ namespace NAS2D
 		virtual void drawGradient(const Rectangle<float>& rect, Color colorUpperLeft, Color colorLowerLeft, Color colorLowerRight, Color colorUpperRight) = 0;
 
 		virtual void drawText(const Font& font, std::string_view text, Point<float> position, Color color = Color::White) = 0;
-		void drawTextShadow(const Font& font, std::string_view text, Point<float> position, Vector<float> shadowOffset, Color textColor, Color shadowColor);
+		virtual void drawText(const Font& font, std::string_view text, Point<float> position, float scale, Color color = Color::White) = 0;
+		virtual void drawText(const TextLayout& layout, Point<float> position, Color color = Color::White) = 0;
+		virtual void drawText(const TextMesh& mesh, Point<float> position) = 0;
+		virtual void drawText(const RichTextLayout& richText, Point<float> position, Vector<float> shadowOffset = {1, 1}) = 0;
+		virtual void drawTextShadow(const Font& font, std::string_view text, Point<float> position, Vector<float> shadowOffset, Color textColor, Color shadowColor);
 
 		virtual void clearScreen(Color color = Color::Black) = 0;
 
@@ -26,6 +26,7 @@ namespace NAS2D
 
 		void drawSubImage(const Image&, Point<float>, const Rectangle<float>&, Color = Color::Normal) override {}
 		void drawSubImageRotated(const Image&, Point<float>, const Rectangle<float>&, float, Color = Color::Normal) override {}
+		void drawSubImages(const Image&, const std::vector<SubImageDraw>&) override {}
 
 		void drawImageRotated(const Image&, Point<float>, float, Color = Color::Normal, float = 1.0f) override {}
 		void drawImageStretched(const Image&, const Rectangle<float>&, Color = Color::Normal) override {}
@@ -35,6 +36,9 @@ namespace NAS2D
 
 		void drawImageToImage(const Image&, const Image&, Point<float>) override {}
 
+		RenderTarget acquireRenderTarget(Vector<int> size, RenderTargetFormat format = RenderTargetFormat::Rgba8) override { return {0u, 0u, size, format}; }
+		void releaseRenderTarget(const RenderTarget&) override {}
+
 		void drawPoint(Point<float>, Color = Color::White) override {}
 		void drawLine(Point<float>, Point<float>, Color = Color::White, int = 1) override {}
 		void drawBox(const Rectangle<float>&, Color = Color::White) override {}
@@ -44,6 +48,10 @@ namespace NAS2D
 		void drawGradient(const Rectangle<float>&, Color, Color, Color, Color) override {}
 
 		void drawText(const Font&, std::string_view, Point<float>, Color = Color::White) override {}
+		void drawText(const Font&, std::string_view, Point<float>, float, Color = Color::White) override {}
+		void drawText(const TextLayout&, Point<float>, Color = Color::White) override {}
+		void drawText(const TextMesh&, Point<float>) override {}
+		void drawText(const RichTextLayout&, Point<float>, Vector<float> = {1, 1}) override {}
 
 		void clearScreen(Color = Color::Black) override {}
 
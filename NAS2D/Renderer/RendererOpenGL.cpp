@@ -13,12 +13,17 @@
 #include "../Math/VectorSizeRange.h"
 #include "../Resource/Image.h"
 #include "../Resource/Font.h"
+#include "../Resource/RichTextLayout.h"
+#include "../Resource/TextLayout.h"
+#include "../Resource/TextMesh.h"
+#include "../Resource/TextureManager.h"
 #include "../Math/Trig.h"
 #include "../Configuration.h"
 #include "../EventHandler.h"
 #include "../Filesystem.h"
 #include "../Math/MathUtils.h"
 #include "../Utility.h"
+#include "../Utf8Range.h"
 
 #include <SDL2/SDL.h>
 
@@ -80,10 +85,26 @@ namespace
 
 
 	void drawTexturedQuad(GLuint textureId, const std::array<GLfloat, 12>& verticies, const std::array<GLfloat, 12>& textureCoords = DefaultTextureCoords);
+	void drawTexturedTriangles(GLuint textureId, std::vector<GLfloat>& verticies, std::vector<GLfloat>& textureCoords, std::vector<GLubyte>& colors);
+	bool addGlyphQuad(const Font::GlyphMetrics& glyphMetrics, Point<float> penPosition, float scale, GLuint& batchTextureId, std::vector<GLfloat>& verticies, std::vector<GLfloat>& textureCoords, std::vector<GLubyte>& colors);
+	void addQuadColor(Color color, std::vector<GLubyte>& colors);
+	GLuint createDistanceFieldProgram(bool premultipliedAlpha);
+	GLuint compileShader(GLenum type, const std::string& source);
 	void line(Point<float> p1, Point<float> p2, float lineWidth, Color color);
+	RenderTarget generateRenderTarget(Vector<int> size, RenderTargetFormat format);
+	void deleteRenderTarget(const RenderTarget& renderTarget);
+
+	/**
+	 * Converts a color to the form expected by the current blend function.
+	 */
+	Color blendColor(Color color)
+	{
+		return Utility<TextureManager>::get().premultipliedAlpha() ? color.premultiplied() : color;
+	}
 
 	void setColor(Color color)
 	{
+		color = blendColor(color);
 		glColor4ub(color.red, color.green, color.blue, color.alpha);
 	}
 
@@ -92,6 +113,23 @@ namespace
 		const auto apiResult = glGetString(name);
 		return apiResult ? reinterpret_cast<const char*>(apiResult) : "";
 	}
+
+	/**
+	 * Lowest alpha of the text and shadow colors used by styled text.
+	 */
+	uint8_t minimumAlpha(const RichTextLayout& richText)
+	{
+		uint8_t alpha = 255;
+		for (const auto& style : richText.styles())
+		{
+			alpha = std::min(alpha, style.color.alpha);
+			if (style.hasShadow)
+			{
+				alpha = std::min(alpha, style.shadowColor.alpha);
+			}
+		}
+		return alpha;
+	}
 }
 
 
@@ -103,6 +141,7 @@ RendererOpenGL::Options RendererOpenGL::ReadConfigurationOptions()
 		{graphics.get<int>("screenwidth"), graphics.get<int>("screenheight")},
 		graphics.get<bool>("fullscreen"),
 		graphics.get<bool>("vsync"),
+		graphics.get<bool>("premultipliedalpha", false),
 	};
 }
 
@@ -115,6 +154,7 @@ void RendererOpenGL::WriteConfigurationOptions(const Options& options)
 	graphics.set("screenheight", options.resolution.y);
 	graphics.set("fullscreen", options.fullscreen);
 	graphics.set("vsync", options.vsync);
+	graphics.set("premultipliedalpha", options.premultipliedAlpha);
 }
 
 
@@ -124,9 +164,15 @@ RendererOpenGL::RendererOpenGL(const std::string& title) :
 }
 
 
+/**
+ * \note	Premultiplied alpha mode applies to textures uploaded after the Renderer
+ *			is created. Load resources after creating the Renderer when using it.
+ */
 RendererOpenGL::RendererOpenGL(const std::string& title, const Options& options) :
-	Renderer(title)
+	Renderer(title),
+	mRenderTargetPool{generateRenderTarget, deleteRenderTarget}
 {
+	Utility<TextureManager>::get().premultipliedAlpha(options.premultipliedAlpha);
 	initVideo(options.resolution, options.fullscreen, options.vsync);
 }
 
@@ -135,6 +181,17 @@ RendererOpenGL::~RendererOpenGL()
 {
 	Utility<EventHandler>::get().windowResized().disconnect({this, &RendererOpenGL::onResize});
 
+	// GL objects must be released while the context still exists
+	mRenderTargetPool.clear();
+	if (mFrameBufferObjectId != 0)
+	{
+		glDeleteFramebuffers(1, &mFrameBufferObjectId);
+	}
+	if (mDistanceFieldProgram != 0)
+	{
+		glDeleteProgram(mDistanceFieldProgram);
+	}
+
 	SDL_GL_DeleteContext(sdlOglContext);
 	SDL_DestroyWindow(underlyingWindow);
 	underlyingWindow = nullptr;
@@ -211,6 +268,40 @@ void RendererOpenGL::drawSubImageRotated(const Image& image, Point<float> raster
 }
 
 
+/**
+ * Draws many sub images of one image with a single draw call.
+ *
+ * Each sub image is rotated about its center, as with drawSubImageRotated.
+ * Corners are transformed on the CPU, so no matrix changes are needed.
+ */
+void RendererOpenGL::drawSubImages(const Image& image, const std::vector<SubImageDraw>& subImages)
+{
+	if (subImages.empty()) { return; }
+
+	const auto imageSize = image.size().to<float>();
+	for (const auto& subImage : subImages)
+	{
+		const auto halfSize = subImage.size / 2;
+		const auto center = subImage.position + halfSize;
+		const auto unrotated = rectToQuad({{-halfSize.x, -halfSize.y}, subImage.size});
+		const auto textureCoordArray = rectToQuad(Rectangle{subImage.sourcePosition, subImage.size}.skewInverseBy(imageSize));
+
+		const auto radians = subImage.degrees * DEG2RAD;
+		const auto cosAngle = std::cos(radians);
+		const auto sinAngle = std::sin(radians);
+		for (std::size_t i = 0; i < unrotated.size(); i += 2)
+		{
+			mSubImageVertexArray.push_back(center.x + unrotated[i] * cosAngle - unrotated[i + 1] * sinAngle);
+			mSubImageVertexArray.push_back(center.y + unrotated[i] * sinAngle + unrotated[i + 1] * cosAngle);
+		}
+		mSubImageTextureCoordArray.insert(mSubImageTextureCoordArray.end(), textureCoordArray.begin(), textureCoordArray.end());
+		addQuadColor(blendColor(subImage.color), mSubImageColorArray);
+	}
+
+	drawTexturedTriangles(image.textureId(), mSubImageVertexArray, mSubImageTextureCoordArray, mSubImageColorArray);
+}
+
+
 void RendererOpenGL::drawImageRotated(const Image& image, Point<float> position, float degrees, Color color, float scale)
 {
 	glPushMatrix();
@@ -310,17 +401,55 @@ void RendererOpenGL::drawImageToImage(const Image& source, const Image& destinat
 
 	setColor(Color::White);
 
-	glBindTexture(GL_TEXTURE_2D, destination.textureId());
+	const auto destinationTextureId = destination.textureId();
+	// Rendered contents only exist on the GPU and can't be restored from the Image surface
+	Utility<TextureManager>::get().pin(destinationTextureId);
 
-	GLuint fbo = destination.frameBufferObjectId();
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, destination.textureId(), 0);
+	if (mFrameBufferObjectId == 0)
+	{
+		glGenFramebuffers(1, &mFrameBufferObjectId);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, mFrameBufferObjectId);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, destinationTextureId, 0);
 	// OpenGL expects UV texture coordinates to start at the lower left.
 	const auto vertexArray = rectToQuad({{dstPoint.x, static_cast<float>(destination.size().y) - dstPoint.y}, {clipSize.x, -clipSize.y}});
 
 	drawTexturedQuad(source.textureId(), vertexArray);
-	glBindTexture(GL_TEXTURE_2D, destination.textureId());
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Only the base level was rendered to
+	if (destination.filter() == TextureFilter::Trilinear)
+	{
+		glBindTexture(GL_TEXTURE_2D, destinationTextureId);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+}
+
+
+/**
+ * Gets an offscreen render target, reusing a released one of the same size and format.
+ *
+ * Intended for transient offscreen passes such as post-processing. Release
+ * the target with releaseRenderTarget when the pass is done.
+ *
+ * 
+ote	Contents of a reused target are undefined. Clear it before use if needed.
+ */
+RenderTarget RendererOpenGL::acquireRenderTarget(Vector<int> size, RenderTargetFormat format)
+{
+	return mRenderTargetPool.acquire(size, format);
+}
+
+
+/**
+ * Returns a render target from acquireRenderTarget for reuse by later passes.
+ *
+ * 	hrow	std::runtime_error if the target is not currently acquired.
+ */
+void RendererOpenGL::releaseRenderTarget(const RenderTarget& renderTarget)
+{
+	mRenderTargetPool.release(renderTarget);
 }
 
 
@@ -391,6 +520,11 @@ void RendererOpenGL::drawCircle(Point<float> position, float radius, Color color
 
 void RendererOpenGL::drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4)
 {
+	c1 = blendColor(c1);
+	c2 = blendColor(c2);
+	c3 = blendColor(c3);
+	c4 = blendColor(c4);
+
 	glEnableClientState(GL_COLOR_ARRAY);
 	glDisable(GL_TEXTURE_2D);
 
@@ -477,6 +611,18 @@ void RendererOpenGL::drawBoxFilled(const Rectangle<float>& rect, Color color)
 
 
 void RendererOpenGL::drawText(const Font& font, std::string_view text, Point<float> position, Color color)
+{
+	drawText(font, text, position, 1.0f, color);
+}
+
+
+/**
+ * Draws text scaled by a factor.
+ *
+ * Fonts using FontRenderMode::DistanceField stay sharp at any scale. Other
+ * fonts are stretched and become blurry when scaled up.
+ */
+void RendererOpenGL::drawText(const Font& font, std::string_view text, Point<float> position, float scale, Color color)
 {
 	if (text.empty()) { return; }
 
@@ -485,19 +631,145 @@ void RendererOpenGL::drawText(const Font& font, std::string_view text, Point<flo
 	const auto& gml = font.metrics();
 	if (gml.empty()) { return; }
 
-	int offset = 0;
-	for (auto character : text)
+	const auto isDistanceField = font.renderMode() == FontRenderMode::DistanceField;
+	if (isDistanceField) { setDistanceFieldText(true, color.alpha); }
+
+	// Consecutive glyphs on the same texture are drawn with a single call
+	font.beginGlyphBatch();
+	GLuint batchTextureId = 0;
+	addTextQuads(font, text, position, scale, batchTextureId, nullptr);
+	drawTexturedTriangles(batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray);
+
+	if (isDistanceField) { setDistanceFieldText(false); }
+}
+
+
+/**
+ * Draws text with a drop shadow.
+ *
+ * Shadow and text quads are queued together and drawn with per vertex
+ * colors, so both are submitted in a single draw call per glyph texture.
+ */
+void RendererOpenGL::drawTextShadow(const Font& font, std::string_view text, Point<float> position, Vector<float> shadowOffset, Color textColor, Color shadowColor)
+{
+	if (text.empty() || font.metrics().empty()) { return; }
+
+	const auto isDistanceField = font.renderMode() == FontRenderMode::DistanceField;
+	if (isDistanceField) { setDistanceFieldText(true, std::min(textColor.alpha, shadowColor.alpha)); }
+
+	const auto blendedShadowColor = blendColor(shadowColor);
+	const auto blendedTextColor = blendColor(textColor);
+
+	font.beginGlyphBatch();
+	GLuint batchTextureId = 0;
+	addTextQuads(font, text, position + shadowOffset, 1.0f, batchTextureId, &blendedShadowColor);
+	addTextQuads(font, text, position, 1.0f, batchTextureId, &blendedTextColor);
+	drawTexturedTriangles(batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray);
+
+	if (isDistanceField) { setDistanceFieldText(false); }
+}
+
+
+void RendererOpenGL::drawText(const TextLayout& layout, Point<float> position, Color color)
+{
+	setColor(color);
+
+	const auto& font = layout.font();
+	if (font.metrics().empty()) { return; }
+
+	const auto isDistanceField = font.renderMode() == FontRenderMode::DistanceField;
+	if (isDistanceField) { setDistanceFieldText(true, color.alpha); }
+
+	font.beginGlyphBatch();
+	GLuint batchTextureId = 0;
+	for (const auto& glyph : layout.glyphs())
 	{
-		const auto& gm = gml[std::clamp<std::size_t>(static_cast<uint8_t>(character), 0, 255)];
+		addGlyphQuad(font.glyph(glyph.codepoint), position + glyph.offset.to<float>(), 1.0f, batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray);
+	}
 
-		const auto glyphCellSize = font.glyphCellSize().to<float>();
-		const auto adjustX = (gm.minX < 0) ? gm.minX : 0;
-		const auto vertexArray = rectToQuad({{position.x + offset + adjustX, position.y}, glyphCellSize});
-		const auto textureCoordArray = rectToQuad(gm.uvRect);
+	drawTexturedTriangles(batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray);
+
+	if (isDistanceField) { setDistanceFieldText(false); }
+}
 
-		drawTexturedQuad(font.textureId(), vertexArray, textureCoordArray);
-		offset += gm.advance;
+
+/**
+ * Draws text with inline styles, coloring each glyph with per vertex colors.
+ *
+ * Shadows of all shadowed glyphs are queued before the glyphs themselves,
+ * so the whole layout is drawn with a single draw call per glyph texture.
+ */
+void RendererOpenGL::drawText(const RichTextLayout& richText, Point<float> position, Vector<float> shadowOffset)
+{
+	const auto& layout = richText.layout();
+	const auto& font = layout.font();
+	const auto& glyphs = layout.glyphs();
+	const auto& styles = richText.styles();
+	if (glyphs.empty() || font.metrics().empty()) { return; }
+
+	const auto isDistanceField = font.renderMode() == FontRenderMode::DistanceField;
+	if (isDistanceField) { setDistanceFieldText(true, minimumAlpha(richText)); }
+
+	font.beginGlyphBatch();
+	GLuint batchTextureId = 0;
+	if (richText.hasShadow())
+	{
+		const auto shadowPosition = position + shadowOffset;
+		for (std::size_t i = 0; i < glyphs.size(); ++i)
+		{
+			if (!styles[i].hasShadow) { continue; }
+			if (addGlyphQuad(font.glyph(glyphs[i].codepoint), shadowPosition + glyphs[i].offset.to<float>(), 1.0f, batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray))
+			{
+				addQuadColor(blendColor(styles[i].shadowColor), mTextColorArray);
+			}
+		}
+	}
+
+	for (std::size_t i = 0; i < glyphs.size(); ++i)
+	{
+		if (addGlyphQuad(font.glyph(glyphs[i].codepoint), position + glyphs[i].offset.to<float>(), 1.0f, batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray))
+		{
+			addQuadColor(blendColor(styles[i].color), mTextColorArray);
+		}
 	}
+
+	drawTexturedTriangles(batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray);
+
+	if (isDistanceField) { setDistanceFieldText(false); }
+}
+
+
+/**
+ * Draws text from the vertex buffer of a TextMesh, with one draw call per glyph texture.
+ */
+void RendererOpenGL::drawText(const TextMesh& mesh, Point<float> position)
+{
+	const auto vertexBufferId = mesh.vertexBufferId();
+	const auto& batches = mesh.batches();
+	if (batches.empty()) { return; }
+
+	setColor(mesh.color());
+
+	const auto isDistanceField = mesh.font().renderMode() == FontRenderMode::DistanceField;
+	if (isDistanceField) { setDistanceFieldText(true, mesh.color().alpha); }
+
+	glPushMatrix();
+	glTranslatef(position.x, position.y, 0.0f);
+
+	constexpr auto stride = static_cast<GLsizei>(TextMesh::FloatsPerVertex * sizeof(GLfloat));
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+	glVertexPointer(2, GL_FLOAT, stride, nullptr);
+	glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<const void*>(2 * sizeof(GLfloat)));
+	for (const auto& batch : batches)
+	{
+		glBindTexture(GL_TEXTURE_2D, batch.textureId);
+		glDrawArrays(GL_TRIANGLES, batch.firstVertex, batch.vertexCount);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glPopMatrix();
+
+	if (isDistanceField) { setDistanceFieldText(false); }
 }
 
 
@@ -566,7 +838,15 @@ void RendererOpenGL::initGL()
 	glShadeModel(GL_SMOOTH);
 	glEnable(GL_COLOR_MATERIAL);
 	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	if (Utility<TextureManager>::get().premultipliedAlpha())
+	{
+		// Source color is already scaled by alpha. Sources with zero alpha add to the destination.
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	else
+	{
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
 	glDisable(GL_DEPTH_TEST);
 
 	glEnable(GL_LINE_SMOOTH);
@@ -577,10 +857,70 @@ void RendererOpenGL::initGL()
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 
+	if (GLEW_VERSION_2_0)
+	{
+		mDistanceFieldProgram = createDistanceFieldProgram(Utility<TextureManager>::get().premultipliedAlpha());
+	}
+
 	onResize(size());
 }
 
 
+/**
+ * Queues the glyph quads of a line of text.
+ *
+ * \param	color	Per vertex color of the quads, already blended. If null, no
+ *					vertex colors are queued and the current color is used.
+ */
+void RendererOpenGL::addTextQuads(const Font& font, std::string_view text, Point<float> position, float scale, GLuint& batchTextureId, const Color* color)
+{
+	float offset = 0;
+	char32_t previous = 0;
+	for (const auto codepoint : Utf8Range{text})
+	{
+		offset += static_cast<float>(font.kerning(previous, codepoint)) * scale;
+		previous = codepoint;
+
+		const auto& gm = font.glyph(codepoint);
+		if (addGlyphQuad(gm, {position.x + offset, position.y}, scale, batchTextureId, mTextVertexArray, mTextTextureCoordArray, mTextColorArray) && color)
+		{
+			addQuadColor(*color, mTextColorArray);
+		}
+		offset += static_cast<float>(gm.advance) * scale;
+	}
+}
+
+
+/**
+ * Switches between drawing distance field glyphs and regular textures.
+ *
+ * Distance fields are drawn with a shader that turns distance into smooth
+ * edges one screen pixel wide at any scale. Without shader support, an
+ * alpha test at the glyph edge gives sharp but aliased edges instead.
+ *
+ * \param	alpha	Lowest alpha of the text colors. The alpha test sees the
+ *					distance multiplied by the color's alpha, so the edge
+ *					threshold is scaled by it, or translucent text would be
+ *					discarded entirely.
+ */
+void RendererOpenGL::setDistanceFieldText(bool enabled, uint8_t alpha)
+{
+	if (mDistanceFieldProgram != 0)
+	{
+		glUseProgram(enabled ? mDistanceFieldProgram : 0);
+	}
+	else if (enabled)
+	{
+		glEnable(GL_ALPHA_TEST);
+		glAlphaFunc(GL_GEQUAL, 0.5f * static_cast<float>(alpha) / 255.0f);
+	}
+	else
+	{
+		glDisable(GL_ALPHA_TEST);
+	}
+}
+
+
 void RendererOpenGL::initSdl(Vector<int> resolution, bool fullscreen)
 {
 	if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0)
@@ -635,6 +975,40 @@ void RendererOpenGL::initVideo(Vector<int> resolution, bool fullscreen, bool vsy
 
 namespace
 {
+	RenderTarget generateRenderTarget(Vector<int> size, RenderTargetFormat format)
+	{
+		RenderTarget renderTarget{0, 0, size, format};
+		const auto isFloat = format == RenderTargetFormat::Rgba16F;
+
+		glGenTextures(1, &renderTarget.textureId);
+		glBindTexture(GL_TEXTURE_2D, renderTarget.textureId);
+		glTexImage2D(GL_TEXTURE_2D, 0, isFloat ? GL_RGBA16F : GL_RGBA8, size.x, size.y, 0, GL_RGBA, isFloat ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glGenFramebuffers(1, &renderTarget.frameBufferObjectId);
+		glBindFramebuffer(GL_FRAMEBUFFER, renderTarget.frameBufferObjectId);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTarget.textureId, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// Contents only exist on the GPU, so the texture must never be evicted
+		const auto byteSize = size.to<std::size_t>();
+		Utility<TextureManager>::get().add(renderTarget.textureId, byteSize.x * byteSize.y * (isFloat ? 8u : 4u));
+
+		return renderTarget;
+	}
+
+
+	void deleteRenderTarget(const RenderTarget& renderTarget)
+	{
+		Utility<TextureManager>::get().remove(renderTarget.textureId);
+		glDeleteFramebuffers(1, &renderTarget.frameBufferObjectId);
+		glDeleteTextures(1, &renderTarget.textureId);
+	}
+
+
 	void drawTexturedQuad(GLuint textureId, const std::array<GLfloat, 12>& verticies, const std::array<GLfloat, 12>& textureCoords)
 	{
 		glBindTexture(GL_TEXTURE_2D, textureId);
@@ -643,6 +1017,157 @@ namespace
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
 	}
 
+	/**
+	 * Draws quads accumulated as pairs of triangles, then empties the arrays for reuse.
+	 *
+	 * Vertices are drawn with the current color if no vertex colors were queued.
+	 */
+	void drawTexturedTriangles(GLuint textureId, std::vector<GLfloat>& verticies, std::vector<GLfloat>& textureCoords, std::vector<GLubyte>& colors)
+	{
+		if (verticies.empty()) { return; }
+
+		const auto hasColors = !colors.empty();
+		if (hasColors)
+		{
+			glEnableClientState(GL_COLOR_ARRAY);
+			glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors.data());
+		}
+
+		glBindTexture(GL_TEXTURE_2D, textureId);
+		glVertexPointer(2, GL_FLOAT, 0, verticies.data());
+		glTexCoordPointer(2, GL_FLOAT, 0, textureCoords.data());
+		glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(verticies.size() / 2));
+
+		if (hasColors)
+		{
+			glDisableClientState(GL_COLOR_ARRAY);
+		}
+
+		verticies.clear();
+		textureCoords.clear();
+		colors.clear();
+	}
+
+	/**
+	 * Queues the quad of a glyph, drawing the queued quads first if the glyph is on a different texture.
+	 *
+	 * \return	True if a quad was queued. Glyphs without pixels, such as spaces, are skipped.
+	 */
+	bool addGlyphQuad(const Font::GlyphMetrics& glyphMetrics, Point<float> penPosition, float scale, GLuint& batchTextureId, std::vector<GLfloat>& verticies, std::vector<GLfloat>& textureCoords, std::vector<GLubyte>& colors)
+	{
+		if (glyphMetrics.size.x <= 0 || glyphMetrics.size.y <= 0) { return false; }
+
+		if (glyphMetrics.textureId != batchTextureId)
+		{
+			drawTexturedTriangles(batchTextureId, verticies, textureCoords, colors);
+			batchTextureId = glyphMetrics.textureId;
+		}
+
+		const auto vertexArray = rectToQuad({penPosition + glyphMetrics.offset.to<float>() * scale, glyphMetrics.size.to<float>() * scale});
+		const auto textureCoordArray = rectToQuad(glyphMetrics.uvRect);
+		verticies.insert(verticies.end(), vertexArray.begin(), vertexArray.end());
+		textureCoords.insert(textureCoords.end(), textureCoordArray.begin(), textureCoordArray.end());
+		return true;
+	}
+
+	/**
+	 * Queues the color of each vertex of the quad queued last.
+	 */
+	void addQuadColor(Color color, std::vector<GLubyte>& colors)
+	{
+		for (int vertex = 0; vertex < 6; ++vertex)
+		{
+			colors.insert(colors.end(), {color.red, color.green, color.blue, color.alpha});
+		}
+	}
+
+	/**
+	 * Builds the shader program for distance field text.
+	 *
+	 * Works with the fixed function pipeline, taking color and texture
+	 * coordinates from the same client arrays as regular drawing.
+	 *
+	 * \return	Program name, or 0 if the shaders failed to compile or link.
+	 */
+	GLuint createDistanceFieldProgram(bool premultipliedAlpha)
+	{
+		const std::string vertexSource =
+			"#version 110\n"
+			"void main()\n"
+			"{\n"
+			"	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+			"	gl_FrontColor = gl_Color;\n"
+			"	gl_Position = ftransform();\n"
+			"}\n";
+
+		// Glyph edges are at a distance value of 0.5, smoothed over about one screen pixel
+		const std::string fragmentSource = std::string{"#version 110\n"} +
+			(premultipliedAlpha ? "#define PREMULTIPLIED_ALPHA\n" : "") +
+			"uniform sampler2D glyphs;\n"
+			"void main()\n"
+			"{\n"
+			"	float distance = texture2D(glyphs, gl_TexCoord[0].st).a;\n"
+			"	float smoothing = max(0.7 * fwidth(distance), 0.001);\n"
+			"	float coverage = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+			"#ifdef PREMULTIPLIED_ALPHA\n"
+			"	gl_FragColor = gl_Color * coverage;\n"
+			"#else\n"
+			"	gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage);\n"
+			"#endif\n"
+			"}\n";
+
+		const auto vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+		const auto fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+		if (vertexShader == 0 || fragmentShader == 0)
+		{
+			glDeleteShader(vertexShader);
+			glDeleteShader(fragmentShader);
+			return 0;
+		}
+
+		const auto program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		if (linked != GL_TRUE)
+		{
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		glUseProgram(program);
+		glUniform1i(glGetUniformLocation(program, "glyphs"), 0);
+		glUseProgram(0);
+		return program;
+	}
+
+
+	/**
+	 * \return	Shader name, or 0 if compiling failed.
+	 */
+	GLuint compileShader(GLenum type, const std::string& source)
+	{
+		const auto shader = glCreateShader(type);
+		const auto* sourceData = source.c_str();
+		glShaderSource(shader, 1, &sourceData, nullptr);
+		glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+		if (compiled != GL_TRUE)
+		{
+			glDeleteShader(shader);
+			return 0;
+		}
+		return shader;
+	}
+
+
 	void line(Point<float> p1, Point<float> p2, float lineWidth, Color color)
 	{
 
@@ -657,11 +1182,19 @@ namespace
 		 */
 
 
+		// Fading edges use the same color with zero alpha
+		const auto edgeColor = blendColor(color.alphaFade(0));
+		color = blendColor(color);
+
 		float Cr = color.red / 255.0f;
 		float Cg = color.green / 255.0f;
 		float Cb = color.blue / 255.0f;
 		float Ca = color.alpha / 255.0f;
 
+		float Er = edgeColor.red / 255.0f;
+		float Eg = edgeColor.green / 255.0f;
+		float Eb = edgeColor.blue / 255.0f;
+
 		float t = 0.0f;
 		float R = 0.0f;
 		float f = lineWidth - static_cast<float>(static_cast<int>(lineWidth));
@@ -795,14 +1328,14 @@ namespace
 		};
 
 		float line_color[] = {
-			Cr,
-			Cg,
-			Cb,
+			Er,
+			Eg,
+			Eb,
 			0,
 
-			Cr,
-			Cg,
-			Cb,
+			Er,
+			Eg,
+			Eb,
 			0,
 
 			Cr,
@@ -825,14 +1358,14 @@ namespace
 			Cb,
 			Ca,
 
-			Cr,
-			Cg,
-			Cb,
+			Er,
+			Eg,
+			Eb,
 			0,
 
-			Cr,
-			Cg,
-			Cb,
+			Er,
+			Eg,
+			Eb,
 			0,
 		};
 
@@ -876,14 +1409,14 @@ namespace
 			};
 
 			float line_color2[] = {
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0, //cap1
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0,
 
 				Cr,
@@ -891,9 +1424,9 @@ namespace
 				Cb,
 				Ca,
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0,
 
 				Cr,
@@ -901,19 +1434,19 @@ namespace
 				Cb,
 				Ca,
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0,
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0, //cap2
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0,
 
 				Cr,
@@ -921,9 +1454,9 @@ namespace
 				Cb,
 				Ca,
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0,
 
 				Cr,
@@ -931,9 +1464,9 @@ namespace
 				Cb,
 				Ca,
 
-				Cr,
-				Cg,
-				Cb,
+				Er,
+				Eg,
+				Eb,
 				0,
 			};
 
@@ -12,6 +12,7 @@
 #include "Renderer.h"
 
 #include <string>
+#include <vector>
 
 
 using SDL_GLContext = void*;
@@ -27,6 +28,7 @@ namespace NAS2D
 			Vector<int> resolution;
 			bool fullscreen;
 			bool vsync;
+			bool premultipliedAlpha{false};
 		};
 
 		static Options ReadConfigurationOptions();
@@ -50,6 +52,7 @@ namespace NAS2D
 
 		void drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color = Color::Normal) override;
 		void drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, float degrees, Color color = Color::Normal) override;
+		void drawSubImages(const Image& image, const std::vector<SubImageDraw>& subImages) override;
 
 		void drawImageRotated(const Image& image, Point<float> position, float degrees, Color color = Color::Normal, float scale = 1.0f) override;
 		void drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color = Color::Normal) override;
@@ -59,6 +62,9 @@ namespace NAS2D
 
 		void drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint) override;
 
+		RenderTarget acquireRenderTarget(Vector<int> size, RenderTargetFormat format = RenderTargetFormat::Rgba8) override;
+		void releaseRenderTarget(const RenderTarget& renderTarget) override;
+
 		void drawPoint(Point<float> position, Color color = Color::White) override;
 		void drawLine(Point<float> startPosition, Point<float> endPosition, Color color = Color::White, int line_width = 1) override;
 		void drawBox(const Rectangle<float>& rect, Color color = Color::White) override;
@@ -68,6 +74,11 @@ namespace NAS2D
 		void drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4) override;
 
 		void drawText(const Font& font, std::string_view text, Point<float> position, Color color = Color::White) override;
+		void drawText(const Font& font, std::string_view text, Point<float> position, float scale, Color color = Color::White) override;
+		void drawText(const TextLayout& layout, Point<float> position, Color color = Color::White) override;
+		void drawText(const TextMesh& mesh, Point<float> position) override;
+		void drawText(const RichTextLayout& richText, Point<float> position, Vector<float> shadowOffset = {1, 1}) override;
+		void drawTextShadow(const Font& font, std::string_view text, Point<float> position, Vector<float> shadowOffset, Color textColor, Color shadowColor) override;
 
 		void clearScreen(Color color = Color::Black) override;
 
@@ -87,7 +98,19 @@ namespace NAS2D
 
 		void onResize(Vector<int> newSize) override;
 
+		void addTextQuads(const Font& font, std::string_view text, Point<float> position, float scale, unsigned int& batchTextureId, const Color* color);
+		void setDistanceFieldText(bool enabled, uint8_t alpha = 255);
+
 
 		SDL_GLContext sdlOglContext{};
+		unsigned int mFrameBufferObjectId{0u}; /**< Shared by all render to texture draws. */
+		RenderTargetPool mRenderTargetPool;
+		unsigned int mDistanceFieldProgram{0u};
+		std::vector<float> mTextVertexArray{};
+		std::vector<float> mTextTextureCoordArray{};
+		std::vector<unsigned char> mTextColorArray{};
+		std::vector<float> mSubImageVertexArray{};
+		std::vector<float> mSubImageTextureCoordArray{};
+		std::vector<unsigned char> mSubImageColorArray{};
 	};
 } // namespace NAS2D
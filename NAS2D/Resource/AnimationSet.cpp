@@ -12,14 +12,18 @@
 #include "AnimationSet.h"
 
 #include "ResourceCache.h"
+#include "SpriteAtlas.h"
+#include "SpriteCaches.h"
+#include "SpriteDefinition.h"
 #include "../Utility.h"
 #include "../Filesystem.h"
 #include "../ContainerUtils.h"
-#include "../StringUtils.h"
-#include "../ParserHelper.h"
-#include "../Version.h"
-#include "../Xml/Xml.h"
+#include "../Math/Trig.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
 #include <tuple>
 
 
@@ -28,26 +32,16 @@ using namespace NAS2D;
 
 namespace
 {
-	constexpr std::string_view SPRITE_VERSION{"0.99"};
-
 	using ImageCache = ResourceCache<Image, std::string>;
 	ImageCache animationImageCache;
 
-
-	// Adds a row tag to the end of messages.
-	std::string endTag(int row)
-	{
-		return " (Row: " + std::to_string(row) + ")";
-	}
-
 	using ImageSheetMap = AnimationSet::ImageSheetMap;
 	using ActionsMap = AnimationSet::ActionsMap;
 
 
-	std::tuple<ImageSheetMap, ActionsMap> processXml(const std::string& filePath, ImageCache& imageCache);
-	ImageSheetMap processImageSheets(const std::string& basePath, const Xml::XmlElement* element, ImageCache& imageCache);
-	ActionsMap processActions(const ImageSheetMap& imageSheetMap, const Xml::XmlElement* element, ImageCache& imageCache);
-	std::vector<AnimationSet::Frame> processFrames(const ImageSheetMap& imageSheetMap, const Xml::XmlElement* element, ImageCache& imageCache);
+	SpriteDefinition readSpriteDefinition(const std::string& filePath);
+	std::tuple<ImageSheetMap, ActionsMap> processDefinition(const std::string& filePath, ImageCache& imageCache);
+	ActionsMap packActions(const ActionsMap& actions, SpriteAtlas& atlas);
 }
 
 
@@ -61,6 +55,73 @@ bool AnimationSet::Frame::isStopFrame() const
 }
 
 
+/**
+ * Size of the frame as defined, including any trimmed transparent borders.
+ */
+Vector<int> AnimationSet::Frame::size() const
+{
+	return trimOffset + bounds.size + trimMargin;
+}
+
+
+/**
+ * Finds where to draw the frame's bounds for it to be anchored at a position.
+ *
+ * Sub images are rotated about their own center. For trimmed frames, the
+ * bounds are moved to where rotating the whole frame about its center would
+ * put them, so trimming does not change what is drawn.
+ *
+ * \param	anchorPosition	Position of the frame's anchor point.
+ * \param	degrees			Rotation angle the frame is drawn with.
+ */
+Point<float> AnimationSet::Frame::drawPosition(Point<float> anchorPosition, float degrees) const
+{
+	const auto position = anchorPosition - anchorOffset.to<float>();
+	if (degrees == 0.0f || (trimOffset == Vector{0, 0} && trimMargin == Vector{0, 0}))
+	{
+		return position;
+	}
+
+	const auto centerOffset = (trimOffset.to<float>() + bounds.size.to<float>() / 2) - size().to<float>() / 2;
+	const auto radians = degrees * DEG2RAD;
+	const auto cosAngle = std::cos(radians);
+	const auto sinAngle = std::sin(radians);
+	const auto rotatedOffset = Vector{centerOffset.x * cosAngle - centerOffset.y * sinAngle, centerOffset.x * sinAngle + centerOffset.y * cosAngle};
+	return position + (rotatedOffset - centerOffset);
+}
+
+
+/**
+ * Copy of the frame with its bounds shrunk to its opaque pixels.
+ *
+ * The anchor offset is adjusted to keep the pixels in the same place, and
+ * the trimmed borders are recorded so the frame keeps its size.
+ *
+ * Unless the image uses nearest filtering, a 1 pixel transparent border is
+ * kept around the opaque pixels, clamped to the frame. Filtering at the edge
+ * of the trimmed frame then blends with the same transparent pixels as the
+ * untrimmed frame, so it is drawn identically.
+ */
+AnimationSet::Frame AnimationSet::Frame::trimmed() const
+{
+	const auto opaque = image.opaqueBounds(bounds);
+	if (opaque.empty())
+	{
+		return {image, {bounds.position, {0, 0}}, anchorOffset, frameDelay, trimOffset, trimMargin + bounds.size};
+	}
+
+	const auto border = (image.filter() == TextureFilter::Nearest) ? 0 : 1;
+	const auto padded = opaque.inset(-border);
+	const auto start = Point{std::max(padded.position.x, bounds.position.x), std::max(padded.position.y, bounds.position.y)};
+	const auto end = Point{std::min(padded.endPoint().x, bounds.endPoint().x), std::min(padded.endPoint().y, bounds.endPoint().y)};
+	const auto trimmedBounds = Rectangle<int>::Create(start, end);
+
+	const auto addedTrimOffset = trimmedBounds.position - bounds.position;
+	const auto addedTrimMargin = bounds.endPoint() - trimmedBounds.endPoint();
+	return {image, trimmedBounds, anchorOffset - addedTrimOffset, frameDelay, trimOffset + addedTrimOffset, trimMargin + addedTrimMargin};
+}
+
+
 AnimationSet::AnimationSet(std::string fileName) :
 	AnimationSet{std::move(fileName), animationImageCache}
 {
@@ -71,215 +132,371 @@ AnimationSet::AnimationSet(std::string fileName, ImageCache& imageCache) :
 	mImageSheetMap{},
 	mActions{}
 {
-	auto [imageSheetMap, actions] = processXml(fileName, imageCache);
+	auto [imageSheetMap, actions] = processDefinition(fileName, imageCache);
 	mImageSheetMap = std::move(imageSheetMap);
-	mActions = std::move(actions);
+	indexActions(std::move(actions));
+}
+
+
+/**
+ * Loads a sprite definition and packs its frames into an atlas.
+ *
+ * The atlas trims frames of transparent borders, with their anchor offset
+ * adjusted to match. Image sheets are only kept in memory while packing.
+ */
+AnimationSet::AnimationSet(std::string fileName, SpriteAtlas& atlas) :
+	mImageSheetMap{},
+	mActions{}
+{
+	ImageCache imageCache;
+	auto [imageSheetMap, actions] = processDefinition(fileName, imageCache);
+	mImageSheetMap = std::move(imageSheetMap);
+	indexActions(packActions(actions, atlas));
 }
 
 
 AnimationSet::AnimationSet(ImageSheetMap imageSheetMap, ActionsMap actions) :
-	mImageSheetMap{std::move(imageSheetMap)},
-	mActions{std::move(actions)}
+	mImageSheetMap{std::move(imageSheetMap)}
 {
+	indexActions(std::move(actions));
 }
 
 
 std::vector<std::string> AnimationSet::actionNames() const
 {
-	return getKeys(mActions);
+	return getKeys(mActionIds);
 }
 
 
-const std::vector<AnimationSet::Frame>& AnimationSet::frames(const std::string& actionName) const
+/**
+ * Gets the file paths of image sheets, by image sheet id.
+ */
+const AnimationSet::ImageSheetMap& AnimationSet::imageSheets() const
 {
-	if (mActions.find(actionName) == mActions.end())
+	return mImageSheetMap;
+}
+
+
+/**
+ * Resolves the name of an action to its id.
+ *
+ * Ids index actions directly, so looking up frames by id avoids comparing
+ * strings. Ids are only valid for the AnimationSet they came from.
+ *
+ * \throw	std::runtime_error if the action is not defined.
+ */
+AnimationSet::ActionId AnimationSet::actionId(const std::string& actionName) const
+{
+	const auto iterator = mActionIds.find(actionName);
+	if (iterator == mActionIds.end())
 	{
 		throw std::runtime_error("AnimationSet::frames called on undefined action: " + actionName);
 	}
 
-	return mActions.at(actionName);
+	return iterator->second;
 }
 
 
-namespace
+const std::vector<AnimationSet::Frame>& AnimationSet::frames(ActionId actionId) const
 {
-
-	/**
-	 * Parses a Sprite XML Definition File.
-	 *
-	 * \param filePath	File path of the sprite XML definition file.
-	 */
-	std::tuple<ImageSheetMap, ActionsMap> processXml(const std::string& filePath, ImageCache& imageCache)
+	const auto index = static_cast<std::size_t>(actionId);
+	if (index >= mActions.size())
 	{
-		try
-		{
-			auto& filesystem = Utility<Filesystem>::get();
-			const auto basePath = Filesystem::parentPath(filePath);
+		throw std::runtime_error("AnimationSet::frames called on undefined action id: " + std::to_string(index));
+	}
 
-			Xml::XmlDocument xmlDoc;
-			xmlDoc.parse(filesystem.readFile(filePath).c_str());
+	return mActions[index];
+}
 
-			if (xmlDoc.error())
-			{
-				throw std::runtime_error("Sprite file has malformed XML: Row: " + std::to_string(xmlDoc.errorRow()) + " Column: " + std::to_string(xmlDoc.errorCol()) + " : " + xmlDoc.errorDesc());
-			}
 
-			// Find the Sprite node.
-			const auto* xmlRootElement = xmlDoc.firstChildElement("sprite");
-			if (!xmlRootElement)
-			{
-				throw std::runtime_error("Sprite file does not contain required <sprite> tag");
-			}
+const std::vector<AnimationSet::Frame>& AnimationSet::frames(const std::string& actionName) const
+{
+	return mActions[static_cast<std::size_t>(actionId(actionName))];
+}
+
+
+const AnimationSet::Timeline& AnimationSet::actionTimeline(ActionId actionId) const
+{
+	const auto index = static_cast<std::size_t>(actionId);
+	if (index >= mTimelines.size())
+	{
+		throw std::runtime_error("AnimationSet timeline requested for undefined action id: " + std::to_string(index));
+	}
+
+	return mTimelines[index];
+}
+
 
-			// Get the Sprite version.
-			const auto version = xmlRootElement->attribute("version");
-			if (version.empty())
+/**
+ * Stores actions in a flat list, with ids assigned in order of action name,
+ * and builds the table of frame start times of each action.
+ */
+void AnimationSet::indexActions(ActionsMap actions)
+{
+	mTimelines.reserve(actions.size());
+	for (auto& [actionName, frames] : actions)
+	{
+		Timeline timeline;
+		timeline.frameStarts.reserve(frames.size() + 1);
+		unsigned int time = 0;
+		for (std::size_t i = 0; i < frames.size(); ++i)
+		{
+			timeline.frameStarts.push_back(time);
+			if (frames[i].isStopFrame())
 			{
-				throw std::runtime_error("Sprite file's root element does not specify a version");
+				timeline.stopFrames.push_back(i);
 			}
-			if (version != SPRITE_VERSION)
+			else
 			{
-				throw std::runtime_error("Sprite version mismatch. Expected: " + std::string{SPRITE_VERSION} + " Actual: " + versionString());
+				time += frames[i].frameDelay;
 			}
+		}
+		timeline.frameStarts.push_back(time);
 
-			// Note:
-			// Here instead of going through each element and calling a processing function to handle
-			// it, we just iterate through all nodes to find sprite sheets. This allows us to define
-			// image sheets anywhere in the sprite file.
-			auto imageSheetMap = processImageSheets(basePath, xmlRootElement, imageCache);
-			auto actions = processActions(imageSheetMap, xmlRootElement, imageCache);
-			return std::tuple{std::move(imageSheetMap), std::move(actions)};
+		mActionIds.try_emplace(actionName, ActionId{mActions.size()});
+		mActions.push_back(std::move(frames));
+		mTimelines.push_back(std::move(timeline));
+	}
+}
+
+
+/**
+ * Replaces the actions with those of another AnimationSet, such as the same
+ * sprite file loaded again after it was changed.
+ *
+ * Actions keep their ids, and references to their frame lists stay valid,
+ * so Sprites using this AnimationSet continue to work. New actions are added
+ * with new ids. Actions missing from the replacement keep their old frames.
+ *
+ * \note	Must not be called while the AnimationSet is in use on another thread.
+ */
+void AnimationSet::reload(AnimationSet&& replacement)
+{
+	mImageSheetMap = std::move(replacement.mImageSheetMap);
+	for (const auto& [actionName, replacementId] : replacement.mActionIds)
+	{
+		const auto replacementIndex = static_cast<std::size_t>(replacementId);
+		const auto [iterator, isNewAction] = mActionIds.try_emplace(actionName, ActionId{mActions.size()});
+		if (isNewAction)
+		{
+			mActions.push_back(std::move(replacement.mActions[replacementIndex]));
+			mTimelines.push_back(std::move(replacement.mTimelines[replacementIndex]));
 		}
-		catch (const std::runtime_error& error)
+		else
 		{
-			throw std::runtime_error("Error parsing Sprite file: " + filePath + "\nError: " + error.what());
+			const auto index = static_cast<std::size_t>(iterator->second);
+			mActions[index] = std::move(replacement.mActions[replacementIndex]);
+			mTimelines[index] = std::move(replacement.mTimelines[replacementIndex]);
 		}
 	}
+}
 
 
-	/**
-	 * Iterates through all elements of a Sprite XML definition looking
-	 * for 'imagesheet' elements and processes them.
-	 *
-	 * \note	Since 'imagesheet' elements are processed before any other
-	 *			element in a sprite definition, these elements can appear
-	 *			anywhere in a Sprite XML definition.
-	 */
-	ImageSheetMap processImageSheets(const std::string& basePath, const Xml::XmlElement* element, ImageCache& imageCache)
+/**
+ * Advances playback of an action by a time delta.
+ *
+ * Frames are passed while the time delta covers their delay. Playback stops
+ * on reaching a stop frame, and loops after the last frame. The new frame is
+ * found by binary search in the action's table of frame start times, so the
+ * cost does not depend on how much time has passed.
+ *
+ * Advancing from frame 0 by the time since the action started samples the
+ * action at an absolute time, which allows seeking, deterministic replay
+ * from a game clock, time scaling, and not updating hidden sprites at all.
+ *
+ * \param	actionId	Action being played.
+ * \param	frameIndex	Index of the current frame.
+ * \param	timeDelta	Time since the current frame started.
+ */
+AnimationSet::Advance AnimationSet::advance(ActionId actionId, std::size_t frameIndex, unsigned int timeDelta) const
+{
+	const auto& timeline = actionTimeline(actionId);
+	const auto& starts = timeline.frameStarts;
+	if (frameIndex + 1 >= starts.size())
 	{
-		ImageSheetMap imageSheetMap;
+		return {frameIndex, 0, 0, false};
+	}
+
+	const auto frameStart = starts[frameIndex];
+	const auto position = std::uint64_t{frameStart} + timeDelta;
+	const auto frameAt = [&starts](std::uint64_t time) {
+		return static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end() - 1, time) - starts.begin()) - 1;
+	};
 
-		for (const auto* node = element->firstChildElement("imagesheet"); node; node = node->nextSiblingElement("imagesheet"))
+	// Stop frames take no time, so playback stops at the first one whose start is reached
+	const auto nextStop = std::lower_bound(timeline.stopFrames.begin(), timeline.stopFrames.end(), frameIndex);
+	if (nextStop != timeline.stopFrames.end())
+	{
+		if (position >= starts[*nextStop])
 		{
-			const auto dictionary = attributesToDictionary(*node);
-			const auto id = dictionary.get("id");
-			const auto src = dictionary.get("src");
+			return {*nextStop, starts[*nextStop] - frameStart, 1, true};
+		}
+		const auto index = frameAt(position);
+		return {index, starts[index] - frameStart, 0, false};
+	}
 
-			if (id.empty())
-			{
-				throw std::runtime_error("Sprite imagesheet definition has `id` of length zero: " + endTag(node->row()));
-			}
+	const auto duration = std::uint64_t{starts.back()};
+	if (position < duration)
+	{
+		const auto index = frameAt(position);
+		return {index, starts[index] - frameStart, 0, false};
+	}
 
-			if (src.empty())
-			{
-				throw std::runtime_error("Sprite imagesheet definition has `src` of length zero: " + endTag(node->row()));
-			}
+	// Reached the end of the action, so continue from its start
+	auto remaining = position - duration;
+	const auto elapsedToEnd = static_cast<unsigned int>(duration - frameStart);
+	if (!timeline.stopFrames.empty())
+	{
+		const auto firstStop = timeline.stopFrames.front();
+		if (remaining >= starts[firstStop])
+		{
+			return {firstStop, elapsedToEnd + starts[firstStop], 2, true};
+		}
+		const auto index = frameAt(remaining);
+		return {index, elapsedToEnd + starts[index], 1, false};
+	}
 
-			if (imageSheetMap.find(id) != imageSheetMap.end())
-			{
-				throw std::runtime_error("Sprite image sheet redefinition: id: '" + id + "' " + endTag(node->row()));
-			}
+	const auto loops = remaining / duration;
+	remaining %= duration;
+	const auto index = frameAt(remaining);
+	return {index, static_cast<unsigned int>(elapsedToEnd + loops * duration + starts[index]), static_cast<unsigned int>(1 + loops), false};
+}
 
-			const auto imagePath = basePath + src;
-			imageSheetMap.try_emplace(id, imagePath);
-			imageCache.load(imagePath);
-		}
 
-		return imageSheetMap;
+/**
+ * Gets the time it takes to play an action once, up to its end or its first stop frame.
+ */
+unsigned int AnimationSet::duration(ActionId actionId) const
+{
+	const auto& timeline = actionTimeline(actionId);
+	if (timeline.frameStarts.empty())
+	{
+		return 0;
 	}
+	return timeline.stopFrames.empty() ? timeline.frameStarts.back() : timeline.frameStarts[timeline.stopFrames.front()];
+}
 
 
+namespace NAS2D
+{
 	/**
-	 * Iterates through all elements of a Sprite XML definition looking
-	 * for 'action' elements and processes them.
+	 * Cache of image sheets used by AnimationSets loaded from sprite files.
+	 */
+	ResourceCache<Image, std::string>& spriteImageCache()
+	{
+		return animationImageCache;
+	}
+}
+
+
+namespace
+{
+	/**
+	 * Reads a sprite definition, from its compiled sprite file if it is up to date.
+	 *
+	 * A compiled sprite file older than the XML definition is ignored, so
+	 * edits to the XML are not hidden by a stale compiled file. Without the
+	 * XML definition, the compiled sprite file is always used.
+	 *
+	 * \param filePath	File path of the sprite XML definition file.
 	 */
-	ActionsMap processActions(const ImageSheetMap& imageSheetMap, const Xml::XmlElement* element, ImageCache& imageCache)
+	SpriteDefinition readSpriteDefinition(const std::string& filePath)
 	{
-		ActionsMap actions;
+		auto& filesystem = Utility<Filesystem>::get();
+		const auto compiledPath = compiledSpritePath(filePath);
+		if (filesystem.exists(compiledPath) && (!filesystem.exists(filePath) || filesystem.lastWriteTime(compiledPath) >= filesystem.lastWriteTime(filePath)))
+		{
+			return readCompiledSpriteFile(filesystem.readFile(compiledPath));
+		}
+		return parseSpriteXml(filesystem.readFile(filePath));
+	}
 
-		for (const auto* action = element->firstChildElement("action"); action; action = action->nextSiblingElement("action"))
+
+	/**
+	 * Loads the images of a sprite definition and builds its actions.
+	 *
+	 * Frames are trimmed of transparent borders, so they are drawn with
+	 * smaller quads, see Frame::trimmed. Frames packed into an atlas are
+	 * trimmed again by the atlas, which pads them.
+	 *
+	 * \param filePath	File path of the sprite XML definition file.
+	 */
+	std::tuple<ImageSheetMap, ActionsMap> processDefinition(const std::string& filePath, ImageCache& imageCache)
+	{
+		try
 		{
-			const auto dictionary = attributesToDictionary(*action);
-			const auto actionName = dictionary.get("name");
+			const auto basePath = Filesystem::parentPath(filePath);
+			const auto definition = readSpriteDefinition(filePath);
 
-			if (actionName.empty())
+			ImageSheetMap imageSheetMap;
+			std::vector<const Image*> images;
+			for (const auto& imageSheet : definition.imageSheets)
 			{
-				throw std::runtime_error("Sprite Action definition has 'name' of length zero: " + endTag(action->row()));
+				const auto imagePath = basePath + imageSheet.path;
+				imageSheetMap.try_emplace(imageSheet.id, imagePath);
+				images.push_back(&imageCache.load(imagePath));
 			}
-			if (actions.find(actionName) != actions.end())
-			{
-				throw std::runtime_error("Sprite Action redefinition: '" + actionName + "' " + endTag(action->row()));
-			}
-
-			actions[actionName] = processFrames(imageSheetMap, action, imageCache);
 
-			if (actions[actionName].empty())
+			ActionsMap actions;
+			for (const auto& action : definition.actions)
 			{
-				throw std::runtime_error("Sprite Action contains no valid frames: " + actionName);
+				auto& frameList = actions[action.name];
+				for (const auto& frame : action.frames)
+				{
+					const auto& image = *images[frame.sheetIndex];
+					const auto imageRect = Rectangle{{0, 0}, image.size()};
+					if (!imageRect.contains(frame.bounds))
+					{
+						throw std::runtime_error("Sprite frame bounds exceeds image sheet bounds: Action: '" + action.name + "'");
+					}
+
+					frameList.push_back(AnimationSet::Frame{image, frame.bounds, frame.anchorOffset, frame.frameDelay}.trimmed());
+				}
 			}
-		}
 
-		return actions;
+			return std::tuple{std::move(imageSheetMap), std::move(actions)};
+		}
+		catch (const std::runtime_error& error)
+		{
+			throw std::runtime_error("Error parsing Sprite file: " + filePath + "\nError: " + error.what());
+		}
 	}
 
 
 	/**
-	 * Parses through all <frame> tags within an <action> tag in a Sprite Definition.
+	 * Copies the frames of actions into an atlas, one image sheet at a time.
+	 *
+	 * \return	Actions with frames referring to the atlas pages.
 	 */
-	std::vector<AnimationSet::Frame> processFrames(const ImageSheetMap& imageSheetMap, const Xml::XmlElement* element, ImageCache& imageCache)
+	ActionsMap packActions(const ActionsMap& actions, SpriteAtlas& atlas)
 	{
-		std::vector<AnimationSet::Frame> frameList;
-
-		for (const auto* frame = element->firstChildElement("frame"); frame; frame = frame->nextSiblingElement("frame"))
+		std::map<const Image*, std::vector<Rectangle<int>>> sheetFrameBounds;
+		for (const auto& [actionName, frames] : actions)
 		{
-			int currentRow = frame->row();
-
-			const auto dictionary = attributesToDictionary(*frame);
-			reportMissingOrUnexpected(dictionary.keys(), {"sheetid", "x", "y", "width", "height", "anchorx", "anchory"}, {"delay"});
-
-			const auto sheetId = dictionary.get("sheetid");
-			const auto delay = dictionary.get<unsigned int>("delay", 0);
-			const auto x = dictionary.get<int>("x");
-			const auto y = dictionary.get<int>("y");
-			const auto width = dictionary.get<int>("width");
-			const auto height = dictionary.get<int>("height");
-			const auto anchorx = dictionary.get<int>("anchorx");
-			const auto anchory = dictionary.get<int>("anchory");
-
-			if (sheetId.empty())
+			for (const auto& frame : frames)
 			{
-				throw std::runtime_error("Sprite Frame definition has 'sheetid' of length zero: " + endTag(currentRow));
-			}
-			const auto iterator = imageSheetMap.find(sheetId);
-			if (iterator == imageSheetMap.end())
-			{
-				throw std::runtime_error("Sprite Frame definition references undefined imagesheet: '" + sheetId + "' " + endTag(currentRow));
+				sheetFrameBounds[&frame.image].push_back(frame.bounds);
 			}
+		}
 
-			const auto& image = imageCache.load(iterator->second);
+		std::map<const Image*, std::vector<SpriteAtlas::Region>> sheetRegions;
+		for (const auto& [image, frameBounds] : sheetFrameBounds)
+		{
+			sheetRegions.try_emplace(image, atlas.add(*image, frameBounds));
+		}
 
-			const auto frameRect = Rectangle<int>{{x, y}, {width, height}};
-			const auto imageRect = Rectangle{{0, 0}, image.size()};
-			if (!imageRect.contains(frameRect))
+		// Frames are visited in the same order as when their bounds were collected
+		ActionsMap packedActions;
+		std::map<const Image*, std::size_t> nextRegion;
+		for (const auto& [actionName, frames] : actions)
+		{
+			auto& packedFrames = packedActions[actionName];
+			for (const auto& frame : frames)
 			{
-				throw std::runtime_error("Sprite frame bounds exceeds image sheet bounds: " + endTag(currentRow));
+				const auto& region = sheetRegions.at(&frame.image)[nextRegion[&frame.image]++];
+				packedFrames.push_back(AnimationSet::Frame{region.image, region.bounds, frame.anchorOffset - region.trimOffset, frame.frameDelay, frame.trimOffset + region.trimOffset, frame.trimMargin + region.trimMargin});
 			}
-
-			const auto anchorOffset = Vector{anchorx, anchory};
-			frameList.push_back(AnimationSet::Frame{image, frameRect, anchorOffset, delay});
 		}
-
-		return frameList;
+		return packedActions;
 	}
-
 }
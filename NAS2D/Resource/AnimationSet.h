@@ -11,9 +11,12 @@
 #pragma once
 
 #include "Image.h"
+#include "../Math/Point.h"
 #include "../Math/Vector.h"
 #include "../Math/Rectangle.h"
 
+#include <cstddef>
+#include <deque>
 #include <map>
 #include <vector>
 #include <string>
@@ -24,18 +27,41 @@ namespace NAS2D
 	template <typename Resource, typename... Params>
 	class ResourceCache;
 
+	class SpriteAtlas;
+
 
 	class AnimationSet
 	{
 	public:
+		/**
+		 * Index of an action, resolved once from its name with actionId.
+		 */
+		enum class ActionId : std::size_t {};
+
 		struct Frame
 		{
 			const Image& image;
 			Rectangle<int> bounds;
 			Vector<int> anchorOffset;
 			unsigned int frameDelay;
+			Vector<int> trimOffset{0, 0}; /**< Position of bounds within the frame, if transparent borders were trimmed. */
+			Vector<int> trimMargin{0, 0}; /**< Size trimmed from the right and bottom of the frame. */
 
 			bool isStopFrame() const;
+			Vector<int> size() const;
+			Point<float> drawPosition(Point<float> anchorPosition, float degrees) const;
+			Frame trimmed() const;
+		};
+
+		/**
+		 * Playback position after advancing an action, see AnimationSet::advance.
+		 */
+		struct Advance
+		{
+			std::size_t frameIndex;
+			unsigned int elapsed; /**< Time spent by the frames that were passed. */
+			unsigned int completions; /**< Number of times the action looped or reached a stop frame. */
+			bool stopped;
 		};
 
 		using ImageSheetMap = std::map<std::string, std::string>;
@@ -44,14 +70,34 @@ namespace NAS2D
 
 		explicit AnimationSet(std::string fileName);
 		AnimationSet(std::string fileName, ResourceCache<Image, std::string>& imageCache);
+		AnimationSet(std::string fileName, SpriteAtlas& atlas);
 		AnimationSet(ImageSheetMap imageSheetMap, ActionsMap actions);
 
 		std::vector<std::string> actionNames() const;
+		const ImageSheetMap& imageSheets() const;
+		ActionId actionId(const std::string& actionName) const;
+		const std::vector<Frame>& frames(ActionId actionId) const;
 		const std::vector<Frame>& frames(const std::string& actionName) const;
 
+		Advance advance(ActionId actionId, std::size_t frameIndex, unsigned int timeDelta) const;
+		unsigned int duration(ActionId actionId) const;
+
+		void reload(AnimationSet&& replacement);
+
 	private:
+		struct Timeline
+		{
+			std::vector<unsigned int> frameStarts{}; /**< Start time of each frame, then the end of the last frame. */
+			std::vector<std::size_t> stopFrames{};
+		};
+
+		const Timeline& actionTimeline(ActionId actionId) const;
+		void indexActions(ActionsMap actions);
+
 		ImageSheetMap mImageSheetMap;
-		ActionsMap mActions;
+		std::map<std::string, ActionId> mActionIds{};
+		std::deque<std::vector<Frame>> mActions{}; /**< Deque so adding actions on reload does not move existing frame lists. */
+		std::vector<Timeline> mTimelines{};
 	};
 
 } // namespace
@@ -0,0 +1,255 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "BakedFont.h"
+#include "BinaryData.h"
+
+#include "../Math/MathUtils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+
+using namespace NAS2D;
+
+
+// Baked font file layout. All integers are 32 bit little endian.
+//
+// - Magic bytes "NAS2DFNT", format version
+// - Size and contents of the original font file
+// - Number of point sizes, then for each:
+//   - Size in bytes of the rest of the record
+//   - Point size, render mode, height, ascent, atlas width and height,
+//     glyph count, kerning pair count
+//   - Glyphs: minX, minY, maxX, maxY, advance, position, size, offset
+//   - Kerning pairs: previous, current, amount
+//   - Atlas alpha values, row by row
+namespace
+{
+	constexpr std::string_view Magic{"NAS2DFNT"};
+	constexpr std::string_view DataName{"Baked font file"};
+	constexpr std::uint32_t FormatVersion = 3;
+	constexpr std::size_t SizeHeaderFieldCount = 8;
+	constexpr std::size_t GlyphFieldCount = 11;
+	constexpr std::size_t KerningFieldCount = 3;
+	constexpr std::size_t BytesPerTexel = 4;
+	constexpr std::size_t GridCellCount = 16;
+
+
+	BinaryReader openBakedFontFile(std::string_view fileData)
+	{
+		if (!isBakedFontFile(fileData))
+		{
+			throw std::runtime_error("Not a baked font file");
+		}
+
+		BinaryReader reader{fileData, std::string{DataName}};
+		reader.readBytes(Magic.size());
+		const auto version = reader.readUint32();
+		if (version != FormatVersion)
+		{
+			throw std::runtime_error("Unsupported baked font file version: " + std::to_string(version));
+		}
+		return reader;
+	}
+
+
+	/**
+	 * Reads the rest of a point size record, after the point size.
+	 *
+	 * \throw	std::runtime_error if the record is malformed or has bytes left over.
+	 */
+	BakedFont readBakedFontRecord(BinaryReader& reader)
+	{
+		BakedFont bakedFont;
+		const auto renderMode = reader.readUint32();
+		if (renderMode > static_cast<std::uint32_t>(FontRenderMode::DistanceField))
+		{
+			throw std::runtime_error("Baked font file has unknown render mode: " + std::to_string(renderMode));
+		}
+		bakedFont.renderMode = static_cast<FontRenderMode>(renderMode);
+		bakedFont.height = reader.readInt32();
+		bakedFont.ascent = reader.readInt32();
+		bakedFont.atlasSize.x = reader.readInt32();
+		bakedFont.atlasSize.y = reader.readInt32();
+		const auto glyphCount = reader.readUint32();
+		const auto kerningCount = reader.readUint32();
+
+		reader.expectRemaining(glyphCount, GlyphFieldCount * BinaryWriter::FieldSize);
+		bakedFont.glyphs.resize(glyphCount);
+		for (auto& glyph : bakedFont.glyphs)
+		{
+			glyph.minX = reader.readInt32();
+			glyph.minY = reader.readInt32();
+			glyph.maxX = reader.readInt32();
+			glyph.maxY = reader.readInt32();
+			glyph.advance = reader.readInt32();
+			glyph.position.x = reader.readInt32();
+			glyph.position.y = reader.readInt32();
+			glyph.size.x = reader.readInt32();
+			glyph.size.y = reader.readInt32();
+			glyph.offset.x = reader.readInt32();
+			glyph.offset.y = reader.readInt32();
+		}
+
+		reader.expectRemaining(kerningCount, KerningFieldCount * BinaryWriter::FieldSize);
+		bakedFont.kerningPairs.resize(kerningCount);
+		for (auto& kerningPair : bakedFont.kerningPairs)
+		{
+			kerningPair.previous = reader.readUint32();
+			kerningPair.current = reader.readUint32();
+			kerningPair.amount = reader.readInt32();
+		}
+
+		const auto atlasSize = bakedFont.atlasSize.to<std::size_t>();
+		const auto atlas = reader.readBytes(atlasSize.x * atlasSize.y);
+		bakedFont.atlas.assign(atlas.begin(), atlas.end());
+		reader.expectEnd();
+		return bakedFont;
+	}
+}
+
+
+namespace NAS2D
+{
+	/**
+	 * Checks if file contents start with the signature of a baked font file.
+	 */
+	bool isBakedFontFile(std::string_view fileData)
+	{
+		return fileData.substr(0, Magic.size()) == Magic;
+	}
+
+
+	/**
+	 * Creates the contents of a baked font file.
+	 *
+	 * \param	fontData	Contents of the TrueType or OpenType font file the fonts were baked from.
+	 *						Stored so glyphs outside the atlas can still be rasterized on demand.
+	 * \param	bakedFonts	Font baked at each point size to include.
+	 */
+	std::string writeBakedFontFile(std::string_view fontData, const std::vector<BakedFont>& bakedFonts)
+	{
+		std::string output;
+		BinaryWriter writer{output};
+		writer.writeBytes(Magic);
+		writer.writeUint32(FormatVersion);
+		writer.writeString(fontData);
+		writer.writeUint32(static_cast<std::uint32_t>(bakedFonts.size()));
+
+		for (const auto& bakedFont : bakedFonts)
+		{
+			const auto recordSize = (SizeHeaderFieldCount + bakedFont.glyphs.size() * GlyphFieldCount + bakedFont.kerningPairs.size() * KerningFieldCount) * BinaryWriter::FieldSize + bakedFont.atlas.size();
+			writer.writeUint32(static_cast<std::uint32_t>(recordSize));
+
+			writer.writeUint32(bakedFont.pointSize);
+			writer.writeUint32(static_cast<std::uint32_t>(bakedFont.renderMode));
+			writer.writeInt32(bakedFont.height);
+			writer.writeInt32(bakedFont.ascent);
+			writer.writeInt32(bakedFont.atlasSize.x);
+			writer.writeInt32(bakedFont.atlasSize.y);
+			writer.writeUint32(static_cast<std::uint32_t>(bakedFont.glyphs.size()));
+			writer.writeUint32(static_cast<std::uint32_t>(bakedFont.kerningPairs.size()));
+
+			for (const auto& glyph : bakedFont.glyphs)
+			{
+				for (const auto value : {glyph.minX, glyph.minY, glyph.maxX, glyph.maxY, glyph.advance, glyph.position.x, glyph.position.y, glyph.size.x, glyph.size.y, glyph.offset.x, glyph.offset.y})
+				{
+					writer.writeInt32(value);
+				}
+			}
+
+			for (const auto& kerningPair : bakedFont.kerningPairs)
+			{
+				writer.writeUint32(kerningPair.previous);
+				writer.writeUint32(kerningPair.current);
+				writer.writeInt32(kerningPair.amount);
+			}
+
+			writer.writeBytes({reinterpret_cast<const char*>(bakedFont.atlas.data()), bakedFont.atlas.size()});
+		}
+
+		return output;
+	}
+
+
+	/**
+	 * Reads the font baked at a point size from the contents of a baked font file.
+	 *
+	 * Records of other point sizes are skipped without being parsed.
+	 *
+	 * \throw	std::runtime_error if the file is malformed or has no font of the point size.
+	 */
+	BakedFont readBakedFont(std::string_view fileData, unsigned int ptSize)
+	{
+		auto reader = openBakedFontFile(fileData);
+		reader.readBytes(reader.readUint32());
+
+		const auto sizeCount = reader.readUint32();
+		for (std::uint32_t i = 0; i < sizeCount; ++i)
+		{
+			const auto recordSize = reader.readUint32();
+			auto recordReader = BinaryReader{reader.readBytes(recordSize), std::string{DataName}};
+			if (recordReader.readUint32() == ptSize)
+			{
+				auto bakedFont = readBakedFontRecord(recordReader);
+				bakedFont.pointSize = ptSize;
+				return bakedFont;
+			}
+		}
+
+		throw std::runtime_error("Baked font file has no font of point size: " + std::to_string(ptSize));
+	}
+
+
+	/**
+	 * Gets the contents of the original font file stored in a baked font file.
+	 *
+	 * \return	View into the given file data.
+	 */
+	std::string_view readBakedFontData(std::string_view fileData)
+	{
+		auto reader = openBakedFontFile(fileData);
+		return reader.readBytes(reader.readUint32());
+	}
+
+
+	/**
+	 * Size in bytes of the RGBA texture uploaded from the atlas.
+	 */
+	std::size_t textureByteSize(const BakedFont& bakedFont)
+	{
+		const auto atlasSize = bakedFont.atlasSize.to<std::size_t>();
+		return atlasSize.x * atlasSize.y * BytesPerTexel;
+	}
+
+
+	/**
+	 * Size in bytes the texture would have with glyphs in a 16x16 grid.
+	 *
+	 * Each cell is as wide as the widest advance and as tall as the font,
+	 * rounded up to powers of two, which is how glyphs were laid out before
+	 * they were packed. Compared with textureByteSize to report the savings
+	 * of packing.
+	 */
+	std::size_t gridTextureByteSize(const BakedFont& bakedFont)
+	{
+		int maxAdvance = 0;
+		for (const auto& glyph : bakedFont.glyphs)
+		{
+			maxAdvance = std::max(maxAdvance, glyph.advance);
+		}
+
+		const auto cellSize = Vector{roundUpPowerOf2(static_cast<uint32_t>(std::max(maxAdvance, 1))), roundUpPowerOf2(static_cast<uint32_t>(std::max(bakedFont.height, 1)))}.to<std::size_t>();
+		const auto gridSize = cellSize * GridCellCount;
+		return gridSize.x * gridSize.y * BytesPerTexel;
+	}
+}
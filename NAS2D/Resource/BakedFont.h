@@ -0,0 +1,66 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Font.h"
+#include "GlyphCache.h"
+
+#include "../Math/Point.h"
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Glyph atlas and metrics of a TrueType or OpenType font at one point size.
+	 *
+	 * Produced by Font::bake, and stored in baked font files so a Font can be
+	 * loaded without rasterizing any glyphs. The atlas holds only the alpha
+	 * value of each pixel.
+	 */
+	struct BakedFont
+	{
+		struct Glyph
+		{
+			int minX{0};
+			int minY{0};
+			int maxX{0};
+			int maxY{0};
+			int advance{0};
+			Point<int> position{0, 0}; /**< Position of the glyph's area in the atlas. */
+			Vector<int> size{0, 0};
+			Vector<int> offset{0, 0};
+		};
+
+		unsigned int pointSize{0u};
+		FontRenderMode renderMode{FontRenderMode::Coverage};
+		int height{0};
+		int ascent{0};
+		Vector<int> atlasSize{0, 0};
+		std::vector<Glyph> glyphs{};
+		std::vector<KerningPair> kerningPairs{};
+		std::vector<std::uint8_t> atlas{};
+	};
+
+
+	bool isBakedFontFile(std::string_view fileData);
+	std::string writeBakedFontFile(std::string_view fontData, const std::vector<BakedFont>& bakedFonts);
+	BakedFont readBakedFont(std::string_view fileData, unsigned int ptSize);
+	std::string_view readBakedFontData(std::string_view fileData);
+
+	std::size_t textureByteSize(const BakedFont& bakedFont);
+	std::size_t gridTextureByteSize(const BakedFont& bakedFont);
+} // namespace NAS2D
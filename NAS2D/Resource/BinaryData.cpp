@@ -0,0 +1,140 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "BinaryData.h"
+
+#include <stdexcept>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+BinaryWriter::BinaryWriter(std::string& output) :
+	mOutput{output}
+{
+}
+
+
+void BinaryWriter::writeUint32(std::uint32_t value)
+{
+	for (std::size_t byte = 0; byte < FieldSize; ++byte)
+	{
+		mOutput.push_back(static_cast<char>((value >> (byte * 8)) & 0xFF));
+	}
+}
+
+
+void BinaryWriter::writeInt32(int value)
+{
+	writeUint32(static_cast<std::uint32_t>(value));
+}
+
+
+void BinaryWriter::writeString(std::string_view value)
+{
+	writeUint32(static_cast<std::uint32_t>(value.size()));
+	writeBytes(value);
+}
+
+
+void BinaryWriter::writeBytes(std::string_view bytes)
+{
+	mOutput.append(bytes);
+}
+
+
+/**
+ * \param	data		Data to read. Must outlive the reader.
+ * \param	dataName	Description of the data used in error messages, such as "Baked font file".
+ */
+BinaryReader::BinaryReader(std::string_view data, std::string dataName) :
+	mData{data},
+	mDataName{std::move(dataName)}
+{
+}
+
+
+std::uint32_t BinaryReader::readUint32()
+{
+	const auto field = readBytes(BinaryWriter::FieldSize);
+	std::uint32_t value = 0;
+	for (std::size_t byte = 0; byte < BinaryWriter::FieldSize; ++byte)
+	{
+		value |= static_cast<std::uint32_t>(static_cast<unsigned char>(field[byte])) << (byte * 8);
+	}
+	return value;
+}
+
+
+int BinaryReader::readInt32()
+{
+	return static_cast<int>(readUint32());
+}
+
+
+std::string BinaryReader::readString()
+{
+	return std::string{readBytes(readUint32())};
+}
+
+
+/**
+ * Reads bytes without copying them.
+ *
+ * \return	View into the data given to the constructor.
+ * \throw	std::runtime_error if fewer bytes remain.
+ */
+std::string_view BinaryReader::readBytes(std::size_t count)
+{
+	if (count > remaining())
+	{
+		throw std::runtime_error(mDataName + " is truncated");
+	}
+	const auto bytes = mData.substr(mPosition, count);
+	mPosition += count;
+	return bytes;
+}
+
+
+std::size_t BinaryReader::remaining() const
+{
+	return mData.size() - mPosition;
+}
+
+
+/**
+ * Checks that enough bytes remain for a number of fields read from the data.
+ *
+ * Used before allocating storage for a count read from the data, so a
+ * corrupted count can not cause a huge allocation.
+ *
+ * \param	count		Number of fields.
+ * \param	fieldSize	Smallest size in bytes of one field.
+ * \throw	std::runtime_error if fewer bytes remain.
+ */
+void BinaryReader::expectRemaining(std::size_t count, std::size_t fieldSize) const
+{
+	if (fieldSize != 0 && count > remaining() / fieldSize)
+	{
+		throw std::runtime_error(mDataName + " is truncated");
+	}
+}
+
+
+/**
+ * \throw	std::runtime_error if any bytes remain.
+ */
+void BinaryReader::expectEnd() const
+{
+	if (remaining() != 0)
+	{
+		throw std::runtime_error(mDataName + " has " + std::to_string(remaining()) + " unexpected trailing bytes");
+	}
+}
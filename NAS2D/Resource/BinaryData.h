@@ -0,0 +1,68 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+namespace NAS2D
+{
+	/**
+	 * Appends fields of binary resource files, such as baked fonts.
+	 *
+	 * Integers are written as 32 bit little endian, and strings as their
+	 * length followed by their bytes.
+	 */
+	class BinaryWriter
+	{
+	public:
+		static constexpr std::size_t FieldSize{4};
+
+		explicit BinaryWriter(std::string& output);
+
+		void writeUint32(std::uint32_t value);
+		void writeInt32(int value);
+		void writeString(std::string_view value);
+		void writeBytes(std::string_view bytes);
+
+	private:
+		std::string& mOutput;
+	};
+
+
+	/**
+	 * Reads fields written by a BinaryWriter.
+	 *
+	 * Reading past the end of the data throws, so files truncated or
+	 * corrupted on disk are reported instead of read out of bounds.
+	 */
+	class BinaryReader
+	{
+	public:
+		BinaryReader(std::string_view data, std::string dataName);
+
+		std::uint32_t readUint32();
+		int readInt32();
+		std::string readString();
+		std::string_view readBytes(std::size_t count);
+
+		std::size_t remaining() const;
+		void expectRemaining(std::size_t count, std::size_t fieldSize) const;
+		void expectEnd() const;
+
+	private:
+		std::string_view mData;
+		std::string mDataName;
+		std::size_t mPosition{0};
+	};
+} // namespace NAS2D
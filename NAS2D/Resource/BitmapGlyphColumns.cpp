@@ -0,0 +1,74 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "BitmapGlyphColumns.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr int GlyphMatrixSize = 16;
+}
+
+
+namespace NAS2D
+{
+	/**
+	 * Finds the columns of each glyph cell of a bitmap font with any coverage.
+	 *
+	 * Pixels of each column are combined with a bitwise or, which compilers
+	 * vectorize, so the glyph matrix is scanned once without branching per pixel.
+	 *
+	 * \param	pixels			32 bit pixels of a 16x16 matrix of glyph cells.
+	 * \param	pixelsPerRow	Distance in pixels from the start of one row to the next.
+	 * \param	glyphSize		Size in pixels of each glyph cell.
+	 * \param	alphaMask		Bits of a pixel holding its alpha value.
+	 *
+	 * \return	First and one past last covered column of each cell, relative to
+	 *			the cell, in row major order. Cells without coverage are {0, 0}.
+	 */
+	std::vector<std::pair<int, int>> bitmapGlyphColumns(const std::uint32_t* pixels, std::size_t pixelsPerRow, Vector<int> glyphSize, std::uint32_t alphaMask)
+	{
+		std::vector<std::pair<int, int>> glyphColumns(GlyphMatrixSize * GlyphMatrixSize, {0, 0});
+		std::vector<std::uint32_t> columnCoverage(static_cast<std::size_t>(glyphSize.x * GlyphMatrixSize));
+		const auto isCovered = [alphaMask](std::uint32_t coverage) { return (coverage & alphaMask) != 0; };
+
+		for (int cellY = 0; cellY < GlyphMatrixSize; ++cellY)
+		{
+			std::fill(columnCoverage.begin(), columnCoverage.end(), 0u);
+			for (int y = cellY * glyphSize.y; y < (cellY + 1) * glyphSize.y; ++y)
+			{
+				const auto* row = pixels + static_cast<std::size_t>(y) * pixelsPerRow;
+				for (std::size_t x = 0; x < columnCoverage.size(); ++x)
+				{
+					columnCoverage[x] |= row[x];
+				}
+			}
+
+			for (int cellX = 0; cellX < GlyphMatrixSize; ++cellX)
+			{
+				const auto cellStart = columnCoverage.begin() + cellX * glyphSize.x;
+				const auto cellEnd = cellStart + glyphSize.x;
+				const auto first = std::find_if(cellStart, cellEnd, isCovered);
+				const auto last = std::find_if(std::make_reverse_iterator(cellEnd), std::make_reverse_iterator(first), isCovered).base();
+				if (first != cellEnd)
+				{
+					glyphColumns[static_cast<std::size_t>(cellY * GlyphMatrixSize + cellX)] = {static_cast<int>(first - cellStart), static_cast<int>(last - cellStart)};
+				}
+			}
+		}
+
+		return glyphColumns;
+	}
+}
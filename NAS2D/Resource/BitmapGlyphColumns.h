@@ -0,0 +1,23 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace NAS2D
+{
+	std::vector<std::pair<int, int>> bitmapGlyphColumns(const std::uint32_t* pixels, std::size_t pixelsPerRow, Vector<int> glyphSize, std::uint32_t alphaMask);
+} // namespace NAS2D
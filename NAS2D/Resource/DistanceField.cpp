@@ -0,0 +1,164 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr float Infinity = 1e20f;
+	constexpr std::uint8_t CoverageThreshold = 128;
+
+	std::vector<float> squaredDistances(const std::vector<bool>& isFeature, Vector<std::size_t> size);
+	void squaredDistances1d(const float* sampled, std::size_t count, std::size_t stride, float* distances, std::vector<std::size_t>& parabolaVertices, std::vector<float>& parabolaBoundaries, std::vector<float>& scratch);
+}
+
+
+namespace NAS2D
+{
+	/**
+	 * Converts the alpha coverage of an image into a signed distance field.
+	 *
+	 * Pixels with at least half coverage are inside the shape. Each output
+	 * pixel stores the distance to the edge of the shape, mapped so that the
+	 * edge is at 128, inside is above and outside is below. Distances beyond
+	 * \c spread pixels are clamped to 0 or 255.
+	 *
+	 * The field is \c spread pixels larger than the image on every side, so
+	 * the area around the edges of the shape is not cut off.
+	 *
+	 * \param	coverage	Alpha values of the image, row by row.
+	 * \param	size		Size of the image in pixels.
+	 * \param	spread		Distance in pixels covered by the range of output values.
+	 *
+	 * \return	Distance values of the field, row by row, of size (size + 2 * spread).
+	 */
+	std::vector<std::uint8_t> distanceField(const std::vector<std::uint8_t>& coverage, Vector<int> size, int spread)
+	{
+		spread = std::max(spread, 0);
+		const auto fieldSize = (size + Vector{spread, spread} * 2).to<std::size_t>();
+		const auto pixelCount = fieldSize.x * fieldSize.y;
+
+		std::vector<bool> isInside(pixelCount, false);
+		for (int y = 0; y < size.y; ++y)
+		{
+			for (int x = 0; x < size.x; ++x)
+			{
+				const auto fieldIndex = static_cast<std::size_t>(y + spread) * fieldSize.x + static_cast<std::size_t>(x + spread);
+				isInside[fieldIndex] = coverage[static_cast<std::size_t>(y * size.x + x)] >= CoverageThreshold;
+			}
+		}
+
+		std::vector<bool> isOutside(pixelCount);
+		std::transform(isInside.begin(), isInside.end(), isOutside.begin(), [](bool inside) { return !inside; });
+
+		const auto distancesToInside = squaredDistances(isInside, fieldSize);
+		const auto distancesToOutside = squaredDistances(isOutside, fieldSize);
+
+		// The edge lies half way between an inside pixel and its outside neighbor
+		const auto scale = (spread > 0) ? 0.5f / static_cast<float>(spread) : 0.5f;
+		std::vector<std::uint8_t> field(pixelCount);
+		for (std::size_t i = 0; i < pixelCount; ++i)
+		{
+			const auto signedDistance = isInside[i] ? 0.5f - std::sqrt(distancesToOutside[i]) : std::sqrt(distancesToInside[i]) - 0.5f;
+			const auto value = std::clamp(0.5f - signedDistance * scale, 0.0f, 1.0f);
+			field[i] = static_cast<std::uint8_t>(std::lround(value * 255.0f));
+		}
+		return field;
+	}
+}
+
+
+namespace
+{
+	/**
+	 * Exact squared Euclidean distance from each pixel to the nearest feature pixel.
+	 *
+	 * Separable transform by Felzenszwalb and Huttenlocher, run over columns and then rows.
+	 */
+	std::vector<float> squaredDistances(const std::vector<bool>& isFeature, Vector<std::size_t> size)
+	{
+		std::vector<float> sampled(isFeature.size());
+		std::transform(isFeature.begin(), isFeature.end(), sampled.begin(), [](bool feature) { return feature ? 0.0f : Infinity; });
+
+		const auto maxLength = std::max(size.x, size.y);
+		std::vector<std::size_t> parabolaVertices(maxLength);
+		std::vector<float> parabolaBoundaries(maxLength + 1);
+		std::vector<float> scratch(maxLength);
+		std::vector<float> distances(isFeature.size());
+
+		for (std::size_t x = 0; x < size.x; ++x)
+		{
+			squaredDistances1d(sampled.data() + x, size.y, size.x, distances.data() + x, parabolaVertices, parabolaBoundaries, scratch);
+		}
+		for (std::size_t y = 0; y < size.y; ++y)
+		{
+			squaredDistances1d(distances.data() + y * size.x, size.x, 1, distances.data() + y * size.x, parabolaVertices, parabolaBoundaries, scratch);
+		}
+		return distances;
+	}
+
+
+	/**
+	 * One dimensional pass of the distance transform, computed as the lower envelope of parabolas.
+	 *
+	 * Input and output may be the same array.
+	 */
+	void squaredDistances1d(const float* sampled, std::size_t count, std::size_t stride, float* distances, std::vector<std::size_t>& parabolaVertices, std::vector<float>& parabolaBoundaries, std::vector<float>& scratch)
+	{
+		if (count == 0) { return; }
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			scratch[i] = sampled[i * stride];
+		}
+
+		const auto intersection = [&scratch](std::size_t q, std::size_t vertex) {
+			const auto qf = static_cast<float>(q);
+			const auto vf = static_cast<float>(vertex);
+			return ((scratch[q] + qf * qf) - (scratch[vertex] + vf * vf)) / (2.0f * qf - 2.0f * vf);
+		};
+
+		std::size_t k = 0;
+		parabolaVertices[0] = 0;
+		parabolaBoundaries[0] = -Infinity;
+		parabolaBoundaries[1] = Infinity;
+		for (std::size_t q = 1; q < count; ++q)
+		{
+			auto boundary = intersection(q, parabolaVertices[k]);
+			while (boundary <= parabolaBoundaries[k])
+			{
+				--k;
+				boundary = intersection(q, parabolaVertices[k]);
+			}
+			++k;
+			parabolaVertices[k] = q;
+			parabolaBoundaries[k] = boundary;
+			parabolaBoundaries[k + 1] = Infinity;
+		}
+
+		k = 0;
+		for (std::size_t q = 0; q < count; ++q)
+		{
+			while (parabolaBoundaries[k + 1] < static_cast<float>(q))
+			{
+				++k;
+			}
+			const auto offset = static_cast<float>(q) - static_cast<float>(parabolaVertices[k]);
+			distances[q * stride] = offset * offset + scratch[parabolaVertices[k]];
+		}
+	}
+}
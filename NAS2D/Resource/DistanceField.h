@@ -0,0 +1,21 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Math/Vector.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace NAS2D
+{
+	std::vector<std::uint8_t> distanceField(const std::vector<std::uint8_t>& coverage, Vector<int> size, int spread);
+} // namespace NAS2D
@@ -0,0 +1,82 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "DynamicImage.h"
+
+#include "../Math/Rectangle.h"
+
+#include <SDL2/SDL.h>
+
+#include <stdexcept>
+#include <string>
+
+
+using namespace NAS2D;
+
+
+SDL_Surface* DynamicImage::createSurface(Vector<int> size)
+{
+	auto surface = SDL_CreateRGBSurfaceWithFormat(0, size.x, size.y, 32, SDL_PIXELFORMAT_RGBA32);
+	if (!surface)
+	{
+		throw std::runtime_error("DynamicImage failed to create surface: " + std::string{SDL_GetError()});
+	}
+	return surface;
+}
+
+
+/**
+ * Creates a DynamicImage with all pixels set to transparent black.
+ *
+ * \param	size	Size of the Image in pixels.
+ * \param	filter	Texture sampling mode used when the Image is drawn.
+ */
+DynamicImage::DynamicImage(Vector<int> size, TextureFilter filter) :
+	Image{*createSurface(size), filter}
+{
+}
+
+
+/**
+ * Replaces all pixels of the Image.
+ *
+ * \param	pixels	Tightly packed pixel data the size of the Image.
+ */
+void DynamicImage::update(const void* pixels)
+{
+	update({{0, 0}, size()}, pixels);
+}
+
+
+/**
+ * Replaces a region of the Image.
+ *
+ * \param	region	Area of the Image to replace.
+ * \param	pixels	Tightly packed pixel data the size of the region.
+ */
+void DynamicImage::update(const Rectangle<int>& region, const void* pixels)
+{
+	update(region, pixels, region.size.x * 4);
+}
+
+
+/**
+ * Replaces a region of the Image from a larger pixel buffer.
+ *
+ * Only the region is uploaded to the texture, so the cost of an update is
+ * proportional to the area that changed.
+ *
+ * \param	region	Area of the Image to replace.
+ * \param	pixels	Pointer to the first pixel of the region in the source buffer.
+ * \param	pitch	Length in bytes of a row of the source buffer.
+ */
+void DynamicImage::update(const Rectangle<int>& region, const void* pixels, int pitch)
+{
+	updatePixels(region, pixels, pitch);
+}
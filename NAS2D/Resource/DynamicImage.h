@@ -0,0 +1,39 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Image.h"
+
+
+namespace NAS2D
+{
+	/**
+	 * An Image whose pixels can be changed after it has been created.
+	 *
+	 * Intended for images generated at runtime and changed often, such as
+	 * minimaps and fog of war overlays. The Image keeps a single texture,
+	 * and updates only upload the changed region to it, instead of creating
+	 * a new surface and texture for each change.
+	 *
+	 * Pixel data is 32-bit RGBA, with the bytes in R, G, B, A order in memory.
+	 */
+	class DynamicImage : public Image
+	{
+	public:
+		explicit DynamicImage(Vector<int> size, TextureFilter filter = TextureFilter::Linear);
+
+		void update(const void* pixels);
+		void update(const Rectangle<int>& region, const void* pixels);
+		void update(const Rectangle<int>& region, const void* pixels, int pitch);
+
+	protected:
+		static SDL_Surface* createSurface(Vector<int> size);
+	};
+} // namespace
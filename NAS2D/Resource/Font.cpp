@@ -8,11 +8,20 @@
 // = Acknowledgment of your use of NAS2D is appreciated but is not required.
 // ==================================================================================
 #include "Font.h"
+#include "BakedFont.h"
+#include "BitmapGlyphColumns.h"
+#include "DistanceField.h"
+#include "GlyphCache.h"
+#include "Image.h"
+#include "TextureManager.h"
 
 #include "../Filesystem.h"
 #include "../Utility.h"
+#include "../Utf8Range.h"
+#include "../WorkerPool.h"
 #include "../Math/MathUtils.h"
 #include "../Math/PointInRectangleRange.h"
+#include "../Math/ShelfPacker.h"
 
 #if defined(__XCODE_BUILD__)
 #include <GLEW/GLEW.h>
@@ -27,11 +36,19 @@
 #include <cmath>
 #include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 
 extern unsigned int generateTexture(SDL_Surface* surface);
+extern unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height, NAS2D::TextureFilter filter);
+extern NAS2D::Rectangle<int> opaqueBounds(SDL_Surface* surface, const NAS2D::Rectangle<int>& region);
+extern std::vector<uint8_t> alphaChannel(SDL_Surface* surface, const NAS2D::Rectangle<int>& region);
 
 
 using namespace NAS2D;
@@ -39,41 +56,50 @@ using namespace NAS2D;
 
 namespace
 {
-	struct ColorMasks
-	{
-		unsigned int red;
-		unsigned int green;
-		unsigned int blue;
-		unsigned int alpha;
-	};
-
-	constexpr ColorMasks MasksLittleEndian{0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000};
-	constexpr ColorMasks MasksBigEndian{0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff};
-	constexpr ColorMasks MasksDefault = (SDL_BYTEORDER == SDL_LIL_ENDIAN) ? MasksLittleEndian : MasksBigEndian;
-
+	const char32_t REPLACEMENT_CHARACTER = '?';
 	const int ASCII_TABLE_COUNT = 256;
+	const char32_t FIRST_PRINTABLE_CHARACTER = ' ';
 	const int GLYPH_MATRIX_SIZE = 16;
-	const int BITS_32 = 32;
+	const int GLYPH_PADDING = 1;
+	const int BITMAP_GLYPH_SPACING = 1;
+	const unsigned int MAX_RASTERIZER_THREADS = 4;
 
-	Font::FontInfo load(const std::string& path, unsigned int ptSize);
-	Font::FontInfo loadBitmap(const std::string& path);
+	struct RasterizedGlyph
+	{
+		std::vector<uint8_t> alpha{};
+		Vector<int> size{0, 0};
+		Point<int> origin{}; /**< Position of the alpha values relative to the glyph as rendered by SDL_ttf. */
+	};
+
+	void initTtf();
+	Font::FontInfo load(const std::string& path, unsigned int ptSize, FontRenderMode renderMode);
+	Font::FontInfo loadBaked(const BakedFont& bakedFont, std::unique_ptr<GlyphCache> glyphCache);
+	Font::FontInfo loadBitmap(const std::string& path, BitmapFontSpacing spacing);
 	unsigned int generateFontTexture(SDL_Surface* fontSurface, std::vector<Font::GlyphMetrics>& glyphMetricsList);
-	SDL_Surface* generateFontSurface(TTF_Font* font, Vector<int> characterSize);
-	Vector<int> maxCharacterDimensions(TTF_Font* font);
-	Vector<int> roundedCharacterDimensions(Vector<int> maxSize);
-	void fillInCharacterDimensions(TTF_Font* font, std::vector<Font::GlyphMetrics>& glyphMetricsList);
-	void fillInTextureCoordinates(std::vector<Font::GlyphMetrics>& glyphMetricsList);
+	unsigned int generateAtlasTexture(const std::vector<uint8_t>& atlas, Vector<int> atlasSize);
+	BakedFont bakeFont(const GlyphCache& glyphCache, unsigned int ptSize, FontRenderMode renderMode);
+	void packGlyphs(const std::vector<RasterizedGlyph>& rasterizedGlyphs, BakedFont& bakedFont);
+	std::vector<RasterizedGlyph> rasterizeGlyphs(const GlyphCache& glyphCache, std::vector<BakedFont::Glyph>& glyphs, std::vector<KerningPair>& kerningPairs);
+	void rasterizeGlyphRange(TTF_Font* font, int distanceFieldSpread, std::size_t firstGlyph, std::size_t glyphStride, std::vector<BakedFont::Glyph>& glyphs, std::vector<RasterizedGlyph>& rasterizedGlyphs, std::vector<KerningPair>& kerningPairs);
+	void findKerningPairs(TTF_Font* font, char32_t previous, std::vector<KerningPair>& kerningPairs);
+	Vector<int> maxCharacterDimensions(const std::vector<Font::GlyphMetrics>& glyphMetricsList, int height);
+	void fillInBitmapGlyphMetrics(SDL_Surface* fontSurface, Vector<int> glyphSize, BitmapFontSpacing spacing, std::vector<Font::GlyphMetrics>& glyphMetricsList);
 }
 
 
 /**
- * Instantiate a Font using a TrueType or OpenType font.
+ * Instantiate a Font using a TrueType or OpenType font, or a baked font file.
+ *
+ * Baked font files, see Font::bake, load without rasterizing glyphs. They
+ * must contain the requested point size, baked with the requested render
+ * mode.
  *
  * \param	filePath	Path to a font file.
  * \param	ptSize		Point size of the font. Defaults to 12pt.
+ * \param	renderMode	Whether glyphs are stored as coverage or distance fields.
  */
-Font::Font(const std::string& filePath, unsigned int ptSize) :
-	mFontInfo{load(filePath, ptSize)}
+Font::Font(const std::string& filePath, unsigned int ptSize, FontRenderMode renderMode) :
+	mFontInfo{load(filePath, ptSize, renderMode)}
 {
 }
 
@@ -82,16 +108,52 @@ Font::Font(const std::string& filePath, unsigned int ptSize) :
  * Instantiate a Font as a bitmap font.
  *
  * \param	filePath	Path to a font file.
+ * \param	spacing		Whether glyphs are monospaced or proportional. Defaults to monospaced.
+ */
+Font::Font(const std::string& filePath, BitmapFontSpacing spacing) :
+	mFontInfo{loadBitmap(filePath, spacing)}
+{
+}
+
+
+/**
+ * Rasterizes the glyph atlas and metrics of a TrueType or OpenType font.
+ *
+ * Used to create baked font files with writeBakedFontFile, which load
+ * faster than the original font. Does not require a Renderer.
+ *
+ * \param	fontData	Contents of a TrueType or OpenType font file.
+ * \param	ptSize		Point size to bake the font at.
+ * \param	renderMode	Whether glyphs are stored as coverage or distance fields.
  */
-Font::Font(const std::string& filePath) :
-	mFontInfo{loadBitmap(filePath)}
+BakedFont Font::bake(std::string fontData, unsigned int ptSize, FontRenderMode renderMode)
+{
+	initTtf();
+	const GlyphCache glyphCache{std::move(fontData), ptSize, renderMode};
+	return bakeFont(glyphCache, ptSize, renderMode);
+}
+
+
+/**
+ * Instantiate a Font from already loaded glyph metrics.
+ *
+ * The Font takes ownership of the texture. A Font without a texture can
+ * still be used to measure and lay out text, which lets derived classes
+ * build fonts for tests without loading a file.
+ */
+Font::Font(FontInfo fontInfo) :
+	mFontInfo{std::move(fontInfo)}
 {
 }
 
 
 Font::~Font()
 {
-	glDeleteTextures(1, &mFontInfo.textureId);
+	if (mFontInfo.textureId != 0)
+	{
+		Utility<TextureManager>::get().remove(mFontInfo.textureId);
+		glDeleteTextures(1, &mFontInfo.textureId);
+	}
 }
 
 
@@ -110,6 +172,9 @@ Vector<int> Font::size(std::string_view string) const
 /**
  * Gets the width in pixels of a string rendered using the Font.
  *
+ * The width is the distance the pen moves, the sum of the advance and
+ * kerning of each character, as in drawText and TextLayout.
+ *
  * \param	string		String to get the width of.
  */
 int Font::width(std::string_view string) const
@@ -120,16 +185,33 @@ int Font::width(std::string_view string) const
 	auto& gml = mFontInfo.metrics;
 	if (gml.empty()) { return 0; }
 
-	for (auto character : string)
+	char32_t previous = 0;
+	for (const auto codepoint : Utf8Range{string})
 	{
-		auto glyph = std::clamp<std::size_t>(static_cast<uint8_t>(character), 0, 255);
-		width += gml[glyph].advance + gml[glyph].minX;
+		const auto& metrics = glyph(codepoint);
+		width += metrics.advance + kerning(previous, codepoint);
+		previous = codepoint;
 	}
 
 	return width;
 }
 
 
+/**
+ * Gets the width in pixels of a string drawn with a scale factor.
+ *
+ * Matches Renderer::drawText with the same scale, which moves the pen by
+ * the scaled advance and kerning of each character.
+ *
+ * \param	string	String to get the width of.
+ * \param	scale	Scale factor the string is drawn with.
+ */
+float Font::width(std::string_view string, float scale) const
+{
+	return static_cast<float>(width(string)) * scale;
+}
+
+
 /**
  * Gets the height in pixels of the Font.
  */
@@ -157,12 +239,106 @@ unsigned int Font::ptSize() const
 }
 
 
+/**
+ * How the glyphs of the Font are stored in its texture.
+ *
+ * Renderers use this to select how glyphs are drawn.
+ */
+FontRenderMode Font::renderMode() const
+{
+	return mFontInfo.renderMode;
+}
+
+
 const std::vector<Font::GlyphMetrics>& Font::metrics() const
 {
 	return mFontInfo.metrics;
 }
 
 
+/**
+ * Starts a batch of glyphs that are drawn together.
+ *
+ * Glyphs outside of the preloaded range looked up after this are not
+ * evicted from the glyph cache until the next batch starts, so all glyph
+ * quads of a draw call can be queued before drawing them.
+ */
+void Font::beginGlyphBatch() const
+{
+	if (mFontInfo.glyphCache)
+	{
+		mFontInfo.glyphCache->beginBatch();
+	}
+}
+
+
+/**
+ * Gets the metrics of the glyph for a character.
+ *
+ * Glyphs outside of the preloaded range are rasterized on first use. If the
+ * Font has no glyph for the character, or the glyph does not fit in the
+ * glyph cache with the rest of the current batch, the metrics of '?' are
+ * returned.
+ *
+ * \note	The returned reference is only valid until the next batch starts,
+ *			see beginGlyphBatch, as the glyph may be evicted afterwards.
+ */
+const Font::GlyphMetrics& Font::glyph(char32_t codepoint) const
+{
+	const auto& glyphMetricsList = mFontInfo.metrics;
+	if (codepoint < glyphMetricsList.size())
+	{
+		return glyphMetricsList[codepoint];
+	}
+
+	if (mFontInfo.glyphCache)
+	{
+		if (const auto* metrics = mFontInfo.glyphCache->glyph(codepoint))
+		{
+			return *metrics;
+		}
+	}
+
+	return glyphMetricsList[REPLACEMENT_CHARACTER];
+}
+
+
+/**
+ * Gets the horizontal adjustment in pixels between two adjacent characters.
+ *
+ * Added to the pen position after the advance of the previous character.
+ * Kerning of the first 256 characters is looked up in a table built when
+ * the Font is loaded, and other pairs are cached after their first use, so
+ * it is cheap enough to use for every character drawn.
+ *
+ * \param	previous	Character before the current one, or 0 at the start of a line.
+ * \param	current		Character being placed.
+ */
+int Font::kerning(char32_t previous, char32_t current) const
+{
+	if (!mFontInfo.glyphCache || previous == 0)
+	{
+		return 0;
+	}
+	return mFontInfo.glyphCache->kerning(previous, current);
+}
+
+
+/**
+ * Generation of a glyph cache page, which changes every time glyphs on it are evicted.
+ *
+ * Glyph metrics on a page kept from before a change may refer to texture
+ * areas now used by other glyphs. Textures of preloaded glyphs are never
+ * evicted, and always have generation 0.
+ *
+ * \param	textureId	Texture of the glyphs, from GlyphMetrics::textureId.
+ */
+std::size_t Font::glyphPageGeneration(unsigned int textureId) const
+{
+	return mFontInfo.glyphCache ? mFontInfo.glyphCache->pageGeneration(textureId) : 0;
+}
+
+
 unsigned int Font::textureId() const
 {
 	return mFontInfo.textureId;
@@ -171,13 +347,7 @@ unsigned int Font::textureId() const
 
 namespace
 {
-	/**
-	 * Loads a TrueType or OpenType font from a file.
-	 *
-	 * \param	path	Path to the TTF or OTF font file.
-	 * \param	ptSize	Point size to use when loading the font.
-	 */
-	Font::FontInfo load(const std::string& path, unsigned int ptSize)
+	void initTtf()
 	{
 		if (TTF_WasInit() == 0)
 		{
@@ -186,6 +356,20 @@ namespace
 				throw std::runtime_error("Font load function failed: " + std::string{TTF_GetError()});
 			}
 		}
+	}
+
+
+	/**
+	 * Loads a TrueType or OpenType font, or a baked font, from a file.
+	 *
+	 * \param	path		Path to the TTF, OTF or baked font file.
+	 * \param	ptSize		Point size to use when loading the font.
+	 * \param	renderMode	Whether glyphs are stored as coverage or distance fields.
+	 *						Baked fonts must have been baked with the same render mode.
+	 */
+	Font::FontInfo load(const std::string& path, unsigned int ptSize, FontRenderMode renderMode)
+	{
+		initTtf();
 
 		auto fontBuffer = Utility<Filesystem>::get().readFile(path);
 		if (fontBuffer.empty())
@@ -193,26 +377,64 @@ namespace
 			throw std::runtime_error("Font file is empty: " + path);
 		}
 
-		auto* font = TTF_OpenFontRW(SDL_RWFromConstMem(fontBuffer.c_str(), static_cast<int>(fontBuffer.size())), 1, static_cast<int>(ptSize));
-		if (!font)
+		if (isBakedFontFile(fontBuffer))
+		{
+			const auto bakedFont = readBakedFont(fontBuffer, ptSize);
+			if (bakedFont.renderMode != renderMode)
+			{
+				throw std::runtime_error("Baked font was baked with a different render mode than requested: " + path);
+			}
+			auto glyphCache = std::make_unique<GlyphCache>(std::string{readBakedFontData(fontBuffer)}, ptSize, bakedFont.renderMode);
+			return loadBaked(bakedFont, std::move(glyphCache));
+		}
+
+		// Font is kept open by the glyph cache for rasterizing further glyphs on demand
+		auto glyphCache = std::make_unique<GlyphCache>(std::move(fontBuffer), ptSize, renderMode);
+		const auto bakedFont = bakeFont(*glyphCache, ptSize, renderMode);
+		return loadBaked(bakedFont, std::move(glyphCache));
+	}
+
+
+	/**
+	 * Uploads the atlas of a baked font and fills in glyph metrics.
+	 *
+	 * \param	bakedFont	Atlas and metrics of the glyphs 0 - 255.
+	 * \param	glyphCache	Glyph cache of the same font, point size and render mode.
+	 */
+	Font::FontInfo loadBaked(const BakedFont& bakedFont, std::unique_ptr<GlyphCache> glyphCache)
+	{
+		if (bakedFont.glyphs.size() != ASCII_TABLE_COUNT)
 		{
-			throw std::runtime_error("Font load function failed: " + std::string{TTF_GetError()});
+			throw std::runtime_error("Baked font must have " + std::to_string(ASCII_TABLE_COUNT) + " glyphs: " + std::to_string(bakedFont.glyphs.size()));
 		}
 
 		Font::FontInfo fontInfo;
+		fontInfo.pointSize = bakedFont.pointSize;
+		fontInfo.height = bakedFont.height;
+		fontInfo.ascent = bakedFont.ascent;
+		fontInfo.renderMode = bakedFont.renderMode;
+		fontInfo.textureId = generateAtlasTexture(bakedFont.atlas, bakedFont.atlasSize);
+
 		auto& glm = fontInfo.metrics;
-		fillInCharacterDimensions(font, glm);
-		const auto charBoundsSize = maxCharacterDimensions(font);
-		const auto roundedCharSize = roundedCharacterDimensions(charBoundsSize);
-		SDL_Surface* fontSurface = generateFontSurface(font, roundedCharSize);
-
-		fontInfo.pointSize = ptSize;
-		fontInfo.height = TTF_FontHeight(font);
-		fontInfo.ascent = TTF_FontAscent(font);
-		fontInfo.glyphSize = roundedCharSize;
-		fontInfo.textureId = generateFontTexture(fontSurface, glm);
-		SDL_FreeSurface(fontSurface);
-		TTF_CloseFont(font);
+		glm.resize(ASCII_TABLE_COUNT);
+		for (std::size_t glyph = 0; glyph < ASCII_TABLE_COUNT; ++glyph)
+		{
+			const auto& bakedGlyph = bakedFont.glyphs[glyph];
+			auto& metrics = glm[glyph];
+			metrics.minX = bakedGlyph.minX;
+			metrics.minY = bakedGlyph.minY;
+			metrics.maxX = bakedGlyph.maxX;
+			metrics.maxY = bakedGlyph.maxY;
+			metrics.advance = bakedGlyph.advance;
+			metrics.textureId = fontInfo.textureId;
+			metrics.size = bakedGlyph.size;
+			metrics.offset = bakedGlyph.offset;
+			metrics.uvRect = Rectangle{bakedGlyph.position, bakedGlyph.size}.to<float>().skewInverseBy(bakedFont.atlasSize.to<float>());
+		}
+		fontInfo.glyphSize = maxCharacterDimensions(glm, fontInfo.height);
+
+		glyphCache->preloadKerning(ASCII_TABLE_COUNT, bakedFont.kerningPairs);
+		fontInfo.glyphCache = std::move(glyphCache);
 
 		return fontInfo;
 	}
@@ -222,8 +444,9 @@ namespace
 	 * Internal function that loads a bitmap font from an file.
 	 *
 	 * \param	path		Path to the image file.
+	 * \param	spacing		Whether glyphs are monospaced or proportional.
 	 */
-	Font::FontInfo loadBitmap(const std::string& path)
+	Font::FontInfo loadBitmap(const std::string& path, BitmapFontSpacing spacing)
 	{
 		auto fontBuffer = Utility<Filesystem>::get().readFile(path);
 		if (fontBuffer.empty())
@@ -250,14 +473,7 @@ namespace
 		Font::FontInfo fontInfo;
 		auto& glm = fontInfo.metrics;
 		glm.resize(ASCII_TABLE_COUNT);
-		for (auto& metrics : glm)
-		{
-			metrics.minX = 0;
-			metrics.minY = 0;
-			metrics.maxX = glyphSize.x;
-			metrics.maxY = glyphSize.y;
-			metrics.advance = glyphSize.x;
-		}
+		fillInBitmapGlyphMetrics(fontSurface, glyphSize, spacing, glm);
 
 		fontInfo.pointSize = static_cast<unsigned int>(glyphSize.y);
 		fontInfo.height = glyphSize.y;
@@ -271,85 +487,294 @@ namespace
 
 
 	/**
-	 * Generates a glyph map of all ASCII standard characters from 0 - 255.
+	 * Uploads a glyph map and assigns its texture to the glyphs.
 	 *
-	 * Internal function used to generate a glyph texture map from an TTF_Font struct.
+	 * \note	The glyph surface is not retained, so the texture is pinned in the TextureManager.
 	 */
 	unsigned int generateFontTexture(SDL_Surface* fontSurface, std::vector<Font::GlyphMetrics>& glyphMetricsList)
 	{
-		fillInTextureCoordinates(glyphMetricsList);
-		return generateTexture(fontSurface);
+		const auto textureId = generateTexture(fontSurface);
+		const auto byteSize = Vector{fontSurface->w, fontSurface->h}.to<std::size_t>();
+		Utility<TextureManager>::get().add(textureId, byteSize.x * byteSize.y * 4u);
+
+		for (auto& metrics : glyphMetricsList)
+		{
+			metrics.textureId = textureId;
+		}
+		return textureId;
 	}
 
 
-	SDL_Surface* generateFontSurface(TTF_Font* font, Vector<int> characterSize)
+	/**
+	 * Uploads an atlas of alpha values as white pixels.
+	 *
+	 * \note	The atlas is not retained, so the texture is pinned in the TextureManager.
+	 */
+	unsigned int generateAtlasTexture(const std::vector<uint8_t>& atlas, Vector<int> atlasSize)
 	{
-		const auto matrixSize = characterSize * GLYPH_MATRIX_SIZE;
-		SDL_Surface* fontSurface = SDL_CreateRGBSurface(SDL_SWSURFACE, matrixSize.x, matrixSize.y, BITS_32, MasksDefault.red, MasksDefault.green, MasksDefault.blue, MasksDefault.alpha);
+		const auto byteSize = atlasSize.to<std::size_t>();
+		if (atlas.size() != byteSize.x * byteSize.y)
+		{
+			throw std::runtime_error("Font atlas size does not match its dimensions");
+		}
 
-		SDL_Color white = {255, 255, 255, 255};
-		for (const auto glyphPosition : PointInRectangleRange(Rectangle<std::size_t>{{0, 0}, {GLYPH_MATRIX_SIZE, GLYPH_MATRIX_SIZE}}))
+		auto& textureManager = Utility<TextureManager>::get();
+		const auto premultiplied = textureManager.premultipliedAlpha();
+		std::vector<uint8_t> pixels(atlas.size() * 4u);
+		auto* destination = pixels.data();
+		for (const auto alpha : atlas)
 		{
-			const std::size_t glyph = glyphPosition.y * GLYPH_MATRIX_SIZE + glyphPosition.x;
+			const auto color = premultiplied ? alpha : uint8_t{255};
+			*destination++ = color;
+			*destination++ = color;
+			*destination++ = color;
+			*destination++ = alpha;
+		}
 
-			SDL_Surface* characterSurface = TTF_RenderGlyph_Blended(font, static_cast<uint16_t>(glyph), white);
-			// A character surface can fail to be created for glyphs of size 0
-			if (characterSurface)
+		const auto textureId = generateTexture(pixels.data(), 4, atlasSize.x, atlasSize.y, TextureFilter::Linear);
+		textureManager.add(textureId, pixels.size());
+		return textureId;
+	}
+
+
+	/**
+	 * Rasterizes the glyphs 0 - 255 into an atlas and reads their metrics and kerning.
+	 *
+	 * Does not use OpenGL, so fonts can be baked by tools without a window.
+	 */
+	BakedFont bakeFont(const GlyphCache& glyphCache, unsigned int ptSize, FontRenderMode renderMode)
+	{
+		auto* font = glyphCache.font();
+
+		BakedFont bakedFont;
+		bakedFont.pointSize = ptSize;
+		bakedFont.renderMode = renderMode;
+		bakedFont.height = TTF_FontHeight(font);
+		bakedFont.ascent = TTF_FontAscent(font);
+
+		const auto rasterizedGlyphs = rasterizeGlyphs(glyphCache, bakedFont.glyphs, bakedFont.kerningPairs);
+		packGlyphs(rasterizedGlyphs, bakedFont);
+		return bakedFont;
+	}
+
+
+	/**
+	 * Packs rasterized glyphs into the atlas of a baked font.
+	 *
+	 * Glyphs are cropped to the bounds of their visible pixels and packed
+	 * tallest first onto shelves, rather than each taking a cell the size of
+	 * the largest glyph. Atlas positions, sizes and drawing offsets of the
+	 * cropped glyphs are filled in.
+	 */
+	void packGlyphs(const std::vector<RasterizedGlyph>& rasterizedGlyphs, BakedFont& bakedFont)
+	{
+		int packedArea = 0;
+		int maxPackedWidth = 0;
+		for (const auto& rasterizedGlyph : rasterizedGlyphs)
+		{
+			const auto paddedSize = rasterizedGlyph.size + Vector{GLYPH_PADDING, GLYPH_PADDING};
+			packedArea += paddedSize.x * paddedSize.y;
+			maxPackedWidth = std::max(maxPackedWidth, paddedSize.x);
+		}
+
+		std::vector<std::size_t> packOrder(ASCII_TABLE_COUNT);
+		std::iota(packOrder.begin(), packOrder.end(), std::size_t{0});
+		std::stable_sort(packOrder.begin(), packOrder.end(), [&rasterizedGlyphs](std::size_t a, std::size_t b) { return rasterizedGlyphs[a].size.y > rasterizedGlyphs[b].size.y; });
+
+		const auto squareLength = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(packedArea))));
+		const auto atlasWidth = static_cast<int>(roundUpPowerOf2(static_cast<uint32_t>(std::max({squareLength, maxPackedWidth, 1}))));
+		auto packer = ShelfPacker{{atlasWidth, std::numeric_limits<int>::max() / 2}, GLYPH_PADDING};
+		for (const auto glyph : packOrder)
+		{
+			const auto& rasterizedGlyph = rasterizedGlyphs[glyph];
+			if (rasterizedGlyph.size.x > 0 && rasterizedGlyph.size.y > 0)
 			{
-				SDL_SetSurfaceBlendMode(characterSurface, SDL_BLENDMODE_NONE);
-				const auto pixelPosition = glyphPosition.to<int>().skewBy(characterSize);
-				SDL_Rect rect = {pixelPosition.x, pixelPosition.y, 0, 0};
-				SDL_BlitSurface(characterSurface, nullptr, fontSurface, &rect);
-				SDL_FreeSurface(characterSurface);
+				auto& bakedGlyph = bakedFont.glyphs[glyph];
+				bakedGlyph.position = *packer.insert(rasterizedGlyph.size);
+				bakedGlyph.size = rasterizedGlyph.size;
+				bakedGlyph.offset = {std::min(bakedGlyph.minX, 0) + rasterizedGlyph.origin.x, rasterizedGlyph.origin.y};
 			}
 		}
 
-		return fontSurface;
+		bakedFont.atlasSize = {atlasWidth, std::max(packer.usedHeight(), 1)};
+		const auto atlasStride = static_cast<std::size_t>(atlasWidth);
+		bakedFont.atlas.assign(atlasStride * static_cast<std::size_t>(bakedFont.atlasSize.y), 0);
+
+		for (std::size_t glyph = 0; glyph < ASCII_TABLE_COUNT; ++glyph)
+		{
+			const auto& rasterizedGlyph = rasterizedGlyphs[glyph];
+			const auto position = bakedFont.glyphs[glyph].position.to<std::size_t>();
+			const auto size = rasterizedGlyph.size.to<std::size_t>();
+			for (std::size_t y = 0; y < size.y; ++y)
+			{
+				const auto source = rasterizedGlyph.alpha.begin() + static_cast<std::ptrdiff_t>(y * size.x);
+				std::copy(source, source + static_cast<std::ptrdiff_t>(size.x), bakedFont.atlas.begin() + static_cast<std::ptrdiff_t>((position.y + y) * atlasStride + position.x));
+			}
+		}
 	}
 
 
-	Vector<int> maxCharacterDimensions(TTF_Font* font)
+	/**
+	 * Renders glyphs 0 - 255 and reads their metrics, spread over several threads.
+	 *
+	 * Each thread uses its own handle to the font, as a handle can not be used
+	 * by two threads at once. Glyphs are assigned to threads in an interleaved
+	 * order, so the empty control characters at the start of the table don't
+	 * all fall on the same thread. Distance fields are computed on the same
+	 * threads, as they take much longer than rendering the glyphs. So are
+	 * the kerning pairs of the glyphs.
+	 */
+	std::vector<RasterizedGlyph> rasterizeGlyphs(const GlyphCache& glyphCache, std::vector<BakedFont::Glyph>& glyphs, std::vector<KerningPair>& kerningPairs)
 	{
-		Vector<int> size{0, 0};
+		glyphs.resize(ASCII_TABLE_COUNT);
+		std::vector<RasterizedGlyph> rasterizedGlyphs(ASCII_TABLE_COUNT);
+
+		const auto threadCount = WorkerPool::defaultSize(MAX_RASTERIZER_THREADS);
+		std::vector<TTF_Font*> threadFonts{glyphCache.font()};
+		for (auto i = 1u; i < threadCount; ++i)
+		{
+			auto* font = glyphCache.openFont();
+			if (!font)
+			{
+				break;
+			}
+			threadFonts.push_back(font);
+		}
+
+		const auto glyphStride = threadFonts.size();
+		std::vector<std::vector<KerningPair>> threadKerningPairs(glyphStride);
+		const auto closeThreadFonts = [&threadFonts]() {
+			std::for_each(threadFonts.begin() + 1, threadFonts.end(), TTF_CloseFont);
+		};
+		try
+		{
+			WorkerPool workers{static_cast<unsigned int>(glyphStride)};
+			workers.run([&](unsigned int worker) {
+				rasterizeGlyphRange(threadFonts[worker], glyphCache.distanceFieldSpread(), worker, glyphStride, glyphs, rasterizedGlyphs, threadKerningPairs[worker]);
+			});
+		}
+		catch (...)
+		{
+			closeThreadFonts();
+			throw;
+		}
+		closeThreadFonts();
 
-		for (int i = 0; i < 256; ++i)
+		for (const auto& pairs : threadKerningPairs)
 		{
-			Vector<int> sizeChar;
-			char text[2] = {static_cast<char>(i), 0};
-			TTF_SizeText(font, text, &sizeChar.x, &sizeChar.y);
-			size = {std::max({size.x, sizeChar.x}), std::max({size.y, sizeChar.y})};
+			kerningPairs.insert(kerningPairs.end(), pairs.begin(), pairs.end());
 		}
-		return size;
+
+		return rasterizedGlyphs;
 	}
 
 
-	Vector<int> roundedCharacterDimensions(Vector<int> maxSize)
+	void rasterizeGlyphRange(TTF_Font* font, int distanceFieldSpread, std::size_t firstGlyph, std::size_t glyphStride, std::vector<BakedFont::Glyph>& glyphs, std::vector<RasterizedGlyph>& rasterizedGlyphs, std::vector<KerningPair>& kerningPairs)
 	{
-		const auto maxSizeUint32 = maxSize.to<uint32_t>();
-		const auto roundedUpSize = Vector{roundUpPowerOf2(maxSizeUint32.x), roundUpPowerOf2(maxSizeUint32.y)};
-		return roundedUpSize.to<int>();
+		const SDL_Color white = {255, 255, 255, 255};
+		const auto hasKerning = TTF_GetFontKerning(font) != 0;
+		for (auto glyph = firstGlyph; glyph < rasterizedGlyphs.size(); glyph += glyphStride)
+		{
+			if (hasKerning)
+			{
+				findKerningPairs(font, static_cast<char32_t>(glyph), kerningPairs);
+			}
+
+			auto& metrics = glyphs[glyph];
+			const auto character = static_cast<uint16_t>(glyph);
+			TTF_GlyphMetrics(font, character, &metrics.minX, &metrics.maxX, &metrics.minY, &metrics.maxY, &metrics.advance);
+
+			SDL_Surface* characterSurface = TTF_RenderGlyph_Blended(font, character, white);
+			// A character surface can fail to be created for glyphs of size 0
+			if (!characterSurface)
+			{
+				continue;
+			}
+
+			const auto bounds = opaqueBounds(characterSurface, {{0, 0}, {characterSurface->w, characterSurface->h}});
+			auto& rasterizedGlyph = rasterizedGlyphs[glyph];
+			if (!bounds.empty())
+			{
+				rasterizedGlyph = {alphaChannel(characterSurface, bounds), bounds.size, bounds.position};
+				if (distanceFieldSpread > 0)
+				{
+					const auto spread = Vector{distanceFieldSpread, distanceFieldSpread};
+					rasterizedGlyph = {distanceField(rasterizedGlyph.alpha, bounds.size, distanceFieldSpread), bounds.size + spread * 2, bounds.position - spread};
+				}
+			}
+			SDL_FreeSurface(characterSurface);
+		}
 	}
 
 
-	void fillInCharacterDimensions(TTF_Font* font, std::vector<Font::GlyphMetrics>& glyphMetricsList)
+	/**
+	 * Adds the pairs of a printable character followed by each other printable character which have kerning.
+	 */
+	void findKerningPairs(TTF_Font* font, char32_t previous, std::vector<KerningPair>& kerningPairs)
 	{
-		// Build table of character sizes
-		for (Uint16 i = 0; i < ASCII_TABLE_COUNT; i++)
+		if (previous < FIRST_PRINTABLE_CHARACTER || TTF_GlyphIsProvided32(font, previous) == 0)
 		{
-			auto& metrics = glyphMetricsList.emplace_back();
-			TTF_GlyphMetrics(font, i, &metrics.minX, &metrics.maxX, &metrics.minY, &metrics.maxY, &metrics.advance);
+			return;
 		}
+
+		for (auto current = FIRST_PRINTABLE_CHARACTER; current < static_cast<char32_t>(ASCII_TABLE_COUNT); ++current)
+		{
+			const auto amount = TTF_GetFontKerningSizeGlyphs32(font, previous, current);
+			if (amount != 0)
+			{
+				kerningPairs.push_back({previous, current, amount});
+			}
+		}
+	}
+
+
+	/**
+	 * Size of a cell large enough to hold any glyph of the font.
+	 */
+	Vector<int> maxCharacterDimensions(const std::vector<Font::GlyphMetrics>& glyphMetricsList, int height)
+	{
+		const auto widest = std::max_element(glyphMetricsList.begin(), glyphMetricsList.end(), [](const auto& a, const auto& b) { return a.advance < b.advance; });
+		return {(widest != glyphMetricsList.end()) ? widest->advance : 0, height};
 	}
 
 
-	void fillInTextureCoordinates(std::vector<Font::GlyphMetrics>& glyphMetricsList)
+	/**
+	 * Sets the metrics of bitmap font glyphs.
+	 *
+	 * Monospaced glyphs cover their whole cell. Proportional glyphs are
+	 * trimmed to the columns their pixels cover and advance by their width
+	 * plus spacing. Empty cells, such as space, advance by half a cell.
+	 * Images without an alpha channel are always monospaced.
+	 */
+	void fillInBitmapGlyphMetrics(SDL_Surface* fontSurface, Vector<int> glyphSize, BitmapFontSpacing spacing, std::vector<Font::GlyphMetrics>& glyphMetricsList)
 	{
-		const auto uvSize = Vector<float>{1, 1} / 16.0f;
+		std::vector<std::pair<int, int>> glyphColumns(GLYPH_MATRIX_SIZE * GLYPH_MATRIX_SIZE, {0, glyphSize.x});
+		const auto* format = fontSurface->format;
+		if (spacing == BitmapFontSpacing::Proportional && format->BytesPerPixel == 4 && format->Amask != 0)
+		{
+			SDL_LockSurface(fontSurface);
+			glyphColumns = bitmapGlyphColumns(static_cast<const uint32_t*>(fontSurface->pixels), static_cast<std::size_t>(fontSurface->pitch) / 4u, glyphSize, format->Amask);
+			SDL_UnlockSurface(fontSurface);
+		}
+
+		const auto surfaceSize = Vector{fontSurface->w, fontSurface->h}.to<float>();
 		for (const auto glyphPosition : PointInRectangleRange(Rectangle<std::size_t>{{0, 0}, {GLYPH_MATRIX_SIZE, GLYPH_MATRIX_SIZE}}))
 		{
 			const std::size_t glyph = glyphPosition.y * GLYPH_MATRIX_SIZE + glyphPosition.x;
-			const auto uvStart = glyphPosition.to<float>().skewBy(uvSize);
-			glyphMetricsList[glyph].uvRect = Rectangle{uvStart, uvSize};
+			const auto [firstColumn, endColumn] = glyphColumns[glyph];
+			const auto width = endColumn - firstColumn;
+			const auto isFullWidth = width == glyphSize.x;
+
+			auto& metrics = glyphMetricsList[glyph];
+			metrics.minX = 0;
+			metrics.minY = 0;
+			metrics.maxX = width;
+			metrics.maxY = glyphSize.y;
+			metrics.advance = (width == 0) ? glyphSize.x / 2 : isFullWidth ? width : width + BITMAP_GLYPH_SPACING;
+			metrics.size = {width, glyphSize.y};
+
+			const auto cellStart = glyphPosition.to<int>().skewBy(glyphSize);
+			metrics.uvRect = Rectangle{cellStart + Vector{firstColumn, 0}, metrics.size}.to<float>().skewInverseBy(surfaceSize);
 		}
 	}
 }
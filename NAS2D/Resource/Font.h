@@ -12,6 +12,8 @@
 #include "../Math/Vector.h"
 #include "../Math/Rectangle.h"
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 #include <string_view>
@@ -19,18 +21,62 @@
 
 namespace NAS2D
 {
+	class GlyphCache;
+	struct BakedFont;
+
+
+	/**
+	 * How the glyphs of a TrueType or OpenType Font are stored in its texture.
+	 *
+	 * - Coverage: Anti-aliased glyphs at the point size of the Font. Best
+	 *   suited for text drawn at its natural size.
+	 * - DistanceField: Signed distance to the edge of each glyph. Text stays
+	 *   sharp when drawn scaled up or down, so one Font can serve many sizes.
+	 *   Works best with a large point size, such as 32pt or more.
+	 */
+	enum class FontRenderMode
+	{
+		Coverage,
+		DistanceField,
+	};
+
+
+	/**
+	 * How far apart the glyphs of a bitmap Font are drawn.
+	 *
+	 * - Monospaced: Every glyph advances by the width of its cell.
+	 * - Proportional: Glyphs are trimmed to the columns their alpha channel
+	 *   covers, and advance by their width plus one pixel of spacing. Suits
+	 *   glyph images drawn for proportional text, but changes how fonts drawn
+	 *   for a fixed grid look.
+	 */
+	enum class BitmapFontSpacing
+	{
+		Monospaced,
+		Proportional,
+	};
+
+
 	/**
 	 * Font resource.
 	 *
 	 * The Font class can be used to render TrueType, OpenType and Bitmap fonts. Two
 	 * contructors are provided for these types.
 	 *
-	 * TrueType and OpenType fonts generate their own glyph map internally. Only
-	 * the ASCII values 0 - 255 are used. Unicode/UTF is not supported.
+	 * Text is expected to be UTF-8 encoded. Bytes which are not part of a valid
+	 * UTF-8 sequence are treated as Latin-1 characters.
+	 *
+	 * TrueType and OpenType fonts generate their own glyph map internally for
+	 * the characters 0 - 255. Glyphs of other characters are rasterized into a
+	 * GlyphCache the first time they are used. They can optionally be rendered
+	 * as distance fields for drawing at any scale, see FontRenderMode. To skip
+	 * rasterizing at load, fonts can be baked ahead of time, see Font::bake.
 	 *
 	 * Bitmap fonts are expected to be in a 16x16 glyph matrix with the top left
 	 * glyph cell equating to ASCII value '0'. Glyph values increase from left to
-	 * right up to ASCII value 255.
+	 * right up to ASCII value 255. Other characters are drawn as '?'.
+	 * Bitmap fonts are monospaced unless proportional spacing is requested, see
+	 * BitmapFontSpacing. Images without an alpha channel are always monospaced.
 	 */
 	class Font
 	{
@@ -43,6 +89,9 @@ namespace NAS2D
 			int maxX{0};
 			int maxY{0};
 			int advance{0};
+			unsigned int textureId{0u};
+			Vector<int> size{0, 0}; /**< Size of the glyph's area of the texture. */
+			Vector<int> offset{0, 0}; /**< Position of the glyph's area relative to the pen position. */
 		};
 
 		/**
@@ -55,13 +104,17 @@ namespace NAS2D
 			unsigned int pointSize{0u};
 			int height{0};
 			int ascent{0};
+			FontRenderMode renderMode{FontRenderMode::Coverage};
 			Vector<int> glyphSize{};
 			std::vector<GlyphMetrics> metrics{};
+			std::unique_ptr<GlyphCache> glyphCache{};
 		};
 
 
-		Font(const std::string& filePath, unsigned int ptSize);
-		explicit Font(const std::string& filePath);
+		Font(const std::string& filePath, unsigned int ptSize, FontRenderMode renderMode = FontRenderMode::Coverage);
+		explicit Font(const std::string& filePath, BitmapFontSpacing spacing = BitmapFontSpacing::Monospaced);
+		static BakedFont bake(std::string fontData, unsigned int ptSize, FontRenderMode renderMode = FontRenderMode::Coverage);
+
 		Font(const Font& font) = delete;
 		Font& operator=(const Font& font) = delete;
 		~Font();
@@ -69,16 +122,25 @@ namespace NAS2D
 		Vector<int> glyphCellSize() const;
 		Vector<int> size(std::string_view string) const;
 		int width(std::string_view string) const;
+		float width(std::string_view string, float scale) const;
 		int height() const;
 		int ascent() const;
 		unsigned int ptSize() const;
+		FontRenderMode renderMode() const;
 		const std::vector<GlyphMetrics>& metrics() const;
+		void beginGlyphBatch() const;
+		const GlyphMetrics& glyph(char32_t codepoint) const;
+		int kerning(char32_t previous, char32_t current) const;
+		std::size_t glyphPageGeneration(unsigned int textureId) const;
 
 		// Temporary method, that will be removed in a future refactor
 		// Intended only to be used by RendererOpenGL
 		// As it is so specific, it should not be part of the Font class, nor FontInfo
 		unsigned int textureId() const;
 
+	protected:
+		explicit Font(FontInfo fontInfo);
+
 	private:
 		FontInfo mFontInfo;
 	};
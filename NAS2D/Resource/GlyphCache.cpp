@@ -0,0 +1,543 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "GlyphCache.h"
+#include "DistanceField.h"
+#include "TextureManager.h"
+
+#include "../Math/MathUtils.h"
+#include "../Math/Rectangle.h"
+#include "../Utility.h"
+
+#if defined(__XCODE_BUILD__)
+#include <GLEW/GLEW.h>
+#include <SDL2_ttf/SDL_ttf.h>
+#else
+#include <GL/glew.h>
+#include <SDL2/SDL_ttf.h>
+#endif
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+extern Rectangle<int> opaqueBounds(SDL_Surface* surface, const Rectangle<int>& region);
+extern std::vector<uint8_t> alphaChannel(SDL_Surface* surface, const Rectangle<int>& region);
+
+
+namespace
+{
+	constexpr int MinimumPageSize = 256;
+	constexpr int PageSizeInLines = 8;
+	constexpr int GlyphPadding = 1;
+	constexpr int MinimumDistanceFieldSpread = 2;
+	constexpr int DistanceFieldSpreadDivisor = 8;
+
+	void clearTexture(unsigned int textureId, Vector<int> size);
+}
+
+
+/**
+ * Opens a font for rasterizing glyphs.
+ *
+ * \param	fontData	Contents of a TrueType or OpenType font file.
+ * \param	ptSize		Point size to open the font at.
+ * \param	renderMode	Whether glyphs are stored as coverage or distance fields.
+ */
+GlyphCache::GlyphCache(std::string fontData, unsigned int ptSize, FontRenderMode renderMode) :
+	mFontData{std::move(fontData)},
+	mPointSize{ptSize},
+	mKerning{[this](char32_t previous, char32_t current) { return TTF_GetFontKerningSizeGlyphs32(mFont, previous, current); }}
+{
+	mFont = openFont();
+	if (!mFont)
+	{
+		throw std::runtime_error("Font load function failed: " + std::string{TTF_GetError()});
+	}
+
+	if (renderMode == FontRenderMode::DistanceField)
+	{
+		mDistanceFieldSpread = std::max(MinimumDistanceFieldSpread, TTF_FontHeight(mFont) / DistanceFieldSpreadDivisor);
+	}
+
+	const auto pageLength = static_cast<int>(roundUpPowerOf2(static_cast<uint32_t>(std::max(MinimumPageSize, TTF_FontHeight(mFont) * PageSizeInLines))));
+	mPageSize = {pageLength, pageLength};
+}
+
+
+GlyphCache::~GlyphCache()
+{
+	for (const auto& page : mPages)
+	{
+		Utility<TextureManager>::get().remove(page.textureId);
+		glDeleteTextures(1, &page.textureId);
+	}
+
+	TTF_CloseFont(mFont);
+}
+
+
+_TTF_Font* GlyphCache::font() const
+{
+	return mFont;
+}
+
+
+/**
+ * Opens another handle to the font.
+ *
+ * Separate handles can rasterize glyphs on separate threads at the same
+ * time. The caller must close the handle with TTF_CloseFont before the
+ * GlyphCache is destroyed, as the font data is owned by the cache.
+ *
+ * \note	Opening and closing handles is not thread safe, and should be
+ *			done from a single thread.
+ *
+ * \return	Font handle, or nullptr if the font could not be opened.
+ */
+_TTF_Font* GlyphCache::openFont() const
+{
+	return TTF_OpenFontRW(SDL_RWFromConstMem(mFontData.c_str(), static_cast<int>(mFontData.size())), 1, static_cast<int>(mPointSize));
+}
+
+
+/**
+ * Distance in pixels covered by the values of distance field glyphs.
+ *
+ * \return	Spread of the distance fields, or 0 if glyphs are stored as coverage.
+ */
+int GlyphCache::distanceFieldSpread() const
+{
+	return mDistanceFieldSpread;
+}
+
+
+/**
+ * Starts a new batch of glyph lookups.
+ *
+ * Should be called before looking up the glyphs of quads that are drawn
+ * together. Glyphs looked up since the previous call may be evicted again.
+ */
+void GlyphCache::beginBatch()
+{
+	mPageUsage.beginBatch();
+}
+
+
+/**
+ * Gets the metrics of a glyph, rasterizing it if it is not cached.
+ *
+ * The metrics stay valid until the next batch starts.
+ *
+ * \return	Metrics of the glyph, or nullptr if the font has no glyph for the
+ *			codepoint, or it does not fit in pages not used by the current batch.
+ */
+const Font::GlyphMetrics* GlyphCache::glyph(char32_t codepoint)
+{
+	const auto iterator = mEntries.find(codepoint);
+	const auto* entry = (iterator != mEntries.end()) ? &iterator->second : rasterize(codepoint);
+	if (!entry || !entry->isProvided)
+	{
+		return nullptr;
+	}
+
+	if (entry->page != NoPage)
+	{
+		mPageUsage.use(entry->page);
+	}
+	return &entry->metrics;
+}
+
+
+/**
+ * Gets the horizontal kerning adjustment in pixels between two characters.
+ *
+ * Does not query the font for preloaded characters, or for pairs that are
+ * still cached from an earlier use.
+ */
+int GlyphCache::kerning(char32_t previous, char32_t current)
+{
+	return mKerning.kerning(previous, current);
+}
+
+
+/**
+ * Stores the kerning of all pairs of characters below a count at once.
+ *
+ * \param	characterCount	Characters below this codepoint are covered by the pairs.
+ * \param	kerningPairs	Every pair of those characters with non-zero kerning.
+ */
+void GlyphCache::preloadKerning(char32_t characterCount, const std::vector<KerningPair>& kerningPairs)
+{
+	mKerning.preload(characterCount, kerningPairs);
+}
+
+
+/**
+ * Number of cached glyphs, including codepoints the font has no glyph for.
+ */
+std::size_t GlyphCache::glyphCount() const
+{
+	return mEntries.size();
+}
+
+
+std::size_t GlyphCache::pageCount() const
+{
+	return mPages.size();
+}
+
+
+/**
+ * Generation of the page using a texture, which changes every time the page is cleared.
+ *
+ * Anything holding on to texture coordinates of cached glyphs on the page
+ * must look them up again when this changes.
+ *
+ * \return	Generation of the page, or 0 if no page uses the texture.
+ */
+std::size_t GlyphCache::pageGeneration(unsigned int textureId) const
+{
+	for (std::size_t pageIndex = 0; pageIndex < mPages.size(); ++pageIndex)
+	{
+		if (mPages[pageIndex].textureId == textureId)
+		{
+			return mPageUsage.generation(pageIndex);
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * Rasterizes a glyph and caches it.
+ *
+ * \return	Cached entry, or nullptr if every page is used by the current
+ *			batch. The glyph is not cached then, and is tried again later.
+ */
+const GlyphCache::Entry* GlyphCache::rasterize(char32_t codepoint)
+{
+	Entry entry{{}, NoPage, TTF_GlyphIsProvided32(mFont, codepoint) != 0};
+	if (entry.isProvided)
+	{
+		auto& metrics = entry.metrics;
+		TTF_GlyphMetrics32(mFont, codepoint, &metrics.minX, &metrics.maxX, &metrics.minY, &metrics.maxY, &metrics.advance);
+
+		// A glyph surface can fail to be created for glyphs of size 0, which have nothing to draw
+		auto* glyphSurface = TTF_RenderGlyph32_Blended(mFont, codepoint, SDL_Color{255, 255, 255, 255});
+		if (glyphSurface)
+		{
+			const auto bounds = opaqueBounds(glyphSurface, {{0, 0}, {glyphSurface->w, glyphSurface->h}});
+			Point<int> position;
+			if (!bounds.empty())
+			{
+				auto alpha = alphaChannel(glyphSurface, bounds);
+				auto glyphSize = bounds.size;
+				auto glyphOrigin = bounds.position;
+				if (mDistanceFieldSpread > 0)
+				{
+					alpha = distanceField(alpha, bounds.size, mDistanceFieldSpread);
+					glyphSize += Vector{mDistanceFieldSpread, mDistanceFieldSpread} * 2;
+					glyphOrigin -= Vector{mDistanceFieldSpread, mDistanceFieldSpread};
+				}
+
+				entry.page = allocate(glyphSize, position);
+				if (entry.page == PagesInBatch)
+				{
+					SDL_FreeSurface(glyphSurface);
+					return nullptr;
+				}
+
+				entry.isProvided = (entry.page != NoPage);
+				if (entry.isProvided)
+				{
+					const auto& page = mPages[entry.page];
+					upload(page, position, alpha, glyphSize);
+					metrics.textureId = page.textureId;
+					metrics.size = glyphSize;
+					metrics.offset = {std::min(metrics.minX, 0) + glyphOrigin.x, glyphOrigin.y};
+					metrics.uvRect = Rectangle{position, glyphSize}.to<float>().skewInverseBy(mPageSize.to<float>());
+				}
+			}
+			SDL_FreeSurface(glyphSurface);
+		}
+	}
+
+	return &mEntries.try_emplace(codepoint, entry).first->second;
+}
+
+
+/**
+ * Finds space for a glyph, adding a page or evicting the least recently used page if needed.
+ *
+ * \return	Index of the page, NoPage if the glyph is larger than a page, or
+ *			PagesInBatch if all pages are full and used by the current batch.
+ */
+std::size_t GlyphCache::allocate(Vector<int> size, Point<int>& position)
+{
+	for (std::size_t pageIndex = 0; pageIndex < mPages.size(); ++pageIndex)
+	{
+		if (const auto packedPosition = mPages[pageIndex].packer.insert(size))
+		{
+			position = *packedPosition;
+			return pageIndex;
+		}
+	}
+
+	std::size_t pageIndex = mPages.size();
+	if (mPages.size() < MaxPages)
+	{
+		addPage();
+	}
+	else
+	{
+		pageIndex = mPageUsage.leastRecentlyUsed();
+		if (pageIndex == NoPage)
+		{
+			return PagesInBatch;
+		}
+		evictPage(pageIndex);
+	}
+
+	const auto packedPosition = mPages[pageIndex].packer.insert(size);
+	if (!packedPosition)
+	{
+		return NoPage;
+	}
+	position = *packedPosition;
+	return pageIndex;
+}
+
+
+void GlyphCache::addPage()
+{
+	unsigned int textureId = 0;
+	glGenTextures(1, &textureId);
+	glBindTexture(GL_TEXTURE_2D, textureId);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mPageSize.x, mPageSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	clearTexture(textureId, mPageSize);
+
+	// Glyphs are only kept on the GPU, so the page must never be evicted by the TextureManager
+	const auto byteSize = mPageSize.to<std::size_t>();
+	Utility<TextureManager>::get().add(textureId, byteSize.x * byteSize.y * 4u);
+
+	mPages.push_back(Page{textureId, ShelfPacker{mPageSize, GlyphPadding}});
+	mPageUsage.addPage();
+}
+
+
+void GlyphCache::evictPage(std::size_t pageIndex)
+{
+	std::erase_if(mEntries, [pageIndex](const auto& item) { return item.second.page == pageIndex; });
+
+	auto& page = mPages[pageIndex];
+	page.packer.clear();
+	clearTexture(page.textureId, mPageSize);
+	mPageUsage.evict(pageIndex);
+}
+
+
+/**
+ * Copies the alpha values of a glyph to a page as white pixels.
+ *
+ * Text color is applied when drawing by modulating with the vertex color.
+ */
+void GlyphCache::upload(const Page& page, Point<int> position, const std::vector<std::uint8_t>& alpha, Vector<int> size)
+{
+	const auto premultiplied = Utility<TextureManager>::get().premultipliedAlpha();
+	mUploadBuffer.resize(alpha.size() * 4u);
+
+	auto* destination = mUploadBuffer.data();
+	for (const auto value : alpha)
+	{
+		const auto color = premultiplied ? value : uint8_t{255};
+		*destination++ = color;
+		*destination++ = color;
+		*destination++ = color;
+		*destination++ = value;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, page.textureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, mUploadBuffer.data());
+}
+
+
+/**
+ * \param	query			Gets the kerning of a pair from the font.
+ * \param	maxCachedPairs	Number of queried pairs kept before the least recently used is evicted.
+ */
+KerningTable::KerningTable(QueryFunction query, std::size_t maxCachedPairs) :
+	mQuery{std::move(query)},
+	mMaxCachedPairs{std::max(maxCachedPairs, std::size_t{1})}
+{
+}
+
+
+/**
+ * Stores the kerning of all pairs of characters below a count at once.
+ *
+ * Preloaded pairs are never evicted.
+ *
+ * \param	characterCount	Characters below this codepoint are covered by the pairs.
+ * \param	kerningPairs	Every pair of those characters with non-zero kerning.
+ */
+void KerningTable::preload(char32_t characterCount, const std::vector<KerningPair>& kerningPairs)
+{
+	mPreloadedPairs.reserve(mPreloadedPairs.size() + kerningPairs.size());
+	for (const auto& kerningPair : kerningPairs)
+	{
+		mPreloadedPairs.insert_or_assign(key(kerningPair.previous, kerningPair.current), kerningPair.amount);
+	}
+	mPreloadedCount = characterCount;
+}
+
+
+/**
+ * Gets the kerning of a pair, querying it if it is neither preloaded nor cached.
+ *
+ * Looking up a preloaded or cached pair does not allocate.
+ */
+int KerningTable::kerning(char32_t previous, char32_t current)
+{
+	const auto pairKey = key(previous, current);
+	if (previous < mPreloadedCount && current < mPreloadedCount)
+	{
+		// Preloaded pairs without kerning are not stored
+		const auto iterator = mPreloadedPairs.find(pairKey);
+		return (iterator != mPreloadedPairs.end()) ? iterator->second : 0;
+	}
+
+	const auto iterator = mCachedPairIndex.find(pairKey);
+	if (iterator != mCachedPairIndex.end())
+	{
+		mCachedPairs.splice(mCachedPairs.begin(), mCachedPairs, iterator->second);
+		return iterator->second->second;
+	}
+
+	const auto amount = mQuery(previous, current);
+	if (mCachedPairs.size() >= mMaxCachedPairs)
+	{
+		// Reuse the node of the least recently used pair
+		mCachedPairIndex.erase(mCachedPairs.back().first);
+		mCachedPairs.splice(mCachedPairs.begin(), mCachedPairs, std::prev(mCachedPairs.end()));
+		mCachedPairs.front() = {pairKey, amount};
+	}
+	else
+	{
+		mCachedPairs.emplace_front(pairKey, amount);
+	}
+	mCachedPairIndex.try_emplace(pairKey, mCachedPairs.begin());
+	return amount;
+}
+
+
+/**
+ * Number of queried pairs currently cached, not counting preloaded pairs.
+ */
+std::size_t KerningTable::cachedPairCount() const
+{
+	return mCachedPairs.size();
+}
+
+
+std::uint64_t KerningTable::key(char32_t previous, char32_t current)
+{
+	return (static_cast<std::uint64_t>(previous) << 32) | current;
+}
+
+
+void GlyphPageUsage::addPage()
+{
+	mLastUsed.push_back(0);
+	mGenerations.push_back(0);
+}
+
+
+void GlyphPageUsage::use(std::size_t page)
+{
+	mLastUsed[page] = ++mUseCount;
+}
+
+
+/**
+ * Starts a new batch. Pages used so far may be evicted again.
+ */
+void GlyphPageUsage::beginBatch()
+{
+	mBatchStart = mUseCount;
+}
+
+
+void GlyphPageUsage::evict(std::size_t page)
+{
+	++mGenerations[page];
+}
+
+
+bool GlyphPageUsage::isInBatch(std::size_t page) const
+{
+	return mLastUsed[page] > mBatchStart;
+}
+
+
+/**
+ * Finds the least recently used page that is not used by the current batch.
+ *
+ * \return	Index of the page, or NoPage if every page is used by the current batch.
+ */
+std::size_t GlyphPageUsage::leastRecentlyUsed() const
+{
+	std::size_t leastRecentlyUsed = NoPage;
+	for (std::size_t page = 0; page < mLastUsed.size(); ++page)
+	{
+		if (!isInBatch(page) && (leastRecentlyUsed == NoPage || mLastUsed[page] < mLastUsed[leastRecentlyUsed]))
+		{
+			leastRecentlyUsed = page;
+		}
+	}
+	return leastRecentlyUsed;
+}
+
+
+std::size_t GlyphPageUsage::pageCount() const
+{
+	return mLastUsed.size();
+}
+
+
+std::size_t GlyphPageUsage::generation(std::size_t page) const
+{
+	return mGenerations[page];
+}
+
+
+namespace
+{
+	/**
+	 * Sets all pixels of a texture to transparent, so padding between glyphs never samples old glyphs.
+	 */
+	void clearTexture(unsigned int textureId, Vector<int> size)
+	{
+		const auto byteSize = size.to<std::size_t>();
+		const std::vector<uint8_t> transparentPixels(byteSize.x * byteSize.y * 4u, 0);
+		glBindTexture(GL_TEXTURE_2D, textureId);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, transparentPixels.data());
+	}
+}
@@ -0,0 +1,187 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Font.h"
+
+#include "../Math/Rectangle.h"
+#include "../Math/ShelfPacker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+struct _TTF_Font;
+
+
+namespace NAS2D
+{
+	/**
+	 * Tracks use of glyph cache pages to choose which page to evict.
+	 *
+	 * Pages are evicted least recently used first. Pages used since the start
+	 * of the current batch hold glyphs of quads that may be queued but not yet
+	 * drawn, so they are never chosen.
+	 *
+	 * Each page also has a generation, which changes every time the page is
+	 * evicted, so users of glyphs on a page can tell when they are stale.
+	 */
+	class GlyphPageUsage
+	{
+	public:
+		static constexpr std::size_t NoPage{static_cast<std::size_t>(-1)};
+
+		void addPage();
+		void use(std::size_t page);
+		void beginBatch();
+		void evict(std::size_t page);
+
+		bool isInBatch(std::size_t page) const;
+		std::size_t leastRecentlyUsed() const;
+		std::size_t pageCount() const;
+		std::size_t generation(std::size_t page) const;
+
+	private:
+		std::vector<std::uint64_t> mLastUsed{};
+		std::vector<std::size_t> mGenerations{};
+		std::uint64_t mUseCount{0};
+		std::uint64_t mBatchStart{0};
+	};
+
+
+	struct KerningPair
+	{
+		char32_t previous;
+		char32_t current;
+		int amount;
+	};
+
+
+	/**
+	 * Kerning between pairs of characters, looked up without querying the font again.
+	 *
+	 * Pairs of preloaded characters are computed up front and only stored when
+	 * they have kerning. Other pairs are queried on first use and cached. When
+	 * the cache is full, the least recently used pair is evicted, so text using
+	 * many different characters does not grow it without bound.
+	 */
+	class KerningTable
+	{
+	public:
+		using QueryFunction = std::function<int(char32_t previous, char32_t current)>;
+
+		static constexpr std::size_t DefaultMaxCachedPairs{4096};
+
+		explicit KerningTable(QueryFunction query, std::size_t maxCachedPairs = DefaultMaxCachedPairs);
+
+		void preload(char32_t characterCount, const std::vector<KerningPair>& kerningPairs);
+		int kerning(char32_t previous, char32_t current);
+
+		std::size_t cachedPairCount() const;
+
+	private:
+		using CachedPair = std::pair<std::uint64_t, int>;
+
+		static std::uint64_t key(char32_t previous, char32_t current);
+
+		QueryFunction mQuery;
+		std::size_t mMaxCachedPairs;
+		char32_t mPreloadedCount{0};
+		std::unordered_map<std::uint64_t, int> mPreloadedPairs{};
+		std::list<CachedPair> mCachedPairs{};
+		std::unordered_map<std::uint64_t, std::list<CachedPair>::iterator> mCachedPairIndex{};
+	};
+
+
+	/**
+	 * Rasterizes glyphs of a TrueType or OpenType font on first use.
+	 *
+	 * Glyphs are packed into texture pages. When all pages are full, the least
+	 * recently used page is cleared and its glyphs are rasterized again the
+	 * next time they are needed. Looking up a glyph that is already cached
+	 * does not allocate.
+	 *
+	 * In FontRenderMode::DistanceField glyphs are stored as signed distance
+	 * fields, extended by distanceFieldSpread() pixels on every side.
+	 *
+	 * Kerning between pairs of characters is also cached, see KerningTable.
+	 *
+	 * The cache keeps the font file data and font handle open for its lifetime.
+	 *
+	 * Glyphs are looked up in batches, see beginBatch. Pages holding glyphs
+	 * of the current batch are not evicted, so glyph quads queued for one draw
+	 * call always refer to the glyphs they were built from. If a batch uses
+	 * more glyphs than fit in all pages, the glyphs that do not fit are
+	 * reported as missing for that batch.
+	 */
+	class GlyphCache
+	{
+	public:
+		static constexpr std::size_t MaxPages{4};
+
+		GlyphCache(std::string fontData, unsigned int ptSize, FontRenderMode renderMode = FontRenderMode::Coverage);
+		GlyphCache(const GlyphCache&) = delete;
+		GlyphCache& operator=(const GlyphCache&) = delete;
+		~GlyphCache();
+
+		_TTF_Font* font() const;
+		_TTF_Font* openFont() const;
+		int distanceFieldSpread() const;
+
+		void beginBatch();
+		const Font::GlyphMetrics* glyph(char32_t codepoint);
+
+		int kerning(char32_t previous, char32_t current);
+		void preloadKerning(char32_t characterCount, const std::vector<KerningPair>& kerningPairs);
+
+		std::size_t glyphCount() const;
+		std::size_t pageCount() const;
+		std::size_t pageGeneration(unsigned int textureId) const;
+
+	private:
+		static constexpr std::size_t NoPage{GlyphPageUsage::NoPage};
+		static constexpr std::size_t PagesInBatch{NoPage - 1};
+
+		struct Page
+		{
+			unsigned int textureId;
+			ShelfPacker packer;
+		};
+
+		struct Entry
+		{
+			Font::GlyphMetrics metrics;
+			std::size_t page;
+			bool isProvided;
+		};
+
+		const Entry* rasterize(char32_t codepoint);
+		std::size_t allocate(Vector<int> size, Point<int>& position);
+		void addPage();
+		void evictPage(std::size_t pageIndex);
+		void upload(const Page& page, Point<int> position, const std::vector<std::uint8_t>& alpha, Vector<int> size);
+
+		std::string mFontData;
+		unsigned int mPointSize;
+		KerningTable mKerning;
+		_TTF_Font* mFont{nullptr};
+		int mDistanceFieldSpread{0};
+		Vector<int> mPageSize{0, 0};
+		std::vector<Page> mPages{};
+		GlyphPageUsage mPageUsage{};
+		std::unordered_map<char32_t, Entry> mEntries{};
+		std::vector<std::uint8_t> mUploadBuffer{};
+	};
+} // namespace NAS2D
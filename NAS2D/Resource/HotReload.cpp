@@ -0,0 +1,238 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "HotReload.h"
+
+#include "AnimationSet.h"
+#include "Image.h"
+#include "SpriteCaches.h"
+#include "SpriteDefinition.h"
+#include "../ContainerUtils.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	std::vector<std::string> imageSheetPathList(const AnimationSet& animationSet)
+	{
+		return mapToVector(animationSet.imageSheets(), [](const auto& imageSheet) { return imageSheet.second; });
+	}
+}
+
+
+/**
+ * Starts watching loaded sprite files for changes.
+ *
+ * \param	pollInterval	Time between checks of file modification times.
+ */
+HotReload::HotReload(std::chrono::milliseconds pollInterval) :
+	mPollInterval{pollInterval}
+{
+	mThread = std::thread{[this]() { watch(); }};
+}
+
+
+HotReload::~HotReload()
+{
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		mStop = true;
+	}
+	mStopCondition.notify_one();
+	mThread.join();
+}
+
+
+/**
+ * Replaces resources which have been reloaded since the last call.
+ *
+ * Must be called on the render thread, when no sprites are being updated
+ * or drawn, such as at the start of a frame.
+ */
+void HotReload::update()
+{
+	std::vector<ReloadedImage> reloadedImages;
+	std::vector<ReloadedAnimationSet> reloadedAnimationSets;
+	std::vector<Failure> failures;
+
+	// Resources stay pending while poll builds AnimationSets, as it reads cached images and AnimationSets
+	std::unique_lock<std::mutex> imageLock{mImageMutex, std::try_to_lock};
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		if (imageLock.owns_lock())
+		{
+			std::swap(reloadedImages, mReloadedImages);
+			std::swap(reloadedAnimationSets, mReloadedAnimationSets);
+		}
+		std::swap(failures, mFailures);
+	}
+
+	std::vector<std::string> swappedImages;
+	for (auto& [filePath, image] : reloadedImages)
+	{
+		if (auto* cachedImage = spriteImageCache().find(filePath))
+		{
+			cachedImage->swap(*image);
+			swappedImages.push_back(filePath);
+		}
+	}
+	if (!swappedImages.empty())
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		mSwappedImages.insert(mSwappedImages.end(), swappedImages.begin(), swappedImages.end());
+	}
+
+	std::vector<std::string> replacedAnimationSets;
+	for (auto& [filePath, animationSet] : reloadedAnimationSets)
+	{
+		if (auto* cachedAnimationSet = spriteAnimationCache().find(filePath))
+		{
+			cachedAnimationSet->reload(std::move(*animationSet));
+			replacedAnimationSets.push_back(filePath);
+		}
+	}
+	if (imageLock.owns_lock())
+	{
+		imageLock.unlock();
+	}
+
+	for (const auto& filePath : swappedImages)
+	{
+		mReloadSignal(filePath);
+	}
+
+	for (const auto& filePath : replacedAnimationSets)
+	{
+		mReloadSignal(filePath);
+	}
+
+	for (const auto& [filePath, message] : failures)
+	{
+		mReloadFailedSignal(filePath, message);
+	}
+}
+
+
+/**
+ * Signal emitted from update with the path of each reloaded file.
+ */
+HotReload::ReloadSignal::Source& HotReload::reloadSignalSource()
+{
+	return mReloadSignal;
+}
+
+
+/**
+ * Signal emitted from update with the path and error message of each file that failed to reload.
+ */
+HotReload::ReloadFailedSignal::Source& HotReload::reloadFailedSignalSource()
+{
+	return mReloadFailedSignal;
+}
+
+
+void HotReload::watch()
+{
+	std::unique_lock<std::mutex> lock{mMutex};
+	while (!mStopCondition.wait_for(lock, mPollInterval, [this]() { return mStop; }))
+	{
+		lock.unlock();
+		poll();
+		lock.lock();
+	}
+}
+
+
+/**
+ * Loads changed files again, queueing the results for update.
+ *
+ * Sprite files are also loaded again when an image sheet they use was
+ * replaced. Sprite files using an image sheet which is still waiting to be
+ * replaced are skipped, and loaded once it has been, so their frames are
+ * checked against the new image.
+ */
+void HotReload::poll()
+{
+	for (const auto& [filePath] : spriteImageCache().keys())
+	{
+		if (!mFileWatcher.hasChanged(filePath))
+		{
+			continue;
+		}
+
+		try
+		{
+			auto image = std::make_unique<Image>(filePath);
+			std::lock_guard<std::mutex> lock{mMutex};
+			mReloadedImages.push_back({filePath, std::move(image)});
+		}
+		catch (const std::exception& error)
+		{
+			std::lock_guard<std::mutex> lock{mMutex};
+			mFailures.push_back({filePath, error.what()});
+		}
+	}
+
+	// Keeps update from replacing images and AnimationSets while they are read here
+	std::lock_guard<std::mutex> imageLock{mImageMutex};
+	std::vector<std::string> pendingImages;
+	std::vector<std::string> swappedImages;
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		for (const auto& reloadedImage : mReloadedImages)
+		{
+			pendingImages.push_back(reloadedImage.filePath);
+		}
+		std::swap(swappedImages, mSwappedImages);
+	}
+
+	for (const auto& [filePath] : spriteAnimationCache().keys())
+	{
+		// Both are checked, so both modification times are recorded
+		const auto definitionChanged = mFileWatcher.hasChanged(filePath);
+		const auto compiledDefinitionChanged = mFileWatcher.hasChanged(compiledSpritePath(filePath));
+
+		const auto [imageSheetPaths, isNew] = mImageSheetPaths.try_emplace(filePath);
+		if (isNew)
+		{
+			if (const auto* animationSet = spriteAnimationCache().find(filePath))
+			{
+				imageSheetPaths->second = imageSheetPathList(*animationSet);
+			}
+		}
+
+		const auto& usedImages = imageSheetPaths->second;
+		const auto usesAnyOf = [&usedImages](const std::vector<std::string>& images) {
+			return std::any_of(usedImages.begin(), usedImages.end(), [&images](const auto& image) { return has(images, image); });
+		};
+		if (usesAnyOf(pendingImages) || (!definitionChanged && !compiledDefinitionChanged && !usesAnyOf(swappedImages)))
+		{
+			continue;
+		}
+
+		try
+		{
+			auto animationSet = std::make_unique<AnimationSet>(filePath);
+			imageSheetPaths->second = imageSheetPathList(*animationSet);
+			std::lock_guard<std::mutex> lock{mMutex};
+			mReloadedAnimationSets.push_back({filePath, std::move(animationSet)});
+		}
+		catch (const std::exception& error)
+		{
+			std::lock_guard<std::mutex> lock{mMutex};
+			mFailures.push_back({filePath, error.what()});
+		}
+	}
+}
@@ -0,0 +1,105 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../FileWatcher.h"
+#include "../Signal/Signal.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class AnimationSet;
+	class Image;
+
+
+	/**
+	 * Reloads sprite files and their image sheets when they change, for use
+	 * during development.
+	 *
+	 * While a HotReload exists, a background thread polls the modification
+	 * times of every sprite file loaded through Sprite, of its compiled sprite
+	 * file, and of every image sheet used by those sprites. Changed files are
+	 * loaded again on the background thread. The reloaded resources replace the
+	 * old ones in place during update, which should be called once per frame
+	 * before sprites are updated and drawn. When an image sheet changes, every
+	 * sprite file using it is loaded again after the new image is in place.
+	 *
+	 * Existing Sprite handles stay valid and show the new frames. Actions keep
+	 * their ids, see AnimationSet::reload. Files that fail to load are reported
+	 * with the reload failed signal, and tried again the next time they change.
+	 *
+	 * \note	Filesystem search paths should not change while a HotReload exists.
+	 *			AnimationSets packed into a SpriteAtlas are not reloaded.
+	 */
+	class HotReload
+	{
+	public:
+		using ReloadSignal = Signal<const std::string&>;
+		using ReloadFailedSignal = Signal<const std::string&, const std::string&>;
+
+		explicit HotReload(std::chrono::milliseconds pollInterval = std::chrono::milliseconds{500});
+		HotReload(const HotReload&) = delete;
+		HotReload& operator=(const HotReload&) = delete;
+		~HotReload();
+
+		void update();
+
+		ReloadSignal::Source& reloadSignalSource();
+		ReloadFailedSignal::Source& reloadFailedSignalSource();
+
+	private:
+		struct ReloadedImage
+		{
+			std::string filePath;
+			std::unique_ptr<Image> image;
+		};
+
+		struct ReloadedAnimationSet
+		{
+			std::string filePath;
+			std::unique_ptr<AnimationSet> animationSet;
+		};
+
+		struct Failure
+		{
+			std::string filePath;
+			std::string message;
+		};
+
+		void watch();
+		void poll();
+
+		std::chrono::milliseconds mPollInterval;
+		FileWatcher mFileWatcher{}; /**< Only used by the background thread. */
+		std::map<std::string, std::vector<std::string>> mImageSheetPaths{}; /**< Image sheets used by each sprite file. Only used by the background thread. */
+
+		std::mutex mImageMutex{}; /**< Held by poll while it reads cached resources, and by update while it replaces them. */
+		std::mutex mMutex{};
+		std::condition_variable mStopCondition{};
+		bool mStop{false};
+		std::vector<ReloadedImage> mReloadedImages{};
+		std::vector<std::string> mSwappedImages{}; /**< Images replaced by update, whose sprite files have not been loaded again yet. */
+		std::vector<ReloadedAnimationSet> mReloadedAnimationSets{};
+		std::vector<Failure> mFailures{};
+
+		ReloadSignal mReloadSignal{};
+		ReloadFailedSignal mReloadFailedSignal{};
+		std::thread mThread{};
+	};
+} // namespace NAS2D
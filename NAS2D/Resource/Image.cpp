@@ -8,6 +8,7 @@
 // = Acknowledgment of your use of NAS2D is appreciated but is not required.
 // ==================================================================================
 #include "Image.h"
+#include "TextureManager.h"
 
 #include "../Math/Rectangle.h"
 #include "../Filesystem.h"
@@ -21,7 +22,10 @@
 #include <SDL2/SDL_image.h>
 #endif
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <vector>
 #include <utility>
 #include <string>
 #include <stdexcept>
@@ -31,15 +35,21 @@ using namespace NAS2D;
 
 
 unsigned int generateTexture(SDL_Surface* surface);
-unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height);
+unsigned int generateTexture(SDL_Surface* surface, TextureFilter filter);
+unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height, TextureFilter filter);
+void updateTexture(unsigned int textureId, SDL_Surface* surface, const Rectangle<int>& region);
+Rectangle<int> opaqueBounds(SDL_Surface* surface, const Rectangle<int>& region);
+std::vector<uint8_t> alphaChannel(SDL_Surface* surface, const Rectangle<int>& region);
 
 
 namespace
 {
 	constexpr bool isBigEndian = SDL_BYTEORDER == SDL_BIG_ENDIAN;
 
-	unsigned int generateFbo(unsigned int textureId, Vector<int> imageSize);
 	unsigned int readPixelValue(std::uintptr_t pixelAddress, unsigned int bytesPerPixel);
+	void premultiplyAlpha(SDL_Surface* surface);
+	void premultiplyAlpha(uint32_t* pixels, std::size_t count, uint32_t alphaShift);
+	void setTextureFilter(TextureFilter filter);
 }
 
 
@@ -86,10 +96,11 @@ SDL_Surface* Image::dataToSdlSurface(void* buffer, int bytesPerPixel, Vector<int
 /**
  * Loads an Image from disk.
  *
- * \param filePath Path to an image file.
+ * \param filePath	Path to an image file.
+ * \param filter	Texture sampling mode used when the Image is drawn.
  */
-Image::Image(const std::string& filePath) :
-	Image{*fileToSdlSurface(filePath)}
+Image::Image(const std::string& filePath, TextureFilter filter) :
+	Image{*fileToSdlSurface(filePath), filter}
 {
 }
 
@@ -100,28 +111,27 @@ Image::Image(const std::string& filePath) :
  * \param	buffer			Pointer to a data buffer.
  * \param	bytesPerPixel	Number of bytes per pixel. Valid values are 3 and 4 (images < 24-bit are not supported).
  * \param	size			Size of the Image in pixels.
+ * \param	filter			Texture sampling mode used when the Image is drawn.
  */
-Image::Image(void* buffer, int bytesPerPixel, Vector<int> size) :
-	Image{*dataToSdlSurface(buffer, bytesPerPixel, size)}
+Image::Image(void* buffer, int bytesPerPixel, Vector<int> size, TextureFilter filter) :
+	Image{*dataToSdlSurface(buffer, bytesPerPixel, size), filter}
 {
 }
 
 
-Image::Image(SDL_Surface& surface) :
+Image::Image(SDL_Surface& surface, TextureFilter filter) :
 	mSurface{&surface},
-	mSize{mSurface->w, mSurface->h}
+	mSize{mSurface->w, mSurface->h},
+	mFilter{filter}
 {
 }
 
 
 Image::~Image()
 {
-	if (mFrameBufferObjectId != 0)
-	{
-		glDeleteFramebuffers(1, &mFrameBufferObjectId);
-	}
 	if (mTextureId != 0)
 	{
+		Utility<TextureManager>::get().remove(mTextureId);
 		glDeleteTextures(1, &mTextureId);
 	}
 
@@ -168,23 +178,159 @@ Color Image::pixelColor(Point<int> point) const
 }
 
 
+/**
+ * Finds the smallest area of a region containing every pixel that is not fully transparent.
+ *
+ * Images without an alpha channel are treated as fully opaque.
+ *
+ * \param	region	Area of the Image to search.
+ * \return	Bounds in Image coordinates. Empty if every pixel in the region is transparent.
+ */
+Rectangle<int> Image::opaqueBounds(const Rectangle<int>& region) const
+{
+	if (!Rectangle{{0, 0}, mSize}.contains(region))
+	{
+		throw std::runtime_error("Image region out of bounds: {" + std::to_string(region.position.x) + ", " + std::to_string(region.position.y) + ", " + std::to_string(region.size.x) + ", " + std::to_string(region.size.y) + "}");
+	}
+
+	return ::opaqueBounds(mSurface, region);
+}
+
+
+/**
+ * Gets the texture sampling mode the Image was loaded with.
+ */
+TextureFilter Image::filter() const
+{
+	return mFilter;
+}
+
+
+/**
+ * Exchanges the pixels of two Images.
+ *
+ * References to both Images stay valid, and show the other Image's pixels
+ * afterwards. Each Image keeps its texture filter. Used to reload an Image
+ * in place. Textures of both Images are released, and uploaded again the
+ * next time they are drawn.
+ *
+ * \note	Must be called on the render thread.
+ */
+void Image::swap(Image& other)
+{
+	for (const auto* image : {this, &other})
+	{
+		if (image->mTextureId != 0)
+		{
+			Utility<TextureManager>::get().remove(image->mTextureId);
+			image->evictTexture();
+		}
+	}
+
+	std::swap(mSurface, other.mSurface);
+	std::swap(mSize, other.mSize);
+}
+
+
+/**
+ * Gets the OpenGL texture of the Image, uploading it if needed.
+ *
+ * The texture is registered with the TextureManager, and may be evicted and
+ * later uploaded again from the retained surface.
+ */
 unsigned int Image::textureId() const
 {
+	auto& textureManager = Utility<TextureManager>::get();
 	if (mTextureId == 0)
 	{
-		mTextureId = generateTexture(mSurface);
+		mTextureId = generateTexture(mSurface, mFilter);
+		textureManager.add(mTextureId, textureByteSize(), {this, &Image::evictTexture});
+	}
+	else
+	{
+		textureManager.touch(mTextureId);
+		if (mMipmapsStale)
+		{
+			glBindTexture(GL_TEXTURE_2D, mTextureId);
+			glGenerateMipmap(GL_TEXTURE_2D);
+		}
 	}
+	mMipmapsStale = false;
 	return mTextureId;
 }
 
 
-unsigned int Image::frameBufferObjectId() const
+/**
+ * Replaces a region of a 32-bit Image with new pixel data.
+ *
+ * The retained surface is always updated. If the texture is resident, only
+ * the changed region is uploaded to it, otherwise the next upload picks up
+ * the change from the surface.
+ *
+ * Mipmaps of a Trilinear Image are regenerated from the whole texture, so
+ * this is deferred until the texture is next drawn, once for any number of
+ * updates in between.
+ *
+ * \param	region	Area of the Image to replace.
+ * \param	pixels	Pixel data for the region, in the same format as the Image.
+ * \param	pitch	Length in bytes of a row of the source pixel data.
+ */
+void Image::updatePixels(const Rectangle<int>& region, const void* pixels, int pitch)
 {
-	if (mFrameBufferObjectId == 0)
+	if (!Rectangle{{0, 0}, mSize}.contains(region))
+	{
+		throw std::runtime_error("Image update region out of bounds: {" + std::to_string(region.position.x) + ", " + std::to_string(region.position.y) + ", " + std::to_string(region.size.x) + ", " + std::to_string(region.size.y) + "}");
+	}
+
+	if (mSurface->format->BytesPerPixel != 4)
 	{
-		mFrameBufferObjectId = generateFbo(mTextureId, mSize);
+		throw std::runtime_error("Image update requires a 32-bit Image");
+	}
+
+	if (region.size.x <= 0 || region.size.y <= 0)
+	{
+		return;
+	}
+
+	const auto rowByteSize = static_cast<std::size_t>(region.size.x) * 4u;
+	const auto* sourceRow = static_cast<const uint8_t*>(pixels);
+
+	SDL_LockSurface(mSurface);
+	auto* destinationRow = static_cast<uint8_t*>(mSurface->pixels) + region.position.y * mSurface->pitch + region.position.x * 4;
+	for (int y = 0; y < region.size.y; ++y)
+	{
+		std::memcpy(destinationRow, sourceRow, rowByteSize);
+		destinationRow += mSurface->pitch;
+		sourceRow += pitch;
+	}
+	SDL_UnlockSurface(mSurface);
+
+	if (mTextureId != 0)
+	{
+		updateTexture(mTextureId, mSurface, region);
+		Utility<TextureManager>::get().touch(mTextureId);
+		mMipmapsStale = (mFilter == TextureFilter::Trilinear);
 	}
-	return mFrameBufferObjectId;
+}
+
+
+/**
+ * Approximate GPU memory used by the texture, including mipmap levels.
+ */
+std::size_t Image::textureByteSize() const
+{
+	const auto bytesPerPixel = std::size_t{(mSurface->format->BytesPerPixel == 3) ? 3u : 4u};
+	const auto baseLevelSize = mSize.to<std::size_t>();
+	const auto byteSize = baseLevelSize.x * baseLevelSize.y * bytesPerPixel;
+	return (mFilter == TextureFilter::Trilinear) ? byteSize * 4 / 3 : byteSize;
+}
+
+
+void Image::evictTexture() const
+{
+	glDeleteTextures(1, &mTextureId);
+	mTextureId = 0;
+	mMipmapsStale = false;
 }
 
 
@@ -212,30 +358,81 @@ namespace
 
 
 	/**
-	 * Generates an OpenGL Frame Buffer Object.
+	 * Scales the color channels of a 32-bit pixel by its alpha channel.
+	 *
+	 * Two channels are scaled at once in 16-bit lanes of a 32-bit word, and
+	 * the loop over pixels has no branches so it can be vectorized.
 	 */
-	unsigned int generateFbo(unsigned int textureId, Vector<int> imageSize)
+	constexpr uint32_t premultipliedPixel(uint32_t pixel, uint32_t alphaShift)
 	{
-		unsigned int framebuffer;
-		glGenFramebuffers(1, &framebuffer);
-		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		constexpr uint32_t laneMask = 0x00FF00FF;
+		constexpr uint32_t laneRounding = 0x00800080;
+		const auto alphaMask = uint32_t{0xFF} << alphaShift;
+		const auto alpha = (pixel >> alphaShift) & 0xFF;
+
+		auto evenChannels = (pixel & laneMask) * alpha + laneRounding;
+		auto oddChannels = ((pixel >> 8) & laneMask) * alpha + laneRounding;
+		evenChannels = ((evenChannels + ((evenChannels >> 8) & laneMask)) >> 8) & laneMask;
+		oddChannels = ((oddChannels + ((oddChannels >> 8) & laneMask)) >> 8) & laneMask;
+
+		return ((evenChannels | (oddChannels << 8)) & ~alphaMask) | (pixel & alphaMask);
+	}
+
 
-		if (textureId == 0)
+	/**
+	 * Converts a 32-bit surface with an alpha channel to premultiplied alpha in place.
+	 */
+	void premultiplyAlpha(SDL_Surface* surface)
+	{
+		const auto* format = surface->format;
+		if (format->BytesPerPixel != 4 || format->Amask == 0)
 		{
-			unsigned int textureColorbuffer;
-			glGenTextures(1, &textureColorbuffer);
-			glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
-			const auto textureFormat = (isBigEndian) ? GL_BGRA : GL_RGBA;
+			return;
+		}
 
-			glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, imageSize.x, imageSize.y, 0, textureFormat, GL_UNSIGNED_BYTE, nullptr);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		const auto width = static_cast<std::size_t>(surface->w);
+		SDL_LockSurface(surface);
+		for (int y = 0; y < surface->h; ++y)
+		{
+			auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(surface->pixels) + y * surface->pitch);
+			premultiplyAlpha(row, width, format->Ashift);
+		}
+		SDL_UnlockSurface(surface);
+	}
+
+
+	void premultiplyAlpha(uint32_t* pixels, std::size_t count, uint32_t alphaShift)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			pixels[i] = premultipliedPixel(pixels[i], alphaShift);
 		}
+	}
 
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-		return framebuffer;
+	/**
+	 * Sets sampling state of the currently bound texture.
+	 *
+	 * \note	Trilinear filtering expects the texture's mipmap chain to
+	 *			be generated after the base level has been uploaded.
+	 */
+	void setTextureFilter(TextureFilter filter)
+	{
+		switch (filter)
+		{
+		case TextureFilter::Nearest:
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			break;
+		case TextureFilter::Linear:
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			break;
+		case TextureFilter::Trilinear:
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			break;
+		}
 	}
 }
 
@@ -244,21 +441,36 @@ namespace
  * Generates a new OpenGL texture from an SDL_Surface.
  */
 unsigned int generateTexture(SDL_Surface* surface)
+{
+	return generateTexture(surface, TextureFilter::Linear);
+}
+
+
+/**
+ * Generates a new OpenGL texture from an SDL_Surface using the given sampling mode.
+ */
+unsigned int generateTexture(SDL_Surface* surface, TextureFilter filter)
 {
 	const auto bytesPerPixel = surface->format->BytesPerPixel;
-	if (bytesPerPixel == 3 || bytesPerPixel == 4)
+	const auto premultiply = Utility<TextureManager>::get().premultipliedAlpha() && bytesPerPixel != 3;
+	if ((bytesPerPixel == 3 || bytesPerPixel == 4) && !premultiply)
 	{
-		return generateTexture(surface->pixels, bytesPerPixel, surface->w, surface->h);
+		return generateTexture(surface->pixels, bytesPerPixel, surface->w, surface->h, filter);
 	}
 
+	// Convert a copy, so the source surface keeps straight alpha for pixelColor and later uploads
 	auto* newSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
-	const auto textureId = generateTexture(newSurface->pixels, newSurface->format->BytesPerPixel, newSurface->w, newSurface->h);
+	if (premultiply)
+	{
+		premultiplyAlpha(newSurface);
+	}
+	const auto textureId = generateTexture(newSurface->pixels, newSurface->format->BytesPerPixel, newSurface->w, newSurface->h, filter);
 	SDL_FreeSurface(newSurface);
 	return textureId;
 }
 
 
-unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height)
+unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height, TextureFilter filter)
 {
 	GLint internalFormat = 0;
 	GLenum textureFormat = 0;
@@ -283,12 +495,141 @@ unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int hei
 
 	// Set texture and pixel handling states.
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	setTextureFilter(filter);
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, textureFormat, GL_UNSIGNED_BYTE, buffer);
 
+	// The GPU selects mipmap levels from the on screen scale of each draw
+	if (filter == TextureFilter::Trilinear)
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
 	return textureId;
 }
+
+
+/**
+ * Uploads a region of a 32-bit surface to an existing texture.
+ *
+ * Rows are read directly from the surface, so only the bytes of the region
+ * are transferred. In premultiplied alpha mode the region is converted in a
+ * buffer the size of the region first.
+ *
+ * \note	Mipmaps are not updated.
+ */
+void updateTexture(unsigned int textureId, SDL_Surface* surface, const Rectangle<int>& region)
+{
+	const auto* regionPixels = static_cast<const uint8_t*>(surface->pixels) + region.position.y * surface->pitch + region.position.x * 4;
+	auto rowLength = surface->pitch / 4;
+
+	std::vector<uint32_t> premultipliedPixels;
+	if (Utility<TextureManager>::get().premultipliedAlpha() && surface->format->Amask != 0)
+	{
+		const auto width = static_cast<std::size_t>(region.size.x);
+		premultipliedPixels.resize(width * static_cast<std::size_t>(region.size.y));
+		for (int y = 0; y < region.size.y; ++y)
+		{
+			auto* row = premultipliedPixels.data() + static_cast<std::size_t>(y) * width;
+			std::memcpy(row, regionPixels + y * surface->pitch, width * 4u);
+			premultiplyAlpha(row, width, surface->format->Ashift);
+		}
+		regionPixels = reinterpret_cast<const uint8_t*>(premultipliedPixels.data());
+		rowLength = region.size.x;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, textureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, region.position.x, region.position.y, region.size.x, region.size.y, isBigEndian ? GL_BGRA : GL_RGBA, GL_UNSIGNED_BYTE, regionPixels);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+
+/**
+ * Finds the smallest area of a surface region containing every pixel that is not fully transparent.
+ *
+ * Surfaces without an alpha channel are treated as fully opaque.
+ *
+ * \return	Bounds in surface coordinates. Empty if every pixel in the region is transparent.
+ */
+Rectangle<int> opaqueBounds(SDL_Surface* surface, const Rectangle<int>& region)
+{
+	const auto* format = surface->format;
+	if (format->BytesPerPixel != 4 || format->Amask == 0)
+	{
+		return region;
+	}
+
+	const auto regionEnd = region.endPoint();
+	auto start = regionEnd;
+	auto end = region.position;
+
+	SDL_LockSurface(surface);
+	for (int y = region.position.y; y < regionEnd.y; ++y)
+	{
+		const auto* row = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch);
+
+		// Branch free so it vectorizes, as most rows of a sprite frame's margin are fully transparent
+		uint32_t rowBits = 0;
+		for (int x = region.position.x; x < regionEnd.x; ++x)
+		{
+			rowBits |= row[x];
+		}
+		if ((rowBits & format->Amask) == 0)
+		{
+			continue;
+		}
+
+		// Only columns outside the bounds found so far can widen them
+		int x = region.position.x;
+		while (x < start.x && (row[x] & format->Amask) == 0) { ++x; }
+
+		int lastX = regionEnd.x - 1;
+		while (lastX >= end.x && (row[lastX] & format->Amask) == 0) { --lastX; }
+
+		start = {std::min(start.x, x), std::min(start.y, y)};
+		end = {std::max(end.x, lastX + 1), y + 1};
+	}
+	SDL_UnlockSurface(surface);
+
+	if (end.x <= start.x)
+	{
+		return {region.position, {0, 0}};
+	}
+	return Rectangle<int>::Create(start, end);
+}
+
+
+/**
+ * Copies the alpha values of a surface region, row by row.
+ *
+ * Surfaces without an alpha channel are treated as fully opaque.
+ */
+std::vector<uint8_t> alphaChannel(SDL_Surface* surface, const Rectangle<int>& region)
+{
+	const auto regionSize = region.size.to<std::size_t>();
+	const auto* format = surface->format;
+	if (format->BytesPerPixel != 4 || format->Amask == 0)
+	{
+		return std::vector<uint8_t>(regionSize.x * regionSize.y, 255);
+	}
+
+	std::vector<uint8_t> alpha;
+	alpha.reserve(regionSize.x * regionSize.y);
+
+	SDL_LockSurface(surface);
+	for (int y = region.position.y; y < region.endPoint().y; ++y)
+	{
+		const auto* row = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch);
+		for (int x = region.position.x; x < region.endPoint().x; ++x)
+		{
+			alpha.push_back(static_cast<uint8_t>((row[x] & format->Amask) >> format->Ashift));
+		}
+	}
+	SDL_UnlockSurface(surface);
+
+	return alpha;
+}
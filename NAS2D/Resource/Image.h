@@ -13,6 +13,7 @@
 #include "../Math/Point.h"
 #include "../Math/Vector.h"
 
+#include <cstddef>
 #include <string>
 
 
@@ -22,6 +23,27 @@ struct SDL_Surface;
 namespace NAS2D
 {
 
+	/**
+	 * Texture sampling mode used when an Image is uploaded to the GPU.
+	 *
+	 * - Nearest: No filtering. Best suited for pixel art.
+	 * - Linear: Bilinear filtering. The default.
+	 * - Trilinear: Bilinear filtering between mipmap levels. Mipmaps are
+	 *   generated when the texture is uploaded. Best suited for Images that
+	 *   are drawn scaled down, such as zoomed out map views.
+	 */
+	enum class TextureFilter
+	{
+		Nearest,
+		Linear,
+		Trilinear,
+	};
+
+
+	template <typename BaseType>
+	struct Rectangle;
+
+
 	/**
 	 * Image Class
 	 *
@@ -42,9 +64,9 @@ namespace NAS2D
 		static SDL_Surface* dataToSdlSurface(void* buffer, int bytesPerPixel, Vector<int> size);
 
 	public:
-		explicit Image(const std::string& filePath);
-		Image(void* buffer, int bytesPerPixel, Vector<int> size);
-		Image(SDL_Surface& surface);
+		explicit Image(const std::string& filePath, TextureFilter filter = TextureFilter::Linear);
+		Image(void* buffer, int bytesPerPixel, Vector<int> size, TextureFilter filter = TextureFilter::Linear);
+		Image(SDL_Surface& surface, TextureFilter filter = TextureFilter::Linear);
 
 		Image(const Image& rhs) = delete;
 		Image& operator=(const Image& rhs) = delete;
@@ -54,17 +76,28 @@ namespace NAS2D
 		Vector<int> size() const;
 
 		Color pixelColor(Point<int> point) const;
+		Rectangle<int> opaqueBounds(const Rectangle<int>& region) const;
+
+		TextureFilter filter() const;
+
+		void swap(Image& other);
 
 	protected:
 		friend class RendererOpenGL;
+		friend class SpriteAtlas;
 		unsigned int textureId() const;
-		unsigned int frameBufferObjectId() const;
+
+		void updatePixels(const Rectangle<int>& region, const void* pixels, int pitch);
 
 	private:
+		std::size_t textureByteSize() const;
+		void evictTexture() const;
+
 		SDL_Surface* mSurface{nullptr};
 		mutable unsigned int mTextureId{0u};
-		mutable unsigned int mFrameBufferObjectId{0u};
+		mutable bool mMipmapsStale{false};
 		Vector<int> mSize{0, 0};
+		TextureFilter mFilter{TextureFilter::Linear};
 	};
 
 } // namespace
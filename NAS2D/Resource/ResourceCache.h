@@ -10,13 +10,29 @@
 
 #pragma once
 
+#include <exception>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <tuple>
+#include <vector>
 
 
 namespace NAS2D
 {
 
+	/**
+	 * Loads resources once and shares them between all users.
+	 *
+	 * Resources are identified by their constructor parameters. Loading is
+	 * thread safe. Concurrent loads of the same resource construct it once,
+	 * with the other callers waiting for it, while different resources are
+	 * constructed in parallel. If construction throws, all waiting callers
+	 * get the exception, and the next load tries again.
+	 *
+	 * \note	References to a resource stay valid until it is unloaded. Unloading
+	 *			must not happen concurrently with use of the resource.
+	 */
 	template <typename Resource, typename... Params>
 	class ResourceCache
 	{
@@ -29,39 +45,118 @@ namespace NAS2D
 			// Cache lookup key is a tuple of all Resource constructor parameters
 			const auto key = Key{params...};
 
-			// Try to find resource from the cache
-			auto iter = cache.find(key);
-			if (iter == cache.end())
+			// Find or add the entry, without holding the cache lock during construction
+			std::shared_ptr<Entry> entry;
 			{
-				// Resource wasn't found, so create new one using constructor parameters
-				const auto pairIterBool = cache.try_emplace(key, params...);
-				iter = pairIterBool.first;
+				std::lock_guard<std::mutex> lock{mMutex};
+				auto& slot = cache[key];
+				if (!slot)
+				{
+					slot = std::make_shared<Entry>();
+				}
+				entry = slot;
+			}
+
+			std::lock_guard<std::mutex> entryLock{entry->mutex};
+			if (entry->error)
+			{
+				std::rethrow_exception(entry->error);
+			}
+			if (!entry->resource)
+			{
+				try
+				{
+					// Resource wasn't loaded yet, so create new one using constructor parameters
+					entry->resource = std::make_unique<Resource>(params...);
+				}
+				catch (...)
+				{
+					entry->error = std::current_exception();
+					std::lock_guard<std::mutex> lock{mMutex};
+					const auto iter = cache.find(key);
+					if (iter != cache.end() && iter->second == entry)
+					{
+						cache.erase(iter);
+					}
+					throw;
+				}
 			}
 
 			// Return reference to found or created cached object
-			return iter->second;
+			return *entry->resource;
+		}
+
+
+		/**
+		 * Gets a loaded resource to change it in place, such as to reload it.
+		 *
+		 * \return	The resource, or nullptr if it is not loaded.
+		 */
+		Resource* find(Params... params)
+		{
+			std::shared_ptr<Entry> entry;
+			{
+				std::lock_guard<std::mutex> lock{mMutex};
+				const auto iter = cache.find(Key{params...});
+				if (iter == cache.end())
+				{
+					return nullptr;
+				}
+				entry = iter->second;
+			}
+
+			// Waits for the resource if it is still being constructed
+			std::lock_guard<std::mutex> entryLock{entry->mutex};
+			return entry->resource.get();
+		}
+
+
+		/**
+		 * Gets the keys of all loaded resources, including resources still being loaded.
+		 */
+		std::vector<Key> keys() const
+		{
+			std::lock_guard<std::mutex> lock{mMutex};
+			std::vector<Key> keys;
+			keys.reserve(cache.size());
+			for (const auto& item : cache)
+			{
+				keys.push_back(item.first);
+			}
+			return keys;
 		}
 
 
 		void unload(Params... params)
 		{
+			std::lock_guard<std::mutex> lock{mMutex};
 			cache.erase(Key{params...});
 		}
 
 
 		void clear()
 		{
+			std::lock_guard<std::mutex> lock{mMutex};
 			cache.clear();
 		}
 
 
 		auto size() const
 		{
+			std::lock_guard<std::mutex> lock{mMutex};
 			return cache.size();
 		}
 
 	private:
-		std::map<Key, Resource> cache{};
+		struct Entry
+		{
+			std::mutex mutex{};
+			std::unique_ptr<Resource> resource{};
+			std::exception_ptr error{};
+		};
+
+		std::map<Key, std::shared_ptr<Entry>> cache{};
+		mutable std::mutex mMutex{};
 	};
 
 } // namespace
@@ -0,0 +1,247 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "RichTextLayout.h"
+
+#include "../Utf8Range.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	std::optional<Color> parseHexColor(std::string_view hex);
+	std::optional<uint8_t> parseByte(std::string_view decimal);
+}
+
+
+namespace NAS2D
+{
+	/**
+	 * Removes markup tags from text and records the style of each remaining codepoint.
+	 *
+	 * \see RichTextLayout for the markup syntax.
+	 *
+	 * \param	markup			UTF-8 encoded text with markup.
+	 * \param	defaultColor	Color of text outside of color spans.
+	 *
+	 * \return	UTF-8 encoded text without markup, and one style for each of its codepoints.
+	 */
+	MarkupText parseMarkup(std::string_view markup, Color defaultColor)
+	{
+		MarkupText markupText;
+		markupText.text.reserve(markup.size());
+		markupText.styles.reserve(markup.size());
+
+		std::vector<Color> colors{defaultColor};
+		std::vector<uint8_t> alphas{};
+		std::vector<Color> shadowColors{};
+		const auto currentStyle = [&]() {
+			auto color = colors.back();
+			if (!alphas.empty())
+			{
+				color.alpha = alphas.back();
+			}
+			return TextStyle{color, !shadowColors.empty(), shadowColors.empty() ? Color::Black : shadowColors.back()};
+		};
+
+		std::size_t index = 0;
+		while (index < markup.size())
+		{
+			if (markup[index] == '[')
+			{
+				if (markup.substr(index, 2) == "[[")
+				{
+					markupText.text.push_back('[');
+					markupText.styles.push_back(currentStyle());
+					index += 2;
+					continue;
+				}
+
+				const auto tagEnd = markup.find(']', index);
+				const auto tag = (tagEnd == std::string_view::npos) ? std::string_view{} : markup.substr(index + 1, tagEnd - index - 1);
+				const auto separator = tag.find('=');
+				const auto name = tag.substr(0, separator);
+				const auto value = (separator == std::string_view::npos) ? std::string_view{} : tag.substr(separator + 1);
+
+				bool isTag = true;
+				if (name == "color" && parseHexColor(value))
+				{
+					colors.push_back(*parseHexColor(value));
+				}
+				else if (name == "alpha" && parseByte(value))
+				{
+					alphas.push_back(*parseByte(value));
+				}
+				else if (name == "shadow" && (separator == std::string_view::npos || parseHexColor(value)))
+				{
+					shadowColors.push_back((separator == std::string_view::npos) ? Color::Black : *parseHexColor(value));
+				}
+				else if (tag == "/color" && colors.size() > 1)
+				{
+					colors.pop_back();
+				}
+				else if (tag == "/alpha" && !alphas.empty())
+				{
+					alphas.pop_back();
+				}
+				else if (tag == "/shadow" && !shadowColors.empty())
+				{
+					shadowColors.pop_back();
+				}
+				else
+				{
+					isTag = false;
+				}
+
+				if (isTag)
+				{
+					index = tagEnd + 1;
+					continue;
+				}
+			}
+
+			// Re-encode, so invalid bytes decoded as Latin-1 decode the same way again
+			appendUtf8(markupText.text, decodeUtf8(markup, index));
+			markupText.styles.push_back(currentStyle());
+		}
+
+		return markupText;
+	}
+}
+
+
+/**
+ * Parses markup and lays out the resulting text.
+ *
+ * \param	font			Font the text will be drawn with.
+ * \param	markup			UTF-8 encoded text with markup.
+ * \param	defaultColor	Color of text outside of color spans.
+ * \param	maxWidth		Width in pixels at which lines are wrapped. Lines are not wrapped if 0.
+ * \param	alignment		Horizontal alignment of each line.
+ */
+RichTextLayout::RichTextLayout(const Font& font, std::string_view markup, Color defaultColor, int maxWidth, TextAlignment alignment) :
+	RichTextLayout{font, parseMarkup(markup, defaultColor), maxWidth, alignment}
+{
+}
+
+
+RichTextLayout::RichTextLayout(const Font& font, MarkupText markupText, int maxWidth, TextAlignment alignment) :
+	mLayout{font, markupText.text, maxWidth, alignment}
+{
+	// Newlines have a style but no glyph
+	mStyles.reserve(mLayout.glyphs().size());
+	std::size_t styleIndex = 0;
+	for (const auto codepoint : Utf8Range{markupText.text})
+	{
+		if (codepoint != '\n')
+		{
+			mStyles.push_back(markupText.styles[styleIndex]);
+		}
+		++styleIndex;
+	}
+
+	mHasShadow = std::any_of(mStyles.begin(), mStyles.end(), [](const TextStyle& style) { return style.hasShadow; });
+}
+
+
+const TextLayout& RichTextLayout::layout() const
+{
+	return mLayout;
+}
+
+
+/**
+ * Style of each glyph, in the same order as the glyphs of the layout.
+ */
+const std::vector<TextStyle>& RichTextLayout::styles() const
+{
+	return mStyles;
+}
+
+
+/**
+ * Whether any glyph is drawn with a shadow.
+ */
+bool RichTextLayout::hasShadow() const
+{
+	return mHasShadow;
+}
+
+
+Vector<int> RichTextLayout::size() const
+{
+	return mLayout.size();
+}
+
+
+namespace
+{
+	std::optional<uint8_t> parseHexDigit(char digit)
+	{
+		if (digit >= '0' && digit <= '9') { return static_cast<uint8_t>(digit - '0'); }
+		if (digit >= 'a' && digit <= 'f') { return static_cast<uint8_t>(digit - 'a' + 10); }
+		if (digit >= 'A' && digit <= 'F') { return static_cast<uint8_t>(digit - 'A' + 10); }
+		return std::nullopt;
+	}
+
+
+	/**
+	 * Parses a color written as RRGGBB or RRGGBBAA, optionally prefixed with '#'.
+	 */
+	std::optional<Color> parseHexColor(std::string_view hex)
+	{
+		if (!hex.empty() && hex.front() == '#')
+		{
+			hex.remove_prefix(1);
+		}
+		if (hex.size() != 6 && hex.size() != 8)
+		{
+			return std::nullopt;
+		}
+
+		uint8_t channels[4] = {0, 0, 0, 255};
+		for (std::size_t i = 0; i < hex.size(); i += 2)
+		{
+			const auto high = parseHexDigit(hex[i]);
+			const auto low = parseHexDigit(hex[i + 1]);
+			if (!high || !low)
+			{
+				return std::nullopt;
+			}
+			channels[i / 2] = static_cast<uint8_t>(*high * 16 + *low);
+		}
+		return Color{channels[0], channels[1], channels[2], channels[3]};
+	}
+
+
+	std::optional<uint8_t> parseByte(std::string_view decimal)
+	{
+		if (decimal.empty() || decimal.size() > 3)
+		{
+			return std::nullopt;
+		}
+
+		int value = 0;
+		for (const auto digit : decimal)
+		{
+			if (digit < '0' || digit > '9')
+			{
+				return std::nullopt;
+			}
+			value = value * 10 + (digit - '0');
+		}
+		return (value <= 255) ? std::optional<uint8_t>{static_cast<uint8_t>(value)} : std::nullopt;
+	}
+}
@@ -0,0 +1,80 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "TextLayout.h"
+
+#include "../Renderer/Color.h"
+#include "../Math/Vector.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Font;
+
+
+	struct TextStyle
+	{
+		Color color{Color::White};
+		bool hasShadow{false};
+		Color shadowColor{Color::Black};
+	};
+
+
+	/**
+	 * Plain text and the style of each of its codepoints, parsed from markup.
+	 */
+	struct MarkupText
+	{
+		std::string text{};
+		std::vector<TextStyle> styles{};
+	};
+
+
+	MarkupText parseMarkup(std::string_view markup, Color defaultColor = Color::White);
+
+
+	/**
+	 * Layout of text with inline color, alpha and shadow spans.
+	 *
+	 * Spans are written as tags, which may be nested:
+	 * - [color=RRGGBB] or [color=RRGGBBAA] ... [/color]
+	 * - [alpha=0-255] ... [/alpha]
+	 * - [shadow] or [shadow=RRGGBBAA] ... [/shadow]
+	 *
+	 * A literal '[' is written as "[[". Anything else in brackets is kept as
+	 * text. Markup is parsed once, and the whole layout is drawn as a single
+	 * batch with Renderer::drawText, with each glyph colored by its style.
+	 *
+	 * \note	The layout refers to the Font it was created with, which must
+	 *			outlive it.
+	 */
+	class RichTextLayout
+	{
+	public:
+		RichTextLayout(const Font& font, std::string_view markup, Color defaultColor = Color::White, int maxWidth = 0, TextAlignment alignment = TextAlignment::Left);
+
+		const TextLayout& layout() const;
+		const std::vector<TextStyle>& styles() const;
+		bool hasShadow() const;
+		Vector<int> size() const;
+
+	private:
+		RichTextLayout(const Font& font, MarkupText markupText, int maxWidth, TextAlignment alignment);
+
+		TextLayout mLayout;
+		std::vector<TextStyle> mStyles{};
+		bool mHasShadow{false};
+	};
+} // namespace NAS2D
@@ -0,0 +1,234 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "SkeletalSprite.h"
+#include "ResourceCache.h"
+#include "../Utility.h"
+
+#include <algorithm>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	using SkeletonCache = ResourceCache<Skeleton, std::string>;
+	SkeletonCache skeletonCache;
+}
+
+
+SkeletalSprite::SkeletalSprite(const std::string& filePath, const std::string& initialAnimation) :
+	SkeletalSprite{skeletonCache.load(filePath), initialAnimation}
+{
+}
+
+
+SkeletalSprite::SkeletalSprite(const Skeleton& skeleton, const std::string& initialAnimation) :
+	mSkeleton{skeleton},
+	mCurrentAnimationId{mSkeleton.animationId(initialAnimation)}
+{
+}
+
+
+const Skeleton& SkeletalSprite::skeleton() const
+{
+	return mSkeleton;
+}
+
+
+std::vector<std::string> SkeletalSprite::animations() const
+{
+	return mSkeleton.animationNames();
+}
+
+
+/**
+ * Resolves the name of an animation to an id, which can be played without
+ * looking up the name again.
+ *
+ * \throw	std::runtime_error if the animation is not defined.
+ */
+SkeletalSprite::AnimationId SkeletalSprite::animationId(const std::string& animation) const
+{
+	return mSkeleton.animationId(animation);
+}
+
+
+/**
+ * Plays an animation from the start.
+ *
+ * \param	animation	Name of the animation to play.
+ */
+void SkeletalSprite::play(const std::string& animation)
+{
+	play(mSkeleton.animationId(animation));
+}
+
+
+/**
+ * Plays an animation by id, see animationId.
+ */
+void SkeletalSprite::play(AnimationId animation)
+{
+	mCurrentAnimationId = animation;
+	mTime = 0;
+	mTimer.reset();
+	resume();
+}
+
+
+void SkeletalSprite::pause()
+{
+	mPaused = true;
+}
+
+
+void SkeletalSprite::resume()
+{
+	mPaused = false;
+}
+
+
+/**
+ * Sets the time since the current animation started.
+ *
+ * \note	Animation complete signals are not emitted when seeking.
+ *
+ * \param	animationTime	Time in milliseconds.
+ */
+void SkeletalSprite::seek(unsigned int animationTime)
+{
+	const auto& animation = mSkeleton.animation(mCurrentAnimationId);
+	mTime = (animation.loops && animation.duration > 0) ? animationTime % animation.duration : std::min(animationTime, animation.duration);
+	mTimer.reset();
+}
+
+
+/**
+ * Gets the time in milliseconds since the current animation started.
+ */
+unsigned int SkeletalSprite::time() const
+{
+	return mTime;
+}
+
+
+void SkeletalSprite::update()
+{
+	advanceByTimeDelta(mTimer.delta());
+}
+
+
+/**
+ * Draws all parts of the skeleton.
+ *
+ * \param	position	Screen position of the root bone's origin.
+ */
+void SkeletalSprite::draw(Point<float> position) const
+{
+	mSkeleton.pose(mCurrentAnimationId, mTime, {Vector{position.x, position.y}, mRotationAngleDegrees}, mPose);
+
+	auto& renderer = Utility<Renderer>::get();
+	const auto& parts = mSkeleton.parts();
+	mSubImages.clear();
+	for (std::size_t i = 0; i < parts.size(); ++i)
+	{
+		const auto& part = parts[i];
+		const auto bone = part.bone;
+
+		// Quads are rotated about their center, so place the center relative to the bone
+		const auto halfSize = part.bounds.size.to<float>() / 2.0f;
+		const auto center = halfSize - part.anchorOffset.to<float>();
+		const auto cos = mPose.cos[bone];
+		const auto sin = mPose.sin[bone];
+		const auto worldCenter = Point{mPose.x[bone] + cos * center.x - sin * center.y, mPose.y[bone] + sin * center.x + cos * center.y};
+		mSubImages.push_back({worldCenter - halfSize, part.bounds.position.to<float>(), part.bounds.size.to<float>(), mPose.rotation[bone], mTintColor});
+
+		const auto isLastOfBatch = (i + 1 == parts.size()) || (&parts[i + 1].image != &part.image);
+		if (isLastOfBatch)
+		{
+			renderer.drawSubImages(part.image, mSubImages);
+			mSubImages.clear();
+		}
+	}
+}
+
+
+/**
+ * Sets the rotation angle of the whole skeleton.
+ *
+ * \param	angle	Angle of rotation in degrees.
+ */
+void SkeletalSprite::rotation(float angle)
+{
+	mRotationAngleDegrees = angle;
+}
+
+
+float SkeletalSprite::rotation() const
+{
+	return mRotationAngleDegrees;
+}
+
+
+void SkeletalSprite::color(Color color)
+{
+	mTintColor = color;
+}
+
+
+Color SkeletalSprite::color() const
+{
+	return mTintColor;
+}
+
+
+SkeletalSprite::AnimationCompleteSignal::Source& SkeletalSprite::animationCompleteSignalSource()
+{
+	return mAnimationCompleteSignal;
+}
+
+
+/**
+ * Advances animation time. Looping animations signal completion each time
+ * they wrap, others stop at their end and signal once.
+ */
+void SkeletalSprite::advanceByTimeDelta(unsigned int timeDelta)
+{
+	if (mPaused)
+	{
+		return;
+	}
+
+	const auto& animation = mSkeleton.animation(mCurrentAnimationId);
+	mTime += timeDelta;
+
+	unsigned int completions = 0;
+	if (mTime >= animation.duration)
+	{
+		if (animation.loops && animation.duration > 0)
+		{
+			completions = mTime / animation.duration;
+			mTime %= animation.duration;
+		}
+		else
+		{
+			completions = 1;
+			mTime = animation.duration;
+			mPaused = true;
+		}
+	}
+
+	// Playback state is updated first, so handlers are free to play another animation
+	for (unsigned int i = 0; i < completions; ++i)
+	{
+		mAnimationCompleteSignal();
+	}
+}
@@ -0,0 +1,88 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Skeleton.h"
+#include "../Signal/Signal.h"
+#include "../Timer.h"
+#include "../Renderer/Color.h"
+#include "../Renderer/Renderer.h"
+
+#include <string>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Skeletal animated sprite.
+	 *
+	 * Plays the animations of a Skeleton. All bone transforms are computed
+	 * once per draw, and parts are drawn in batches of consecutive parts
+	 * sharing an image sheet, so a character made of many parts costs few
+	 * draw calls.
+	 */
+	class SkeletalSprite
+	{
+	public:
+		using AnimationCompleteSignal = Signal<>;
+		using AnimationId = Skeleton::AnimationId;
+
+		SkeletalSprite(const std::string& filePath, const std::string& initialAnimation);
+		SkeletalSprite(const Skeleton& skeleton, const std::string& initialAnimation);
+		SkeletalSprite(const SkeletalSprite&) = default;
+		SkeletalSprite(SkeletalSprite&&) = default;
+		const SkeletalSprite& operator=(const SkeletalSprite&) = delete;
+		SkeletalSprite& operator=(SkeletalSprite&&) = delete;
+
+		const Skeleton& skeleton() const;
+
+		std::vector<std::string> animations() const;
+		AnimationId animationId(const std::string& animation) const;
+
+		void play(const std::string& animation);
+		void play(AnimationId animation);
+		void pause();
+		void resume();
+
+		void seek(unsigned int animationTime);
+		unsigned int time() const;
+
+		void update();
+		void draw(Point<float> position) const;
+
+		void rotation(float angle);
+		float rotation() const;
+
+		void color(Color color);
+		Color color() const;
+
+		AnimationCompleteSignal::Source& animationCompleteSignalSource();
+
+	protected:
+		void advanceByTimeDelta(unsigned int timeDelta);
+
+	private:
+		const Skeleton& mSkeleton;
+		AnimationId mCurrentAnimationId;
+		unsigned int mTime{0};
+
+		bool mPaused{false};
+		Timer mTimer{};
+		AnimationCompleteSignal mAnimationCompleteSignal{};
+
+		Color mTintColor{Color::Normal};
+		float mRotationAngleDegrees{0.0f};
+
+		// Reused by draw, to avoid allocating each frame
+		mutable Skeleton::Pose mPose{};
+		mutable std::vector<SubImageDraw> mSubImages{};
+	};
+} // namespace
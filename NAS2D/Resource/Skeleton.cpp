@@ -0,0 +1,467 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "Skeleton.h"
+
+#include "SpriteCaches.h"
+#include "../ContainerUtils.h"
+#include "../Filesystem.h"
+#include "../ParserHelper.h"
+#include "../Utility.h"
+#include "../Math/Trig.h"
+#include "../Xml/Xml.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr std::string_view SKELETON_VERSION{"1.0"};
+
+	using ImageSheetMap = std::map<std::string, const Image*>;
+	using AnimationMap = std::map<std::string, Skeleton::Animation>;
+
+
+	// Adds a row tag to the end of messages.
+	std::string endTag(int row)
+	{
+		return " (Row: " + std::to_string(row) + ")";
+	}
+
+
+	std::tuple<std::vector<Skeleton::Bone>, std::vector<Skeleton::Part>, AnimationMap> processDefinition(const std::string& filePath);
+	ImageSheetMap processImageSheets(const std::string& basePath, const Xml::XmlElement* element);
+	std::vector<Skeleton::Bone> processBones(const Xml::XmlElement* element);
+	std::vector<Skeleton::Part> processParts(const ImageSheetMap& imageSheets, const std::vector<Skeleton::Bone>& bones, const Xml::XmlElement* element);
+	AnimationMap processAnimations(const std::vector<Skeleton::Bone>& bones, const Xml::XmlElement* element);
+	std::size_t boneIndex(const std::vector<Skeleton::Bone>& bones, const std::string& boneName, int row);
+
+
+	Skeleton::Transform sample(const std::vector<Skeleton::Keyframe>& keyframes, unsigned int time)
+	{
+		const auto isBefore = [](unsigned int value, const Skeleton::Keyframe& keyframe) { return value < keyframe.time; };
+		const auto next = std::upper_bound(keyframes.begin(), keyframes.end(), time, isBefore);
+		if (next == keyframes.begin())
+		{
+			return next->transform;
+		}
+		const auto previous = next - 1;
+		if (next == keyframes.end())
+		{
+			return previous->transform;
+		}
+
+		const auto fraction = static_cast<float>(time - previous->time) / static_cast<float>(next->time - previous->time);
+		const auto& from = previous->transform;
+		const auto& to = next->transform;
+		return {
+			from.position + (to.position - from.position) * fraction,
+			from.rotation + (to.rotation - from.rotation) * fraction,
+		};
+	}
+}
+
+
+/**
+ * Loads a skeleton XML definition file.
+ *
+ * Image sheets are shared with sprites loaded from sprite files.
+ *
+ * \throw	std::runtime_error if the file is malformed.
+ */
+Skeleton::Skeleton(const std::string& filePath) :
+	mBones{},
+	mParts{}
+{
+	auto [bones, parts, animations] = processDefinition(filePath);
+	mBones = std::move(bones);
+	mParts = std::move(parts);
+	initialize(std::move(animations));
+}
+
+
+/**
+ * Creates a skeleton from already loaded data.
+ *
+ * \throw	std::runtime_error if a bone is defined before its parent, or
+ *			if a part or track references an undefined bone.
+ */
+Skeleton::Skeleton(std::vector<Bone> bones, std::vector<Part> parts, std::map<std::string, Animation> animations) :
+	mBones{std::move(bones)},
+	mParts{std::move(parts)}
+{
+	initialize(std::move(animations));
+}
+
+
+const std::vector<Skeleton::Bone>& Skeleton::bones() const
+{
+	return mBones;
+}
+
+
+/**
+ * Gets the image parts, in draw order.
+ */
+const std::vector<Skeleton::Part>& Skeleton::parts() const
+{
+	return mParts;
+}
+
+
+std::vector<std::string> Skeleton::animationNames() const
+{
+	return getKeys(mAnimationIds);
+}
+
+
+/**
+ * Resolves the name of an animation to its id.
+ *
+ * \throw	std::runtime_error if the animation is not defined.
+ */
+Skeleton::AnimationId Skeleton::animationId(const std::string& animationName) const
+{
+	const auto iterator = mAnimationIds.find(animationName);
+	if (iterator == mAnimationIds.end())
+	{
+		throw std::runtime_error("Skeleton::animationId called on undefined animation: " + animationName);
+	}
+
+	return iterator->second;
+}
+
+
+const Skeleton::Animation& Skeleton::animation(AnimationId animationId) const
+{
+	const auto index = static_cast<std::size_t>(animationId);
+	if (index >= mAnimations.size())
+	{
+		throw std::runtime_error("Skeleton::animation called with invalid id: " + std::to_string(index));
+	}
+
+	return mAnimations[index];
+}
+
+
+/**
+ * Computes the world transforms of all bones at a time in an animation.
+ *
+ * Bones without a track keep the transform from their definition. Looping
+ * animations wrap the time, others hold their last keyframes.
+ *
+ * The arrays of \c pose are reused, so a Pose kept between frames does not
+ * allocate. Each step is a separate loop over all bones: composing
+ * rotations, then their sines and cosines, then positions, which keeps
+ * the loops simple enough for the compiler to vectorize where there is
+ * no dependency on a parent.
+ *
+ * \param	animationId	Animation to sample.
+ * \param	time		Time in milliseconds since the animation started.
+ * \param	root		Transform applied to bones without a parent.
+ * \param	pose		Receives the world transforms, indexed like bones.
+ */
+void Skeleton::pose(AnimationId animationId, unsigned int time, const Transform& root, Pose& pose) const
+{
+	const auto& currentAnimation = animation(animationId);
+	const auto boneCount = mBones.size();
+
+	pose.x.assign(mBindX.begin(), mBindX.end());
+	pose.y.assign(mBindY.begin(), mBindY.end());
+	pose.rotation.assign(mBindRotation.begin(), mBindRotation.end());
+	pose.cos.resize(boneCount);
+	pose.sin.resize(boneCount);
+
+	const auto duration = currentAnimation.duration;
+	const auto animationTime = !currentAnimation.loops ? std::min(time, duration) : (duration > 0 ? time % duration : 0);
+	for (const auto& track : currentAnimation.tracks)
+	{
+		const auto transform = sample(track.keyframes, animationTime);
+		pose.x[track.bone] = transform.position.x;
+		pose.y[track.bone] = transform.position.y;
+		pose.rotation[track.bone] = transform.rotation;
+	}
+
+	for (std::size_t i = 0; i < boneCount; ++i)
+	{
+		const auto parent = mParents[i];
+		pose.rotation[i] += (parent == NoParent) ? root.rotation : pose.rotation[parent];
+	}
+
+	for (std::size_t i = 0; i < boneCount; ++i)
+	{
+		const auto radians = pose.rotation[i] * DEG2RAD;
+		pose.cos[i] = std::cos(radians);
+		pose.sin[i] = std::sin(radians);
+	}
+
+	const auto rootRadians = root.rotation * DEG2RAD;
+	const auto rootCos = std::cos(rootRadians);
+	const auto rootSin = std::sin(rootRadians);
+	for (std::size_t i = 0; i < boneCount; ++i)
+	{
+		const auto parent = mParents[i];
+		const auto hasParent = parent != NoParent;
+		const auto parentX = hasParent ? pose.x[parent] : root.position.x;
+		const auto parentY = hasParent ? pose.y[parent] : root.position.y;
+		const auto parentCos = hasParent ? pose.cos[parent] : rootCos;
+		const auto parentSin = hasParent ? pose.sin[parent] : rootSin;
+		const auto x = pose.x[i];
+		const auto y = pose.y[i];
+		pose.x[i] = parentX + parentCos * x - parentSin * y;
+		pose.y[i] = parentY + parentSin * x + parentCos * y;
+	}
+}
+
+
+void Skeleton::initialize(std::map<std::string, Animation> animations)
+{
+	for (std::size_t i = 0; i < mBones.size(); ++i)
+	{
+		const auto& bone = mBones[i];
+		if (bone.parent != NoParent && bone.parent >= i)
+		{
+			throw std::runtime_error("Skeleton bone must be defined after its parent: " + bone.name);
+		}
+
+		mParents.push_back(bone.parent);
+		mBindX.push_back(bone.transform.position.x);
+		mBindY.push_back(bone.transform.position.y);
+		mBindRotation.push_back(bone.transform.rotation);
+	}
+
+	for (const auto& part : mParts)
+	{
+		if (part.bone >= mBones.size())
+		{
+			throw std::runtime_error("Skeleton part references undefined bone: " + std::to_string(part.bone));
+		}
+	}
+
+	for (auto& [name, animation] : animations)
+	{
+		for (const auto& track : animation.tracks)
+		{
+			if (track.bone >= mBones.size())
+			{
+				throw std::runtime_error("Skeleton animation track references undefined bone: " + name);
+			}
+			if (track.keyframes.empty())
+			{
+				throw std::runtime_error("Skeleton animation track has no keyframes: " + name);
+			}
+		}
+
+		mAnimationIds.try_emplace(name, AnimationId{mAnimations.size()});
+		mAnimations.push_back(std::move(animation));
+	}
+}
+
+
+namespace
+{
+	/**
+	 * Parses a skeleton XML definition file and loads its image sheets.
+	 */
+	std::tuple<std::vector<Skeleton::Bone>, std::vector<Skeleton::Part>, AnimationMap> processDefinition(const std::string& filePath)
+	{
+		try
+		{
+			const auto xmlData = Utility<Filesystem>::get().readFile(filePath);
+
+			Xml::XmlDocument xmlDoc;
+			xmlDoc.parse(xmlData.c_str());
+
+			if (xmlDoc.error())
+			{
+				throw std::runtime_error("Skeleton file has malformed XML: Row: " + std::to_string(xmlDoc.errorRow()) + " Column: " + std::to_string(xmlDoc.errorCol()) + " : " + xmlDoc.errorDesc());
+			}
+
+			const auto* xmlRootElement = xmlDoc.firstChildElement("skeleton");
+			if (!xmlRootElement)
+			{
+				throw std::runtime_error("Skeleton file does not contain required <skeleton> tag");
+			}
+
+			const auto version = xmlRootElement->attribute("version");
+			if (version != SKELETON_VERSION)
+			{
+				throw std::runtime_error("Skeleton version mismatch. Expected: " + std::string{SKELETON_VERSION} + " Actual: " + version);
+			}
+
+			const auto imageSheets = processImageSheets(Filesystem::parentPath(filePath), xmlRootElement);
+			auto bones = processBones(xmlRootElement);
+			auto parts = processParts(imageSheets, bones, xmlRootElement);
+			auto animations = processAnimations(bones, xmlRootElement);
+			return std::tuple{std::move(bones), std::move(parts), std::move(animations)};
+		}
+		catch (const std::runtime_error& error)
+		{
+			throw std::runtime_error("Error parsing Skeleton file: " + filePath + "\nError: " + error.what());
+		}
+	}
+
+
+	ImageSheetMap processImageSheets(const std::string& basePath, const Xml::XmlElement* element)
+	{
+		ImageSheetMap imageSheets;
+
+		for (const auto* node = element->firstChildElement("imagesheet"); node; node = node->nextSiblingElement("imagesheet"))
+		{
+			const auto dictionary = attributesToDictionary(*node);
+			reportMissingOrUnexpected(dictionary.keys(), {"id", "src"}, {});
+
+			const auto id = dictionary.get("id");
+			const auto src = dictionary.get("src");
+			if (id.empty() || src.empty())
+			{
+				throw std::runtime_error("Skeleton imagesheet definition has `id` or `src` of length zero: " + endTag(node->row()));
+			}
+
+			if (!imageSheets.try_emplace(id, &spriteImageCache().load(basePath + src)).second)
+			{
+				throw std::runtime_error("Skeleton image sheet redefinition: id: '" + id + "' " + endTag(node->row()));
+			}
+		}
+
+		return imageSheets;
+	}
+
+
+	std::vector<Skeleton::Bone> processBones(const Xml::XmlElement* element)
+	{
+		std::vector<Skeleton::Bone> bones;
+
+		for (const auto* node = element->firstChildElement("bone"); node; node = node->nextSiblingElement("bone"))
+		{
+			const auto dictionary = attributesToDictionary(*node);
+			reportMissingOrUnexpected(dictionary.keys(), {"name"}, {"parent", "x", "y", "rotation"});
+
+			const auto name = dictionary.get("name");
+			if (name.empty())
+			{
+				throw std::runtime_error("Skeleton bone definition has 'name' of length zero: " + endTag(node->row()));
+			}
+			const auto isSameName = [&name](const auto& bone) { return bone.name == name; };
+			if (std::any_of(bones.begin(), bones.end(), isSameName))
+			{
+				throw std::runtime_error("Skeleton bone redefinition: '" + name + "' " + endTag(node->row()));
+			}
+
+			const auto parentName = dictionary.get("parent", std::string{});
+			const auto parent = parentName.empty() ? Skeleton::NoParent : boneIndex(bones, parentName, node->row());
+			const auto position = Vector{dictionary.get<float>("x", 0), dictionary.get<float>("y", 0)};
+			bones.push_back({name, parent, {position, dictionary.get<float>("rotation", 0)}});
+		}
+
+		return bones;
+	}
+
+
+	std::vector<Skeleton::Part> processParts(const ImageSheetMap& imageSheets, const std::vector<Skeleton::Bone>& bones, const Xml::XmlElement* element)
+	{
+		std::vector<Skeleton::Part> parts;
+
+		for (const auto* node = element->firstChildElement("part"); node; node = node->nextSiblingElement("part"))
+		{
+			const auto dictionary = attributesToDictionary(*node);
+			reportMissingOrUnexpected(dictionary.keys(), {"bone", "sheetid", "x", "y", "width", "height", "anchorx", "anchory"}, {});
+
+			const auto sheetId = dictionary.get("sheetid");
+			const auto iterator = imageSheets.find(sheetId);
+			if (iterator == imageSheets.end())
+			{
+				throw std::runtime_error("Skeleton part definition references undefined imagesheet: '" + sheetId + "' " + endTag(node->row()));
+			}
+
+			const auto& image = *iterator->second;
+			const auto bounds = Rectangle<int>{{dictionary.get<int>("x"), dictionary.get<int>("y")}, {dictionary.get<int>("width"), dictionary.get<int>("height")}};
+			if (!Rectangle{{0, 0}, image.size()}.contains(bounds))
+			{
+				throw std::runtime_error("Skeleton part bounds exceeds image sheet bounds: " + endTag(node->row()));
+			}
+
+			const auto bone = boneIndex(bones, dictionary.get("bone"), node->row());
+			const auto anchorOffset = Vector{dictionary.get<int>("anchorx"), dictionary.get<int>("anchory")};
+			parts.push_back({bone, image, bounds, anchorOffset});
+		}
+
+		return parts;
+	}
+
+
+	/**
+	 * Parses <animation> tags. Keys are grouped into one track per bone,
+	 * sorted by time.
+	 */
+	AnimationMap processAnimations(const std::vector<Skeleton::Bone>& bones, const Xml::XmlElement* element)
+	{
+		AnimationMap animations;
+
+		for (const auto* node = element->firstChildElement("animation"); node; node = node->nextSiblingElement("animation"))
+		{
+			const auto dictionary = attributesToDictionary(*node);
+			reportMissingOrUnexpected(dictionary.keys(), {"name", "duration"}, {"loop"});
+
+			const auto name = dictionary.get("name");
+			if (name.empty())
+			{
+				throw std::runtime_error("Skeleton animation definition has 'name' of length zero: " + endTag(node->row()));
+			}
+
+			Skeleton::Animation animation{dictionary.get<unsigned int>("duration"), dictionary.get<bool>("loop", true), {}};
+			std::map<std::size_t, std::vector<Skeleton::Keyframe>> boneKeyframes;
+			for (const auto* key = node->firstChildElement("key"); key; key = key->nextSiblingElement("key"))
+			{
+				const auto keyDictionary = attributesToDictionary(*key);
+				reportMissingOrUnexpected(keyDictionary.keys(), {"bone", "time"}, {"x", "y", "rotation"});
+
+				const auto bone = boneIndex(bones, keyDictionary.get("bone"), key->row());
+				const auto& bindTransform = bones[bone].transform;
+				const auto position = Vector{keyDictionary.get<float>("x", bindTransform.position.x), keyDictionary.get<float>("y", bindTransform.position.y)};
+				const auto rotation = keyDictionary.get<float>("rotation", bindTransform.rotation);
+				boneKeyframes[bone].push_back({keyDictionary.get<unsigned int>("time"), {position, rotation}});
+			}
+
+			for (auto& [bone, keyframes] : boneKeyframes)
+			{
+				const auto isEarlier = [](const auto& a, const auto& b) { return a.time < b.time; };
+				std::stable_sort(keyframes.begin(), keyframes.end(), isEarlier);
+				animation.tracks.push_back({bone, std::move(keyframes)});
+			}
+
+			if (!animations.try_emplace(name, std::move(animation)).second)
+			{
+				throw std::runtime_error("Skeleton animation redefinition: '" + name + "' " + endTag(node->row()));
+			}
+		}
+
+		return animations;
+	}
+
+
+	std::size_t boneIndex(const std::vector<Skeleton::Bone>& bones, const std::string& boneName, int row)
+	{
+		const auto isSameName = [&boneName](const auto& bone) { return bone.name == boneName; };
+		const auto iterator = std::find_if(bones.begin(), bones.end(), isSameName);
+		if (iterator == bones.end())
+		{
+			throw std::runtime_error("Skeleton definition references undefined bone: '" + boneName + "' " + endTag(row));
+		}
+
+		return static_cast<std::size_t>(iterator - bones.begin());
+	}
+}
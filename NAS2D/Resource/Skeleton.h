@@ -0,0 +1,147 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Image.h"
+#include "../Math/Point.h"
+#include "../Math/Vector.h"
+#include "../Math/Rectangle.h"
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Skeletal animation resource.
+	 *
+	 * A Skeleton is a hierarchy of bones, each positioned and rotated relative
+	 * to its parent, with image parts attached to the bones. Animations are
+	 * keyframed transforms of bones, interpolated linearly between keyframes.
+	 *
+	 * Skeleton files are XML, in the same style as sprite files:
+	 *
+	 *     <skeleton version="1.0">
+	 *         <imagesheet id="unit" src="unit.png" />
+	 *         <bone name="body" x="0" y="0" />
+	 *         <bone name="arm" parent="body" x="10" y="-4" rotation="0" />
+	 *         <part bone="body" sheetid="unit" x="0" y="0" width="16" height="24" anchorx="8" anchory="12" />
+	 *         <part bone="arm" sheetid="unit" x="16" y="0" width="12" height="4" anchorx="0" anchory="2" />
+	 *         <animation name="wave" duration="1000" loop="true">
+	 *             <key bone="arm" time="0" rotation="-30" />
+	 *             <key bone="arm" time="500" rotation="30" />
+	 *             <key bone="arm" time="1000" rotation="-30" />
+	 *         </animation>
+	 *     </skeleton>
+	 *
+	 * Bones must be defined after their parent. Parts are drawn in the order
+	 * they are defined. Keys may leave out any of x, y and rotation, which
+	 * then keep the bone's value from its definition.
+	 *
+	 * Bone transforms are stored as one array per component, and world
+	 * transforms of all bones are computed by pose in a single pass in bone
+	 * order, which is possible because parents come before their children.
+	 */
+	class Skeleton
+	{
+	public:
+		/**
+		 * Index of an animation, resolved once from its name with animationId.
+		 */
+		enum class AnimationId : std::size_t {};
+
+		static constexpr std::size_t NoParent{std::numeric_limits<std::size_t>::max()};
+
+		/**
+		 * Position and rotation in degrees, relative to a parent bone.
+		 */
+		struct Transform
+		{
+			Vector<float> position{0, 0};
+			float rotation{0};
+		};
+
+		struct Bone
+		{
+			std::string name;
+			std::size_t parent;
+			Transform transform;
+		};
+
+		struct Part
+		{
+			std::size_t bone;
+			const Image& image;
+			Rectangle<int> bounds;
+			Vector<int> anchorOffset; /**< Point of the part placed at the bone's origin. */
+		};
+
+		struct Keyframe
+		{
+			unsigned int time;
+			Transform transform;
+		};
+
+		struct Track
+		{
+			std::size_t bone;
+			std::vector<Keyframe> keyframes;
+		};
+
+		struct Animation
+		{
+			unsigned int duration;
+			bool loops;
+			std::vector<Track> tracks;
+		};
+
+		/**
+		 * World transforms of every bone, one array per component.
+		 */
+		struct Pose
+		{
+			std::vector<float> x{};
+			std::vector<float> y{};
+			std::vector<float> rotation{};
+			std::vector<float> cos{}; /**< Cosine of rotation, for transforming parts. */
+			std::vector<float> sin{}; /**< Sine of rotation, for transforming parts. */
+		};
+
+		explicit Skeleton(const std::string& filePath);
+		Skeleton(std::vector<Bone> bones, std::vector<Part> parts, std::map<std::string, Animation> animations);
+
+		const std::vector<Bone>& bones() const;
+		const std::vector<Part>& parts() const;
+
+		std::vector<std::string> animationNames() const;
+		AnimationId animationId(const std::string& animationName) const;
+		const Animation& animation(AnimationId animationId) const;
+
+		void pose(AnimationId animationId, unsigned int time, const Transform& root, Pose& pose) const;
+
+	private:
+		void initialize(std::map<std::string, Animation> animations);
+
+		std::vector<Bone> mBones;
+		std::vector<Part> mParts;
+		std::map<std::string, AnimationId> mAnimationIds{};
+		std::vector<Animation> mAnimations{};
+
+		// Bind pose, one array per component, copied into each Pose before animating
+		std::vector<std::size_t> mParents{};
+		std::vector<float> mBindX{};
+		std::vector<float> mBindY{};
+		std::vector<float> mBindRotation{};
+	};
+} // namespace NAS2D
@@ -9,10 +9,13 @@
 // ==================================================================================
 
 #include "Sprite.h"
-#include "ResourceCache.h"
+#include "SpriteCaches.h"
 #include "../Renderer/Renderer.h"
 #include "../Utility.h"
+#include "../WorkerPool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 #include <stdexcept>
 
@@ -24,32 +27,77 @@ namespace
 {
 	using AnimationCache = ResourceCache<AnimationSet, std::string>;
 	AnimationCache animationCache;
+
+	constexpr unsigned int MaxPreloadThreads = 8;
+}
+
+
+namespace NAS2D
+{
+	/**
+	 * Cache of AnimationSets used by Sprites loaded from sprite files.
+	 */
+	ResourceCache<AnimationSet, std::string>& spriteAnimationCache()
+	{
+		return animationCache;
+	}
+}
+
+
+/**
+ * Loads the animation sets of many sprite files on several threads.
+ *
+ * Sprites created afterwards from these files use the loaded animation sets.
+ * Image sheets shared between sprite files are loaded once. Images are only
+ * decoded here, and are uploaded to the GPU by the render thread the first
+ * time they are drawn, so this is safe to call from any thread.
+ *
+ * \throw	The first error encountered, after all threads have finished.
+ */
+void Sprite::preload(const std::vector<std::string>& filePaths)
+{
+	if (filePaths.empty())
+	{
+		return;
+	}
+
+	std::atomic<std::size_t> nextFile{0};
+	WorkerPool workerPool{std::min(WorkerPool::defaultSize(MaxPreloadThreads), static_cast<unsigned int>(filePaths.size()))};
+	workerPool.run([&](unsigned int) {
+		for (auto index = nextFile++; index < filePaths.size(); index = nextFile++)
+		{
+			animationCache.load(filePaths[index]);
+		}
+	});
 }
 
 
 Sprite::Sprite(const std::string& filePath, const std::string& initialAction) :
 	mAnimationSet{animationCache.load(filePath)},
-	mCurrentAction{&mAnimationSet.frames(initialAction)}
+	mCurrentActionId{mAnimationSet.actionId(initialAction)},
+	mCurrentAction{&mAnimationSet.frames(mCurrentActionId)}
 {
 }
 
 
 Sprite::Sprite(const AnimationSet& animationSet, const std::string& initialAction) :
 	mAnimationSet{animationSet},
-	mCurrentAction{&mAnimationSet.frames(initialAction)}
+	mCurrentActionId{mAnimationSet.actionId(initialAction)},
+	mCurrentAction{&mAnimationSet.frames(mCurrentActionId)}
 {
 }
 
 
 Vector<int> Sprite::size() const
 {
-	return (*mCurrentAction)[mCurrentFrame].bounds.size;
+	return (*mCurrentAction)[frameIndex()].size();
 }
 
 
 Point<int> Sprite::origin(Point<int> point) const
 {
-	return point - (*mCurrentAction)[mCurrentFrame].anchorOffset;
+	const auto& frame = (*mCurrentAction)[frameIndex()];
+	return point - (frame.anchorOffset + frame.trimOffset);
 }
 
 
@@ -64,6 +112,17 @@ std::vector<std::string> Sprite::actions() const
 }
 
 
+/**
+ * Resolves the name of an action to an id, for use with play.
+ *
+ * Resolving names once and playing by id avoids string lookups.
+ */
+Sprite::ActionId Sprite::actionId(const std::string& action) const
+{
+	return mAnimationSet.actionId(action);
+}
+
+
 /**
  * Plays an action animation.
  *
@@ -77,6 +136,16 @@ std::vector<std::string> Sprite::actions() const
  */
 void Sprite::play(const std::string& action)
 {
+	play(mAnimationSet.actionId(action));
+}
+
+
+/**
+ * Plays an action animation by id, see actionId.
+ */
+void Sprite::play(ActionId action)
+{
+	mCurrentActionId = action;
 	mCurrentAction = &mAnimationSet.frames(action);
 	mCurrentFrame = 0;
 	mTimer.reset();
@@ -113,16 +182,66 @@ void Sprite::setFrame(std::size_t frameIndex)
 }
 
 
+/**
+ * Shows the frame of the current action at a time since the action started.
+ *
+ * The frame is found directly, without stepping through the frames before
+ * it. Seeking to a time derived from a game clock each frame, instead of
+ * calling update, gives deterministic playback that can be replayed or time
+ * scaled, and hidden sprites need no updates at all.
+ *
+ * \note	Animation complete signals are not emitted when seeking.
+ *
+ * \param	actionTime	Time in milliseconds since the action started.
+ */
+void Sprite::seek(unsigned int actionTime)
+{
+	const auto result = mAnimationSet.advance(mCurrentActionId, 0, actionTime);
+	mCurrentFrame = result.frameIndex;
+	mPaused = result.stopped;
+	mTimer = Timer{Timer::tick() - (actionTime - result.elapsed)};
+}
+
+
+/**
+ * Sets whether the Sprite is dormant, such as while it is outside the view.
+ *
+ * Dormant sprites are not advanced by update unless an animation complete
+ * handler is connected. Time keeps accumulating, and the frame for that time
+ * is found when the Sprite is drawn or woken, so skipped updates do not
+ * change what is shown.
+ */
+void Sprite::dormant(bool isDormant)
+{
+	mDormant = isDormant;
+	if (!mDormant)
+	{
+		update();
+	}
+}
+
+
+bool Sprite::dormant() const
+{
+	return mDormant;
+}
+
+
 void Sprite::update()
 {
+	if (mDormant && mAnimationCompleteSignal.empty())
+	{
+		return;
+	}
+
 	mTimer.adjustStartTick(advanceByTimeDelta(mTimer.elapsedTicks()));
 }
 
 
 void Sprite::draw(Point<float> position) const
 {
-	const auto& frame = (*mCurrentAction)[mCurrentFrame];
-	const auto drawPosition = position - frame.anchorOffset.to<float>();
+	const auto& frame = (*mCurrentAction)[frameIndex()];
+	const auto drawPosition = frame.drawPosition(position, mRotationAngleDegrees);
 	const auto frameBounds = frame.bounds.to<float>();
 	Utility<Renderer>::get().drawSubImageRotated(frame.image, drawPosition, frameBounds, mRotationAngleDegrees, mTintColor);
 }
@@ -196,36 +315,35 @@ Sprite::AnimationCompleteSignal::Source& Sprite::animationCompleteSignalSource()
 
 unsigned int Sprite::advanceByTimeDelta(unsigned int timeDelta)
 {
-	unsigned int accumulator = 0;
-
 	if (mPaused)
 	{
-		return accumulator;
+		return 0;
 	}
 
-	const auto& frames = *mCurrentAction;
-	for (;;)
-	{
-		const auto& frame = frames[mCurrentFrame];
+	// The action may have fewer frames since its AnimationSet was reloaded
+	mCurrentFrame = std::min(mCurrentFrame, mCurrentAction->size() - 1);
+	const auto result = mAnimationSet.advance(mCurrentActionId, mCurrentFrame, timeDelta);
+	mCurrentFrame = result.frameIndex;
+	mPaused = result.stopped;
 
-		if (frame.isStopFrame())
-		{
-			mAnimationCompleteSignal();
-			mPaused = true;
-			return accumulator;
-		}
+	// Playback state is updated first, so handlers are free to play another action
+	for (unsigned int i = 0; i < result.completions; ++i)
+	{
+		mAnimationCompleteSignal();
+	}
+	return result.elapsed;
+}
 
-		if (timeDelta - accumulator < frame.frameDelay)
-		{
-			return accumulator;
-		}
 
-		accumulator += frame.frameDelay;
-		mCurrentFrame++;
-		if (mCurrentFrame >= frames.size())
-		{
-			mCurrentFrame = 0;
-			mAnimationCompleteSignal();
-		}
+/**
+ * Index of the frame to show, including time not yet applied while dormant.
+ */
+std::size_t Sprite::frameIndex() const
+{
+	const auto currentFrame = std::min(mCurrentFrame, mCurrentAction->size() - 1);
+	if (!mDormant || mPaused)
+	{
+		return currentFrame;
 	}
+	return mAnimationSet.advance(mCurrentActionId, currentFrame, mTimer.elapsedTicks()).frameIndex;
 }
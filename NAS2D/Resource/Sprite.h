@@ -26,11 +26,17 @@ namespace NAS2D
 	 *
 	 * The Sprite Class is a self-contained group of Image resources that displays
 	 * Images at a specified screen coordinate in sequence to display an animation.
+	 *
+	 * Each Sprite keeps its own animation state and Timer. To advance and draw
+	 * many sprites from a single timestamp, use a SpriteSystem instead.
 	 */
 	class Sprite
 	{
 	public:
 		using AnimationCompleteSignal = Signal<>;
+		using ActionId = AnimationSet::ActionId;
+
+		static void preload(const std::vector<std::string>& filePaths);
 
 		Sprite(const std::string& filePath, const std::string& initialAction);
 		Sprite(const AnimationSet& animationSet, const std::string& initialAction);
@@ -43,12 +49,18 @@ namespace NAS2D
 		Point<int> origin(Point<int> point) const;
 
 		std::vector<std::string> actions() const;
+		ActionId actionId(const std::string& action) const;
 
 		void play(const std::string& action);
+		void play(ActionId action);
 		void pause();
 		void resume();
 
 		void setFrame(std::size_t frameIndex);
+		void seek(unsigned int actionTime);
+
+		void dormant(bool isDormant);
+		bool dormant() const;
 
 		void update();
 		void draw(Point<float> position) const;
@@ -67,11 +79,15 @@ namespace NAS2D
 		unsigned int advanceByTimeDelta(unsigned int timeDelta);
 
 	private:
+		std::size_t frameIndex() const;
+
 		const AnimationSet& mAnimationSet;
+		ActionId mCurrentActionId;
 		const std::vector<AnimationSet::Frame>* mCurrentAction{nullptr};
 		std::size_t mCurrentFrame{0};
 
 		bool mPaused{false};
+		bool mDormant{false};
 		Timer mTimer{};
 		AnimationCompleteSignal mAnimationCompleteSignal{};
 
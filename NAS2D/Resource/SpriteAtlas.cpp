@@ -0,0 +1,166 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "SpriteAtlas.h"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	// Keeps linear filtering from blending in pixels of neighbouring frames
+	constexpr int FramePadding = 1;
+}
+
+
+/**
+ * \param	pageSize	Size of each texture page in pixels.
+ * \param	filter		Texture sampling mode used when the pages are drawn.
+ */
+SpriteAtlas::SpriteAtlas(Vector<int> pageSize, TextureFilter filter) :
+	mPageSize{pageSize},
+	mFilter{filter}
+{
+	if (mPageSize.x <= 0 || mPageSize.y <= 0)
+	{
+		throw std::runtime_error("SpriteAtlas page size must be positive: {" + std::to_string(mPageSize.x) + ", " + std::to_string(mPageSize.y) + "}");
+	}
+}
+
+
+/**
+ * Copies frames of an image sheet into the atlas.
+ *
+ * Transparent borders of each frame are trimmed before packing. Frames with
+ * the same bounds are packed once. Fully transparent frames get an empty
+ * region.
+ *
+ * \param	imageSheet		Image the frames are taken from. Not referenced afterwards.
+ * \param	frameBounds		Area of each frame within the image sheet.
+ * \return	Region of each frame, in the same order as frameBounds.
+ */
+std::vector<SpriteAtlas::Region> SpriteAtlas::add(const Image& imageSheet, const std::vector<Rectangle<int>>& frameBounds)
+{
+	const auto sheetRect = Rectangle{{0, 0}, imageSheet.size()};
+	for (const auto& bounds : frameBounds)
+	{
+		if (!sheetRect.contains(bounds))
+		{
+			throw std::runtime_error("SpriteAtlas frame bounds exceeds image sheet bounds");
+		}
+	}
+
+	// Pages hold 32-bit RGBA pixels, so other formats are converted once for all frames
+	auto* surface = imageSheet.mSurface;
+	std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> convertedSurface{nullptr, SDL_FreeSurface};
+	if (surface->format->format != SDL_PIXELFORMAT_RGBA32)
+	{
+		convertedSurface.reset(SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0));
+		if (!convertedSurface)
+		{
+			throw std::runtime_error("SpriteAtlas failed to convert image sheet: " + std::string{SDL_GetError()});
+		}
+	}
+	const auto* rgbaSurface = convertedSurface ? convertedSurface.get() : surface;
+
+	std::vector<Region> regions;
+	regions.reserve(frameBounds.size());
+	std::map<std::tuple<int, int, int, int>, std::size_t> packedFrames;
+	for (const auto& bounds : frameBounds)
+	{
+		const auto key = std::tuple{bounds.position.x, bounds.position.y, bounds.size.x, bounds.size.y};
+		if (const auto packed = packedFrames.find(key); packed != packedFrames.end())
+		{
+			regions.push_back(regions[packed->second]);
+			continue;
+		}
+		packedFrames.try_emplace(key, regions.size());
+
+		const auto trimmed = imageSheet.opaqueBounds(bounds);
+		if (trimmed.empty())
+		{
+			if (mPages.empty())
+			{
+				addPage(mPageSize);
+			}
+			regions.push_back({*mPages.front().image, {{0, 0}, {0, 0}}, {0, 0}, bounds.size});
+			continue;
+		}
+
+		Point<int> position;
+		const auto& page = mPages[allocate(trimmed.size, position)];
+		const auto* pixels = static_cast<const std::uint8_t*>(rgbaSurface->pixels) + trimmed.position.y * rgbaSurface->pitch + trimmed.position.x * 4;
+		page.image->update({position, trimmed.size}, pixels, rgbaSurface->pitch);
+		regions.push_back({*page.image, {position, trimmed.size}, trimmed.position - bounds.position, bounds.endPoint() - trimmed.endPoint()});
+	}
+
+	return regions;
+}
+
+
+Vector<int> SpriteAtlas::pageSize() const
+{
+	return mPageSize;
+}
+
+
+std::size_t SpriteAtlas::pageCount() const
+{
+	return mPages.size();
+}
+
+
+const Image& SpriteAtlas::page(std::size_t pageIndex) const
+{
+	if (pageIndex >= mPages.size())
+	{
+		throw std::runtime_error("SpriteAtlas page index out of range: " + std::to_string(pageIndex));
+	}
+	return *mPages[pageIndex].image;
+}
+
+
+/**
+ * Finds space for a frame, adding a page if no page has room for it.
+ *
+ * \return	Index of the page the frame was placed on.
+ */
+std::size_t SpriteAtlas::allocate(Vector<int> size, Point<int>& position)
+{
+	for (std::size_t pageIndex = 0; pageIndex < mPages.size(); ++pageIndex)
+	{
+		if (const auto packedPosition = mPages[pageIndex].packer.insert(size))
+		{
+			position = *packedPosition;
+			return pageIndex;
+		}
+	}
+
+	// Frames larger than the page size get a page of their own
+	const auto paddedSize = size + Vector{FramePadding, FramePadding};
+	addPage({std::max(mPageSize.x, paddedSize.x), std::max(mPageSize.y, paddedSize.y)});
+	position = *mPages.back().packer.insert(size);
+	return mPages.size() - 1;
+}
+
+
+void SpriteAtlas::addPage(Vector<int> size)
+{
+	mPages.push_back(Page{std::make_unique<DynamicImage>(size, mFilter), ShelfPacker{size, FramePadding}});
+}
@@ -0,0 +1,75 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "DynamicImage.h"
+
+#include "../Math/Rectangle.h"
+#include "../Math/ShelfPacker.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Packs sprite frames from many image sheets into shared texture pages.
+	 *
+	 * Frames are copied out of their image sheet with their transparent
+	 * borders trimmed, and placed on the first page with room for them. Sprites
+	 * whose frames share a page are drawn from the same texture, so many
+	 * sprites with different image sheets can be drawn without texture
+	 * switches. A new page is added when no page has room, and frames larger
+	 * than a page get a page of their own.
+	 *
+	 * \note	Pages are kept for the lifetime of the atlas, which must outlive
+	 *			any AnimationSet packed into it.
+	 */
+	class SpriteAtlas
+	{
+	public:
+		/**
+		 * Location of a packed frame, see SpriteAtlas::add.
+		 */
+		struct Region
+		{
+			const Image& image;
+			Rectangle<int> bounds;
+			Vector<int> trimOffset; /**< Position of the trimmed bounds within the frame. */
+			Vector<int> trimMargin; /**< Size trimmed from the right and bottom of the frame. */
+		};
+
+		explicit SpriteAtlas(Vector<int> pageSize = {2048, 2048}, TextureFilter filter = TextureFilter::Linear);
+		SpriteAtlas(const SpriteAtlas&) = delete;
+		SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+		std::vector<Region> add(const Image& imageSheet, const std::vector<Rectangle<int>>& frameBounds);
+
+		Vector<int> pageSize() const;
+		std::size_t pageCount() const;
+		const Image& page(std::size_t pageIndex) const;
+
+	private:
+		struct Page
+		{
+			std::unique_ptr<DynamicImage> image;
+			ShelfPacker packer;
+		};
+
+		std::size_t allocate(Vector<int> size, Point<int>& position);
+		void addPage(Vector<int> size);
+
+		Vector<int> mPageSize;
+		TextureFilter mFilter;
+		std::vector<Page> mPages{};
+	};
+} // namespace NAS2D
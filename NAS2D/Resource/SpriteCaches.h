@@ -0,0 +1,25 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "ResourceCache.h"
+
+#include <string>
+
+
+namespace NAS2D
+{
+	class AnimationSet;
+	class Image;
+
+
+	ResourceCache<Image, std::string>& spriteImageCache();
+	ResourceCache<AnimationSet, std::string>& spriteAnimationCache();
+} // namespace NAS2D
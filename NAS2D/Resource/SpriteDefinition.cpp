@@ -0,0 +1,351 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "SpriteDefinition.h"
+#include "BinaryData.h"
+
+#include "../ParserHelper.h"
+#include "../Version.h"
+#include "../Xml/Xml.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+
+using namespace NAS2D;
+
+
+// Compiled sprite file layout. All integers are 32 bit little endian, and
+// strings are stored as their length followed by their bytes.
+//
+// - Magic bytes "NAS2DSPR", format version
+// - Number of image sheets, then for each: id, path
+// - Number of actions, then for each:
+//   - Name, number of frames
+//   - Frames: sheet index, x, y, width, height, anchor x, anchor y, delay
+namespace
+{
+	constexpr std::string_view SPRITE_VERSION{"0.99"};
+	constexpr std::string_view Magic{"NAS2DSPR"};
+	constexpr std::string_view DataName{"Compiled sprite file"};
+	constexpr std::string_view CompiledExtension{".bin"};
+	constexpr std::uint32_t FormatVersion = 1;
+	// Minimum field counts, used to reject corrupt counts before allocating
+	constexpr std::size_t ImageSheetFieldCount = 2;
+	constexpr std::size_t ActionFieldCount = 2;
+	constexpr std::size_t FrameFieldCount = 8;
+
+
+	// Adds a row tag to the end of messages.
+	std::string endTag(int row)
+	{
+		return " (Row: " + std::to_string(row) + ")";
+	}
+
+
+	std::vector<SpriteDefinition::ImageSheet> processImageSheets(const Xml::XmlElement* element);
+	std::vector<SpriteDefinition::Action> processActions(const std::vector<SpriteDefinition::ImageSheet>& imageSheets, const Xml::XmlElement* element);
+	std::vector<SpriteDefinition::Frame> processFrames(const std::vector<SpriteDefinition::ImageSheet>& imageSheets, const Xml::XmlElement* element);
+}
+
+
+namespace NAS2D
+{
+	/**
+	 * Parses the contents of a sprite XML definition file.
+	 *
+	 * \throw	std::runtime_error if the definition is malformed.
+	 */
+	SpriteDefinition parseSpriteXml(const std::string& xmlData)
+	{
+		Xml::XmlDocument xmlDoc;
+		xmlDoc.parse(xmlData.c_str());
+
+		if (xmlDoc.error())
+		{
+			throw std::runtime_error("Sprite file has malformed XML: Row: " + std::to_string(xmlDoc.errorRow()) + " Column: " + std::to_string(xmlDoc.errorCol()) + " : " + xmlDoc.errorDesc());
+		}
+
+		// Find the Sprite node.
+		const auto* xmlRootElement = xmlDoc.firstChildElement("sprite");
+		if (!xmlRootElement)
+		{
+			throw std::runtime_error("Sprite file does not contain required <sprite> tag");
+		}
+
+		// Get the Sprite version.
+		const auto version = xmlRootElement->attribute("version");
+		if (version.empty())
+		{
+			throw std::runtime_error("Sprite file's root element does not specify a version");
+		}
+		if (version != SPRITE_VERSION)
+		{
+			throw std::runtime_error("Sprite version mismatch. Expected: " + std::string{SPRITE_VERSION} + " Actual: " + versionString());
+		}
+
+		// Note:
+		// Here instead of going through each element and calling a processing function to handle
+		// it, we just iterate through all nodes to find sprite sheets. This allows us to define
+		// image sheets anywhere in the sprite file.
+		SpriteDefinition definition;
+		definition.imageSheets = processImageSheets(xmlRootElement);
+		definition.actions = processActions(definition.imageSheets, xmlRootElement);
+		return definition;
+	}
+
+
+	/**
+	 * Gets the path of the compiled sprite file for a sprite XML definition file.
+	 */
+	std::string compiledSpritePath(std::string_view spritePath)
+	{
+		return std::string{spritePath} + std::string{CompiledExtension};
+	}
+
+
+	/**
+	 * Checks if file contents start with the signature of a compiled sprite file.
+	 */
+	bool isCompiledSpriteFile(std::string_view fileData)
+	{
+		return fileData.substr(0, Magic.size()) == Magic;
+	}
+
+
+	/**
+	 * Creates the contents of a compiled sprite file.
+	 */
+	std::string writeCompiledSpriteFile(const SpriteDefinition& definition)
+	{
+		std::string output;
+		BinaryWriter writer{output};
+		writer.writeBytes(Magic);
+		writer.writeUint32(FormatVersion);
+
+		writer.writeUint32(static_cast<std::uint32_t>(definition.imageSheets.size()));
+		for (const auto& imageSheet : definition.imageSheets)
+		{
+			writer.writeString(imageSheet.id);
+			writer.writeString(imageSheet.path);
+		}
+
+		writer.writeUint32(static_cast<std::uint32_t>(definition.actions.size()));
+		for (const auto& action : definition.actions)
+		{
+			writer.writeString(action.name);
+			writer.writeUint32(static_cast<std::uint32_t>(action.frames.size()));
+			for (const auto& frame : action.frames)
+			{
+				writer.writeUint32(frame.sheetIndex);
+				for (const auto value : {frame.bounds.position.x, frame.bounds.position.y, frame.bounds.size.x, frame.bounds.size.y, frame.anchorOffset.x, frame.anchorOffset.y})
+				{
+					writer.writeInt32(value);
+				}
+				writer.writeUint32(frame.frameDelay);
+			}
+		}
+
+		return output;
+	}
+
+
+	/**
+	 * Reads the contents of a compiled sprite file.
+	 *
+	 * \throw	std::runtime_error if the file is malformed.
+	 */
+	SpriteDefinition readCompiledSpriteFile(std::string_view fileData)
+	{
+		if (!isCompiledSpriteFile(fileData))
+		{
+			throw std::runtime_error("Not a compiled sprite file");
+		}
+
+		BinaryReader reader{fileData, std::string{DataName}};
+		reader.readBytes(Magic.size());
+		const auto version = reader.readUint32();
+		if (version != FormatVersion)
+		{
+			throw std::runtime_error("Unsupported compiled sprite file version: " + std::to_string(version));
+		}
+
+		SpriteDefinition definition;
+		const auto imageSheetCount = reader.readUint32();
+		reader.expectRemaining(imageSheetCount, ImageSheetFieldCount * BinaryWriter::FieldSize);
+		definition.imageSheets.resize(imageSheetCount);
+		for (auto& imageSheet : definition.imageSheets)
+		{
+			imageSheet.id = reader.readString();
+			imageSheet.path = reader.readString();
+		}
+
+		const auto actionCount = reader.readUint32();
+		reader.expectRemaining(actionCount, ActionFieldCount * BinaryWriter::FieldSize);
+		definition.actions.resize(actionCount);
+		for (auto actionIter = definition.actions.begin(); actionIter != definition.actions.end(); ++actionIter)
+		{
+			auto& action = *actionIter;
+			action.name = reader.readString();
+			const auto isSameName = [&action](const auto& existingAction) { return existingAction.name == action.name; };
+			if (std::any_of(definition.actions.begin(), actionIter, isSameName))
+			{
+				throw std::runtime_error("Compiled sprite action redefinition: '" + action.name + "'");
+			}
+
+			const auto frameCount = reader.readUint32();
+			if (frameCount == 0)
+			{
+				throw std::runtime_error("Compiled sprite action has no frames: '" + action.name + "'");
+			}
+			reader.expectRemaining(frameCount, FrameFieldCount * BinaryWriter::FieldSize);
+			action.frames.resize(frameCount);
+			for (auto& frame : action.frames)
+			{
+				frame.sheetIndex = reader.readUint32();
+				if (frame.sheetIndex >= definition.imageSheets.size())
+				{
+					throw std::runtime_error("Compiled sprite frame references undefined imagesheet: " + std::to_string(frame.sheetIndex));
+				}
+				frame.bounds.position.x = reader.readInt32();
+				frame.bounds.position.y = reader.readInt32();
+				frame.bounds.size.x = reader.readInt32();
+				frame.bounds.size.y = reader.readInt32();
+				frame.anchorOffset.x = reader.readInt32();
+				frame.anchorOffset.y = reader.readInt32();
+				frame.frameDelay = reader.readUint32();
+			}
+		}
+
+		reader.expectEnd();
+		return definition;
+	}
+}
+
+
+namespace
+{
+	/**
+	 * Iterates through all elements of a Sprite XML definition looking
+	 * for 'imagesheet' elements and processes them.
+	 *
+	 * \note	Since 'imagesheet' elements are processed before any other
+	 *			element in a sprite definition, these elements can appear
+	 *			anywhere in a Sprite XML definition.
+	 */
+	std::vector<SpriteDefinition::ImageSheet> processImageSheets(const Xml::XmlElement* element)
+	{
+		std::vector<SpriteDefinition::ImageSheet> imageSheets;
+
+		for (const auto* node = element->firstChildElement("imagesheet"); node; node = node->nextSiblingElement("imagesheet"))
+		{
+			const auto dictionary = attributesToDictionary(*node);
+			const auto id = dictionary.get("id");
+			const auto src = dictionary.get("src");
+
+			if (id.empty())
+			{
+				throw std::runtime_error("Sprite imagesheet definition has `id` of length zero: " + endTag(node->row()));
+			}
+
+			if (src.empty())
+			{
+				throw std::runtime_error("Sprite imagesheet definition has `src` of length zero: " + endTag(node->row()));
+			}
+
+			const auto isSameId = [&id](const auto& imageSheet) { return imageSheet.id == id; };
+			if (std::any_of(imageSheets.begin(), imageSheets.end(), isSameId))
+			{
+				throw std::runtime_error("Sprite image sheet redefinition: id: '" + id + "' " + endTag(node->row()));
+			}
+
+			imageSheets.push_back({id, src});
+		}
+
+		return imageSheets;
+	}
+
+
+	/**
+	 * Iterates through all elements of a Sprite XML definition looking
+	 * for 'action' elements and processes them.
+	 */
+	std::vector<SpriteDefinition::Action> processActions(const std::vector<SpriteDefinition::ImageSheet>& imageSheets, const Xml::XmlElement* element)
+	{
+		std::vector<SpriteDefinition::Action> actions;
+
+		for (const auto* action = element->firstChildElement("action"); action; action = action->nextSiblingElement("action"))
+		{
+			const auto dictionary = attributesToDictionary(*action);
+			const auto actionName = dictionary.get("name");
+
+			if (actionName.empty())
+			{
+				throw std::runtime_error("Sprite Action definition has 'name' of length zero: " + endTag(action->row()));
+			}
+			const auto isSameName = [&actionName](const auto& existingAction) { return existingAction.name == actionName; };
+			if (std::any_of(actions.begin(), actions.end(), isSameName))
+			{
+				throw std::runtime_error("Sprite Action redefinition: '" + actionName + "' " + endTag(action->row()));
+			}
+
+			actions.push_back({actionName, processFrames(imageSheets, action)});
+
+			if (actions.back().frames.empty())
+			{
+				throw std::runtime_error("Sprite Action contains no valid frames: " + actionName);
+			}
+		}
+
+		return actions;
+	}
+
+
+	/**
+	 * Parses through all <frame> tags within an <action> tag in a Sprite Definition.
+	 */
+	std::vector<SpriteDefinition::Frame> processFrames(const std::vector<SpriteDefinition::ImageSheet>& imageSheets, const Xml::XmlElement* element)
+	{
+		std::vector<SpriteDefinition::Frame> frameList;
+
+		for (const auto* frame = element->firstChildElement("frame"); frame; frame = frame->nextSiblingElement("frame"))
+		{
+			int currentRow = frame->row();
+
+			const auto dictionary = attributesToDictionary(*frame);
+			reportMissingOrUnexpected(dictionary.keys(), {"sheetid", "x", "y", "width", "height", "anchorx", "anchory"}, {"delay"});
+
+			const auto sheetId = dictionary.get("sheetid");
+			const auto delay = dictionary.get<unsigned int>("delay", 0);
+			const auto x = dictionary.get<int>("x");
+			const auto y = dictionary.get<int>("y");
+			const auto width = dictionary.get<int>("width");
+			const auto height = dictionary.get<int>("height");
+			const auto anchorx = dictionary.get<int>("anchorx");
+			const auto anchory = dictionary.get<int>("anchory");
+
+			if (sheetId.empty())
+			{
+				throw std::runtime_error("Sprite Frame definition has 'sheetid' of length zero: " + endTag(currentRow));
+			}
+			const auto isSameId = [&sheetId](const auto& imageSheet) { return imageSheet.id == sheetId; };
+			const auto iterator = std::find_if(imageSheets.begin(), imageSheets.end(), isSameId);
+			if (iterator == imageSheets.end())
+			{
+				throw std::runtime_error("Sprite Frame definition references undefined imagesheet: '" + sheetId + "' " + endTag(currentRow));
+			}
+
+			const auto sheetIndex = static_cast<std::uint32_t>(iterator - imageSheets.begin());
+			frameList.push_back({sheetIndex, {{x, y}, {width, height}}, {anchorx, anchory}, delay});
+		}
+
+		return frameList;
+	}
+}
@@ -0,0 +1,63 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Math/Rectangle.h"
+#include "../Math/Vector.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Contents of a sprite definition, before any images are loaded.
+	 *
+	 * Parsed from sprite XML files, or read from compiled sprite files, which
+	 * hold the same data in a binary form that loads without any string
+	 * parsing. Sprite files are compiled with the sprite-compiler tool.
+	 */
+	struct SpriteDefinition
+	{
+		struct ImageSheet
+		{
+			std::string id{};
+			std::string path{}; /**< Relative to the sprite file. */
+		};
+
+		struct Frame
+		{
+			std::uint32_t sheetIndex{0};
+			Rectangle<int> bounds{};
+			Vector<int> anchorOffset{0, 0};
+			unsigned int frameDelay{0};
+		};
+
+		struct Action
+		{
+			std::string name{};
+			std::vector<Frame> frames{};
+		};
+
+		std::vector<ImageSheet> imageSheets{};
+		std::vector<Action> actions{};
+	};
+
+
+	SpriteDefinition parseSpriteXml(const std::string& xmlData);
+
+	std::string compiledSpritePath(std::string_view spritePath);
+	bool isCompiledSpriteFile(std::string_view fileData);
+	std::string writeCompiledSpriteFile(const SpriteDefinition& definition);
+	SpriteDefinition readCompiledSpriteFile(std::string_view fileData);
+} // namespace NAS2D
@@ -0,0 +1,561 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "SpriteSystem.h"
+
+#include "../Utility.h"
+#include "../WorkerPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	// Waking threads costs more than advancing small numbers of sprites
+	constexpr std::size_t MinSpritesPerThread = 8192;
+	constexpr unsigned int MaxUpdateThreads = 8;
+}
+
+
+SpriteSystem::SpriteSystem() = default;
+
+
+SpriteSystem::~SpriteSystem() = default;
+
+
+/**
+ * Adds a sprite, playing an action from its first frame.
+ *
+ * \return	Id of the new sprite.
+ */
+SpriteSystem::Id SpriteSystem::add(const AnimationSet& animationSet, const std::string& initialAction, Point<float> position)
+{
+	const auto actionId = animationSet.actionId(initialAction);
+	const auto& frames = animationSet.frames(actionId);
+	const auto id = allocateId();
+
+	mAnimationSets.push_back(&animationSet);
+	mActionIds.push_back(actionId);
+	mActions.push_back(&frames);
+	mFrameIndices.push_back(0);
+	mFrameTimes.push_back(0);
+	mPaused.push_back(false);
+	mDormant.push_back(false);
+	mPositions.push_back(position);
+	mRotations.push_back(0.0f);
+	mColors.push_back(Color::Normal);
+	mIds.push_back(id);
+
+	return id;
+}
+
+
+/**
+ * Adds a sprite with the same animation state, position, rotation and color as another.
+ *
+ * \return	Id of the new sprite.
+ */
+SpriteSystem::Id SpriteSystem::copy(Id id)
+{
+	const auto index = indexOf(id);
+	const auto copyId = allocateId();
+
+	mAnimationSets.push_back(mAnimationSets[index]);
+	mActionIds.push_back(mActionIds[index]);
+	mActions.push_back(mActions[index]);
+	mFrameIndices.push_back(mFrameIndices[index]);
+	mFrameTimes.push_back(mFrameTimes[index]);
+	mPaused.push_back(mPaused[index]);
+	mDormant.push_back(mDormant[index]);
+	mPositions.push_back(mPositions[index]);
+	mRotations.push_back(mRotations[index]);
+	mColors.push_back(mColors[index]);
+	mIds.push_back(copyId);
+
+	return copyId;
+}
+
+
+/**
+ * Removes a sprite. Its id may be reused by sprites added afterwards.
+ */
+void SpriteSystem::remove(Id id)
+{
+	const auto index = indexOf(id);
+	const auto last = mIds.size() - 1;
+
+	// Move the last sprite into the hole to keep the arrays dense
+	mAnimationSets[index] = mAnimationSets[last];
+	mActionIds[index] = mActionIds[last];
+	mActions[index] = mActions[last];
+	mFrameIndices[index] = mFrameIndices[last];
+	mFrameTimes[index] = mFrameTimes[last];
+	mPaused[index] = mPaused[last];
+	mDormant[index] = mDormant[last];
+	mPositions[index] = mPositions[last];
+	mRotations[index] = mRotations[last];
+	mColors[index] = mColors[last];
+	mIds[index] = mIds[last];
+	mIndices[mIds[index]] = index;
+
+	mAnimationSets.pop_back();
+	mActionIds.pop_back();
+	mActions.pop_back();
+	mFrameIndices.pop_back();
+	mFrameTimes.pop_back();
+	mPaused.pop_back();
+	mDormant.pop_back();
+	mPositions.pop_back();
+	mRotations.pop_back();
+	mColors.pop_back();
+	mIds.pop_back();
+
+	mIndices[id] = InvalidId;
+	mFreeIds.push_back(id);
+}
+
+
+bool SpriteSystem::contains(Id id) const
+{
+	return id < mIndices.size() && mIndices[id] != InvalidId;
+}
+
+
+std::size_t SpriteSystem::count() const
+{
+	return mIds.size();
+}
+
+
+/**
+ * Plays an action animation from its first frame.
+ */
+void SpriteSystem::play(Id id, const std::string& action)
+{
+	play(id, mAnimationSets[indexOf(id)]->actionId(action));
+}
+
+
+/**
+ * Plays an action animation by id, see AnimationSet::actionId.
+ */
+void SpriteSystem::play(Id id, AnimationSet::ActionId action)
+{
+	const auto index = indexOf(id);
+	mActionIds[index] = action;
+	mActions[index] = &mAnimationSets[index]->frames(action);
+	mFrameIndices[index] = 0;
+	mFrameTimes[index] = 0;
+	mPaused[index] = false;
+}
+
+
+void SpriteSystem::pause(Id id)
+{
+	mPaused[indexOf(id)] = true;
+}
+
+
+void SpriteSystem::resume(Id id)
+{
+	mPaused[indexOf(id)] = false;
+}
+
+
+bool SpriteSystem::isPaused(Id id) const
+{
+	return mPaused[indexOf(id)];
+}
+
+
+const AnimationSet& SpriteSystem::animationSet(Id id) const
+{
+	return *mAnimationSets[indexOf(id)];
+}
+
+
+AnimationSet::ActionId SpriteSystem::action(Id id) const
+{
+	return mActionIds[indexOf(id)];
+}
+
+
+/**
+ * Sets whether a sprite is dormant. Waking a sprite finds its current frame,
+ * which may emit animation complete signals.
+ */
+void SpriteSystem::dormant(Id id, bool isDormant)
+{
+	const auto index = indexOf(id);
+	if (isDormant)
+	{
+		mDormant[index] = true;
+		return;
+	}
+
+	std::vector<std::vector<AnimationComplete>> completions(1);
+	wake(index, completions.front());
+	emitCompletions(completions);
+}
+
+
+bool SpriteSystem::dormant(Id id) const
+{
+	return mDormant[indexOf(id)];
+}
+
+
+/**
+ * Makes sprites outside a view dormant, and wakes sprites inside it.
+ *
+ * A sprite is inside the view if the bounds of its current frame overlap it.
+ * Bounds of rotated sprites are enlarged to cover any rotation.
+ *
+ * \param	viewRect	Visible area, in the same coordinates as sprite positions.
+ */
+void SpriteSystem::cull(const Rectangle<float>& viewRect)
+{
+	std::vector<std::vector<AnimationComplete>> completions(1);
+	for (std::size_t index = 0; index < mIds.size(); ++index)
+	{
+		const auto& frame = (*mActions[index])[frameIndex(index)];
+		auto bounds = Rectangle<float>{mPositions[index] - frame.anchorOffset.to<float>(), frame.bounds.size.to<float>()};
+		if (mRotations[index] != 0.0f)
+		{
+			// Rotation is about the center of the whole frame, and stays within a square as wide as width plus height
+			const auto frameSize = frame.size().to<float>();
+			const auto extent = frameSize.x + frameSize.y;
+			const auto frameCenter = bounds.position - frame.trimOffset.to<float>() + frameSize / 2;
+			bounds = {frameCenter - Vector<float>{extent, extent} / 2, {extent, extent}};
+		}
+
+		if (!viewRect.overlaps(bounds))
+		{
+			mDormant[index] = true;
+		}
+		else if (mDormant[index])
+		{
+			wake(index, completions.front());
+		}
+	}
+	emitCompletions(completions);
+}
+
+
+void SpriteSystem::setFrame(Id id, std::size_t frameIndex)
+{
+	const auto index = indexOf(id);
+	mFrameIndices[index] = frameIndex % mActions[index]->size();
+	mFrameTimes[index] = 0;
+}
+
+
+/**
+ * Shows the frame of the current action at a time since the action started.
+ *
+ * \see Sprite::seek
+ */
+void SpriteSystem::seek(Id id, unsigned int actionTime)
+{
+	const auto index = indexOf(id);
+	const auto result = mAnimationSets[index]->advance(mActionIds[index], 0, actionTime);
+	mFrameIndices[index] = result.frameIndex;
+	mFrameTimes[index] = result.stopped ? 0 : actionTime - result.elapsed;
+	mPaused[index] = result.stopped;
+}
+
+
+/**
+ * Advances one sprite by the time since the start of its current frame.
+ *
+ * For callers which keep time for a sprite themselves, such as Sprite.
+ * Unlike update, time already spent on the frame is replaced rather than
+ * added to, time left over is not kept, and animation complete signals are
+ * not emitted. Paused sprites are advanced too.
+ *
+ * \return	Playback position reached, including completions to signal.
+ */
+AnimationSet::Advance SpriteSystem::advance(Id id, unsigned int frameTime)
+{
+	const auto index = indexOf(id);
+	mFrameIndices[index] = std::min(mFrameIndices[index], mActions[index]->size() - 1);
+	const auto result = mAnimationSets[index]->advance(mActionIds[index], mFrameIndices[index], frameTime);
+	mFrameIndices[index] = result.frameIndex;
+	mFrameTimes[index] = 0;
+	mPaused[index] = result.stopped;
+	return result;
+}
+
+
+std::size_t SpriteSystem::frame(Id id) const
+{
+	return frameIndex(indexOf(id));
+}
+
+
+Vector<int> SpriteSystem::size(Id id) const
+{
+	const auto index = indexOf(id);
+	return (*mActions[index])[frameIndex(index)].size();
+}
+
+
+/**
+ * Sets the position of the sprite's anchor point.
+ */
+void SpriteSystem::position(Id id, Point<float> position)
+{
+	mPositions[indexOf(id)] = position;
+}
+
+
+Point<float> SpriteSystem::position(Id id) const
+{
+	return mPositions[indexOf(id)];
+}
+
+
+/**
+ * Sets the rotation angle of the sprite in degrees.
+ */
+void SpriteSystem::rotation(Id id, float angle)
+{
+	mRotations[indexOf(id)] = angle;
+}
+
+
+float SpriteSystem::rotation(Id id) const
+{
+	return mRotations[indexOf(id)];
+}
+
+
+void SpriteSystem::color(Id id, Color color)
+{
+	mColors[indexOf(id)] = color;
+}
+
+
+Color SpriteSystem::color(Id id) const
+{
+	return mColors[indexOf(id)];
+}
+
+
+/**
+ * Advances the animation of all sprites to a timestamp.
+ *
+ * The first call only records the timestamp. Animation complete signals are
+ * emitted after all sprites have been advanced, on the calling thread.
+ *
+ * \param	timestamp	Time in milliseconds, such as from Timer::tick or a game clock.
+ */
+void SpriteSystem::update(unsigned int timestamp)
+{
+	const auto timeDelta = mHasTimestamp ? timestamp - mLastTimestamp : 0u;
+	mHasTimestamp = true;
+	mLastTimestamp = timestamp;
+
+	const auto spriteCount = mIds.size();
+	const auto threadCount = static_cast<std::size_t>(WorkerPool::defaultSize(MaxUpdateThreads));
+	const auto chunkCount = std::clamp(spriteCount / MinSpritesPerThread, std::size_t{1}, threadCount);
+
+	std::vector<std::vector<AnimationComplete>> completions(chunkCount);
+	if (chunkCount == 1)
+	{
+		advance(0, spriteCount, timeDelta, completions.front());
+	}
+	else
+	{
+		// Threads are only created the first time there are enough sprites, and kept for later updates
+		if (!mWorkers)
+		{
+			mWorkers = std::make_unique<WorkerPool>(static_cast<unsigned int>(threadCount));
+		}
+
+		// Chunks only write their own elements, so no locking is needed
+		const auto chunkSize = (spriteCount + chunkCount - 1) / chunkCount;
+		mWorkers->run([&](unsigned int worker) {
+			const auto first = std::min(worker * chunkSize, spriteCount);
+			const auto last = std::min(first + chunkSize, spriteCount);
+			if (worker < chunkCount)
+			{
+				advance(first, last, timeDelta, completions[worker]);
+			}
+		});
+	}
+
+	emitCompletions(completions);
+}
+
+
+/**
+ * Draws all sprites which are not dormant with their anchor point at their position.
+ *
+ * Consecutive sprites using the same image are drawn as one batch.
+ */
+void SpriteSystem::draw() const
+{
+	auto& renderer = Utility<Renderer>::get();
+
+	const Image* batchImage = nullptr;
+	for (std::size_t index = 0; index < mIds.size(); ++index)
+	{
+		if (mDormant[index])
+		{
+			continue;
+		}
+
+		const auto& frame = (*mActions[index])[frameIndex(index)];
+		if (&frame.image != batchImage)
+		{
+			if (batchImage)
+			{
+				renderer.drawSubImages(*batchImage, mDrawBatch);
+			}
+			mDrawBatch.clear();
+			batchImage = &frame.image;
+		}
+
+		const auto bounds = frame.bounds.to<float>();
+		mDrawBatch.push_back({frame.drawPosition(mPositions[index], mRotations[index]), bounds.position, bounds.size, mRotations[index], mColors[index]});
+	}
+
+	if (batchImage)
+	{
+		renderer.drawSubImages(*batchImage, mDrawBatch);
+	}
+	mDrawBatch.clear();
+}
+
+
+SpriteSystem::AnimationCompleteSignal::Source& SpriteSystem::animationCompleteSignalSource()
+{
+	return mAnimationCompleteSignal;
+}
+
+
+/**
+ * Finds an unused id, and maps it to the index of a sprite about to be added to the end.
+ */
+SpriteSystem::Id SpriteSystem::allocateId()
+{
+	Id id;
+	if (mFreeIds.empty())
+	{
+		id = mIndices.size();
+		mIndices.push_back(0);
+	}
+	else
+	{
+		id = mFreeIds.back();
+		mFreeIds.pop_back();
+	}
+	mIndices[id] = mIds.size();
+	return id;
+}
+
+
+std::size_t SpriteSystem::indexOf(Id id) const
+{
+	if (!contains(id))
+	{
+		throw std::runtime_error("SpriteSystem has no sprite with id: " + std::to_string(id));
+	}
+	return mIndices[id];
+}
+
+
+/**
+ * Index of the frame to show, including time not yet applied while dormant.
+ */
+std::size_t SpriteSystem::frameIndex(std::size_t index) const
+{
+	// The action may have fewer frames since its AnimationSet was reloaded
+	const auto currentFrame = std::min(mFrameIndices[index], mActions[index]->size() - 1);
+	if (!mDormant[index] || mPaused[index])
+	{
+		return currentFrame;
+	}
+	return mAnimationSets[index]->advance(mActionIds[index], currentFrame, mFrameTimes[index]).frameIndex;
+}
+
+
+/**
+ * Clears the dormant flag and applies the time accumulated while dormant.
+ */
+void SpriteSystem::wake(std::size_t index, std::vector<AnimationComplete>& completions)
+{
+	mDormant[index] = false;
+	advance(index, index + 1, 0, completions);
+}
+
+
+/**
+ * Advances the animation of a range of sprites, recording completed animations.
+ *
+ * Dormant sprites only accumulate time, unless a handler needs their signals.
+ */
+void SpriteSystem::advance(std::size_t first, std::size_t last, unsigned int timeDelta, std::vector<AnimationComplete>& completions)
+{
+	const auto advanceDormant = !mAnimationCompleteSignal.empty();
+	for (std::size_t index = first; index < last; ++index)
+	{
+		if (mPaused[index])
+		{
+			continue;
+		}
+
+		if (mDormant[index] && !advanceDormant)
+		{
+			mFrameTimes[index] += timeDelta;
+			continue;
+		}
+
+		mFrameIndices[index] = std::min(mFrameIndices[index], mActions[index]->size() - 1);
+		const auto result = mAnimationSets[index]->advance(mActionIds[index], mFrameIndices[index], mFrameTimes[index] + timeDelta);
+		mFrameIndices[index] = result.frameIndex;
+		mFrameTimes[index] = result.stopped ? 0 : mFrameTimes[index] + timeDelta - result.elapsed;
+		mPaused[index] = result.stopped;
+
+		if (result.completions > 0)
+		{
+			completions.push_back({index, result.completions});
+		}
+	}
+}
+
+
+/**
+ * Emits animation complete signals recorded by advance.
+ */
+void SpriteSystem::emitCompletions(const std::vector<std::vector<AnimationComplete>>& completions)
+{
+	// Ids are looked up first, as handlers may add or remove sprites
+	std::vector<std::pair<Id, unsigned int>> completedIds;
+	for (const auto& chunkCompletions : completions)
+	{
+		for (const auto& completion : chunkCompletions)
+		{
+			completedIds.emplace_back(mIds[completion.index], completion.count);
+		}
+	}
+	for (const auto& [id, count] : completedIds)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			mAnimationCompleteSignal(id);
+		}
+	}
+}
@@ -0,0 +1,144 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "AnimationSet.h"
+#include "../Signal/Signal.h"
+#include "../Renderer/Renderer.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class WorkerPool;
+
+
+	/**
+	 * Animates and draws large numbers of sprites.
+	 *
+	 * Animation state is stored as a structure of arrays, one array per
+	 * property, instead of one object per sprite. All sprites are advanced
+	 * from a single timestamp in a tight loop, split across threads when there
+	 * are enough sprites, and drawn with one Renderer::drawSubImages call per
+	 * run of sprites sharing an image. The threads are created by the first
+	 * update that needs them, and reused by later updates.
+	 *
+	 * Sprites are referred to by an Id, which stays valid until the sprite is
+	 * removed. Removing a sprite moves the last sprite into its place, so the
+	 * draw order of the remaining sprites may change.
+	 *
+	 * Unlike Sprite, paused sprites do not accumulate time, so resuming
+	 * continues from where the animation was paused.
+	 *
+	 * Sprites outside the view can be made dormant, individually or with
+	 * cull. Dormant sprites are not drawn, and while no animation complete
+	 * handler is connected, update only adds the time delta to them. Their
+	 * frame is found when they are woken.
+	 *
+	 * \note	Sprites refer to the AnimationSet they were created with, which
+	 *			must outlive them.
+	 */
+	class SpriteSystem
+	{
+	public:
+		using Id = std::size_t;
+		using AnimationCompleteSignal = Signal<Id>;
+
+		static constexpr Id InvalidId{std::numeric_limits<Id>::max()};
+
+		SpriteSystem();
+		SpriteSystem(const SpriteSystem&) = delete;
+		SpriteSystem& operator=(const SpriteSystem&) = delete;
+		~SpriteSystem();
+
+		Id add(const AnimationSet& animationSet, const std::string& initialAction, Point<float> position = {0, 0});
+		Id copy(Id id);
+		void remove(Id id);
+		bool contains(Id id) const;
+		std::size_t count() const;
+
+		void play(Id id, const std::string& action);
+		void play(Id id, AnimationSet::ActionId action);
+		void pause(Id id);
+		void resume(Id id);
+		bool isPaused(Id id) const;
+
+		const AnimationSet& animationSet(Id id) const;
+		AnimationSet::ActionId action(Id id) const;
+
+		void dormant(Id id, bool isDormant);
+		bool dormant(Id id) const;
+		void cull(const Rectangle<float>& viewRect);
+
+		void setFrame(Id id, std::size_t frameIndex);
+		void seek(Id id, unsigned int actionTime);
+		AnimationSet::Advance advance(Id id, unsigned int frameTime);
+		std::size_t frame(Id id) const;
+		Vector<int> size(Id id) const;
+
+		void position(Id id, Point<float> position);
+		Point<float> position(Id id) const;
+		void rotation(Id id, float angle);
+		float rotation(Id id) const;
+		void color(Id id, Color color);
+		Color color(Id id) const;
+
+		void update(unsigned int timestamp);
+		void draw() const;
+
+		AnimationCompleteSignal::Source& animationCompleteSignalSource();
+
+	private:
+		struct AnimationComplete
+		{
+			std::size_t index;
+			unsigned int count;
+		};
+
+		Id allocateId();
+		std::size_t indexOf(Id id) const;
+		std::size_t frameIndex(std::size_t index) const;
+		void wake(std::size_t index, std::vector<AnimationComplete>& completions);
+		void advance(std::size_t first, std::size_t last, unsigned int timeDelta, std::vector<AnimationComplete>& completions);
+		void emitCompletions(const std::vector<std::vector<AnimationComplete>>& completions);
+
+		// Per sprite state, indexed by dense sprite index
+		std::vector<const AnimationSet*> mAnimationSets{};
+		std::vector<AnimationSet::ActionId> mActionIds{};
+		std::vector<const std::vector<AnimationSet::Frame>*> mActions{};
+		std::vector<std::size_t> mFrameIndices{};
+		std::vector<unsigned int> mFrameTimes{}; /**< Time spent on the current frame. */
+		std::vector<std::uint8_t> mPaused{}; /**< Not std::vector<bool>, so threads can write neighbouring elements. */
+		std::vector<std::uint8_t> mDormant{};
+		std::vector<Point<float>> mPositions{};
+		std::vector<float> mRotations{};
+		std::vector<Color> mColors{};
+		std::vector<Id> mIds{};
+
+		// Maps ids to dense sprite indices
+		std::vector<std::size_t> mIndices{};
+		std::vector<Id> mFreeIds{};
+
+		bool mHasTimestamp{false};
+		unsigned int mLastTimestamp{0};
+		mutable std::vector<SubImageDraw> mDrawBatch{};
+		AnimationCompleteSignal mAnimationCompleteSignal{};
+		std::unique_ptr<WorkerPool> mWorkers{};
+	};
+} // namespace NAS2D
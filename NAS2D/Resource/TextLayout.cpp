@@ -0,0 +1,150 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "TextLayout.h"
+#include "Font.h"
+
+#include "../Utf8Range.h"
+
+#include <algorithm>
+
+
+using namespace NAS2D;
+
+
+/**
+ * Lays out text using the glyph metrics of a Font.
+ *
+ * \param	font		Font the text will be drawn with.
+ * \param	text		UTF-8 encoded text.
+ * \param	maxWidth	Width in pixels at which lines are wrapped. Lines are not wrapped if 0.
+ * \param	alignment	Horizontal alignment of each line.
+ */
+TextLayout::TextLayout(const Font& font, std::string_view text, int maxWidth, TextAlignment alignment) :
+	mFont{&font}
+{
+	mGlyphs.reserve(text.size());
+
+	int penX = 0;
+	std::size_t lineStart = 0;
+	std::size_t breakGlyph = 0;
+	char32_t previous = 0;
+	for (const auto codepoint : Utf8Range{text})
+	{
+		if (codepoint == '\n')
+		{
+			breakLine(mGlyphs.size());
+			penX = 0;
+			previous = 0;
+			lineStart = breakGlyph = mGlyphs.size();
+			continue;
+		}
+
+		penX += font.kerning(previous, codepoint);
+		previous = codepoint;
+
+		const auto advance = font.glyph(codepoint).advance;
+		if (maxWidth > 0 && codepoint != ' ' && penX + advance > maxWidth && breakGlyph > lineStart)
+		{
+			breakLine(breakGlyph);
+
+			// The partial word after the last space moves to the start of the new line
+			const auto shift = (breakGlyph < mGlyphs.size()) ? mGlyphs[breakGlyph].offset.x : penX;
+			for (auto glyph = mGlyphs.begin() + static_cast<std::ptrdiff_t>(breakGlyph); glyph != mGlyphs.end(); ++glyph)
+			{
+				glyph->offset.x -= shift;
+			}
+			penX -= shift;
+			lineStart = breakGlyph;
+		}
+
+		mGlyphs.push_back({codepoint, {penX, 0}, advance});
+		penX += advance;
+
+		if (codepoint == ' ')
+		{
+			breakGlyph = mGlyphs.size();
+		}
+	}
+
+	breakLine(mGlyphs.size());
+	align(maxWidth, alignment);
+}
+
+
+const Font& TextLayout::font() const
+{
+	return *mFont;
+}
+
+
+const std::vector<TextLayout::Glyph>& TextLayout::glyphs() const
+{
+	return mGlyphs;
+}
+
+
+const std::vector<TextLayout::Line>& TextLayout::lines() const
+{
+	return mLines;
+}
+
+
+/**
+ * Size in pixels of the area covered by the lines of the layout.
+ */
+Vector<int> TextLayout::size() const
+{
+	return mSize;
+}
+
+
+/**
+ * Ends the current line before a glyph.
+ *
+ * Trailing spaces do not count towards the width of the line, so wrapped
+ * lines align by their visible text.
+ */
+void TextLayout::breakLine(std::size_t endGlyph)
+{
+	const auto firstGlyph = mLines.empty() ? std::size_t{0} : mLines.back().firstGlyph + mLines.back().glyphCount;
+
+	int width = 0;
+	for (auto index = firstGlyph; index < endGlyph; ++index)
+	{
+		const auto& glyph = mGlyphs[index];
+		if (glyph.codepoint != ' ')
+		{
+			width = std::max(width, glyph.offset.x + glyph.advance);
+		}
+	}
+
+	mLines.push_back({firstGlyph, endGlyph - firstGlyph, width});
+}
+
+
+void TextLayout::align(int maxWidth, TextAlignment alignment)
+{
+	const auto widest = std::max_element(mLines.begin(), mLines.end(), [](const Line& a, const Line& b) { return a.width < b.width; });
+	const auto lineHeight = mFont->height();
+	mSize = {widest->width, lineHeight * static_cast<int>(mLines.size())};
+
+	const auto alignmentWidth = (maxWidth > 0) ? maxWidth : mSize.x;
+	int lineY = 0;
+	for (const auto& line : mLines)
+	{
+		const auto freeWidth = alignmentWidth - line.width;
+		const auto offsetX = (alignment == TextAlignment::Center) ? freeWidth / 2 : (alignment == TextAlignment::Right) ? freeWidth : 0;
+		for (auto index = line.firstGlyph; index < line.firstGlyph + line.glyphCount; ++index)
+		{
+			mGlyphs[index].offset += Vector{offsetX, lineY};
+		}
+		lineY += lineHeight;
+	}
+}
@@ -0,0 +1,79 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Font;
+
+
+	enum class TextAlignment
+	{
+		Left,
+		Center,
+		Right,
+	};
+
+
+	/**
+	 * Positions of the glyphs of a piece of text, split into lines.
+	 *
+	 * Lines are broken at newlines, and at spaces when a maximum width is
+	 * given. A single word wider than the maximum width is not broken. Lines
+	 * are aligned within the maximum width, or within the widest line if no
+	 * maximum width is given.
+	 *
+	 * A layout is computed once and can be drawn any number of times with
+	 * Renderer::drawText, without measuring the text again.
+	 *
+	 * \note	The layout refers to the Font it was created with, which must
+	 *			outlive it.
+	 */
+	class TextLayout
+	{
+	public:
+		struct Glyph
+		{
+			char32_t codepoint;
+			Vector<int> offset; /**< Pen position relative to the top left of the layout. */
+			int advance;
+		};
+
+		struct Line
+		{
+			std::size_t firstGlyph;
+			std::size_t glyphCount;
+			int width;
+		};
+
+		TextLayout(const Font& font, std::string_view text, int maxWidth = 0, TextAlignment alignment = TextAlignment::Left);
+
+		const Font& font() const;
+		const std::vector<Glyph>& glyphs() const;
+		const std::vector<Line>& lines() const;
+		Vector<int> size() const;
+
+	private:
+		void breakLine(std::size_t endGlyph);
+		void align(int maxWidth, TextAlignment alignment);
+
+		const Font* mFont;
+		std::vector<Glyph> mGlyphs{};
+		std::vector<Line> mLines{};
+		Vector<int> mSize{0, 0};
+	};
+} // namespace NAS2D
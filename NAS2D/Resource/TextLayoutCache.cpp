@@ -0,0 +1,88 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "TextLayoutCache.h"
+
+#include <functional>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	std::size_t layoutKey(const Font& font, std::string_view text, int maxWidth, TextAlignment alignment)
+	{
+		auto key = std::hash<std::string_view>{}(text);
+		const auto combine = [&key](std::size_t value) { key ^= value + 0x9e3779b9 + (key << 6) + (key >> 2); };
+		combine(std::hash<const Font*>{}(&font));
+		combine(std::hash<int>{}(maxWidth));
+		combine(static_cast<std::size_t>(alignment));
+		return key;
+	}
+}
+
+
+/**
+ * \param	capacity	Maximum number of layouts to keep.
+ */
+TextLayoutCache::TextLayoutCache(std::size_t capacity) :
+	mCapacity{capacity}
+{
+}
+
+
+/**
+ * Gets the layout of a piece of text, laying it out if it is not cached.
+ *
+ * \note	The returned reference is valid until the layout is discarded by a
+ *			later call, so it should not be stored.
+ */
+const TextLayout& TextLayoutCache::layout(const Font& font, std::string_view text, int maxWidth, TextAlignment alignment)
+{
+	const auto key = layoutKey(font, text, maxWidth, alignment);
+	const auto iterator = mEntryLookup.find(key);
+	if (iterator != mEntryLookup.end())
+	{
+		const auto entry = iterator->second;
+		if (entry->font == &font && entry->text == text && entry->maxWidth == maxWidth && entry->alignment == alignment)
+		{
+			mEntries.splice(mEntries.begin(), mEntries, entry);
+			return entry->layout;
+		}
+
+		// Hash collision, the new layout replaces the old one
+		mEntries.erase(entry);
+		mEntryLookup.erase(iterator);
+	}
+
+	mEntries.push_front(Entry{key, &font, std::string{text}, maxWidth, alignment, TextLayout{font, text, maxWidth, alignment}});
+	mEntryLookup.try_emplace(key, mEntries.begin());
+
+	if (mEntries.size() > mCapacity && mEntries.size() > 1)
+	{
+		mEntryLookup.erase(mEntries.back().key);
+		mEntries.pop_back();
+	}
+
+	return mEntries.front().layout;
+}
+
+
+void TextLayoutCache::clear()
+{
+	mEntryLookup.clear();
+	mEntries.clear();
+}
+
+
+std::size_t TextLayoutCache::size() const
+{
+	return mEntries.size();
+}
@@ -0,0 +1,65 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "TextLayout.h"
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace NAS2D
+{
+	/**
+	 * Keeps recently used text layouts, so text drawn every frame is only
+	 * laid out once.
+	 *
+	 * Layouts are keyed by font, text, maximum width and alignment. Looking up
+	 * a cached layout does not allocate. When the cache is full, the least
+	 * recently used layout is discarded.
+	 *
+	 * \note	Fonts are identified by address. Call clear() when a Font used
+	 *			with the cache is destroyed.
+	 */
+	class TextLayoutCache
+	{
+	public:
+		static constexpr std::size_t DefaultCapacity{256};
+
+		explicit TextLayoutCache(std::size_t capacity = DefaultCapacity);
+		TextLayoutCache(const TextLayoutCache&) = delete;
+		TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+		const TextLayout& layout(const Font& font, std::string_view text, int maxWidth = 0, TextAlignment alignment = TextAlignment::Left);
+
+		void clear();
+		std::size_t size() const;
+
+	private:
+		struct Entry
+		{
+			std::size_t key;
+			const Font* font;
+			std::string text;
+			int maxWidth;
+			TextAlignment alignment;
+			TextLayout layout;
+		};
+
+		using EntryList = std::list<Entry>;
+
+		std::size_t mCapacity;
+		EntryList mEntries{};
+		std::unordered_map<std::size_t, EntryList::iterator> mEntryLookup{};
+	};
+} // namespace NAS2D
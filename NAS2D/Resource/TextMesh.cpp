@@ -0,0 +1,254 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "TextMesh.h"
+#include "Font.h"
+#include "TextLayout.h"
+
+#include "../Math/Rectangle.h"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__XCODE_BUILD__)
+#include <GLEW/GLEW.h>
+#else
+#include <GL/glew.h>
+#endif
+
+
+using namespace NAS2D;
+
+
+/**
+ * Builds the glyph quads of a piece of text.
+ *
+ * \param	font	Font to draw the text with.
+ * \param	text	UTF-8 encoded text.
+ * \param	color	Color to draw the text in.
+ */
+TextMesh::TextMesh(const Font& font, std::string_view text, Color color) :
+	mFont{&font},
+	mText{text},
+	mColor{color}
+{
+	build();
+}
+
+
+/**
+ * Takes over the glyph quads and vertex buffer of another mesh.
+ *
+ * The other mesh is left empty, without a vertex buffer.
+ */
+TextMesh::TextMesh(TextMesh&& other) noexcept :
+	mFont{other.mFont},
+	mText{std::move(other.mText)},
+	mColor{other.mColor},
+	mSize{other.mSize},
+	mVertices{std::move(other.mVertices)},
+	mBatches{std::move(other.mBatches)},
+	mVertexBufferId{std::exchange(other.mVertexBufferId, 0u)},
+	mIsUploaded{std::exchange(other.mIsUploaded, false)}
+{
+	other.mText.clear();
+	other.mSize = {0, 0};
+	other.mVertices.clear();
+	other.mBatches.clear();
+}
+
+
+TextMesh& TextMesh::operator=(TextMesh&& other) noexcept
+{
+	if (this != &other)
+	{
+		deleteVertexBuffer();
+		mFont = other.mFont;
+		mText = std::move(other.mText);
+		mColor = other.mColor;
+		mSize = std::exchange(other.mSize, {0, 0});
+		mVertices = std::move(other.mVertices);
+		mBatches = std::move(other.mBatches);
+		mVertexBufferId = std::exchange(other.mVertexBufferId, 0u);
+		mIsUploaded = std::exchange(other.mIsUploaded, false);
+		other.mText.clear();
+		other.mVertices.clear();
+		other.mBatches.clear();
+	}
+	return *this;
+}
+
+
+TextMesh::~TextMesh()
+{
+	deleteVertexBuffer();
+}
+
+
+const Font& TextMesh::font() const
+{
+	return *mFont;
+}
+
+
+const std::string& TextMesh::text() const
+{
+	return mText;
+}
+
+
+/**
+ * Changes the text, rebuilding the glyph quads if it is different.
+ */
+void TextMesh::text(std::string_view text)
+{
+	if (text == mText)
+	{
+		return;
+	}
+
+	mText = text;
+	build();
+}
+
+
+Color TextMesh::color() const
+{
+	return mColor;
+}
+
+
+/**
+ * Changes the color. Does not rebuild the glyph quads.
+ */
+void TextMesh::color(Color color)
+{
+	mColor = color;
+}
+
+
+/**
+ * Size in pixels of the area covered by the lines of text.
+ */
+Vector<int> TextMesh::size() const
+{
+	return mSize;
+}
+
+
+/**
+ * Gets the vertex buffer, uploading the glyph quads first if they changed.
+ *
+ * Glyph quads are rebuilt first if a glyph cache page they use was
+ * evicted since they were built.
+ */
+unsigned int TextMesh::vertexBufferId() const
+{
+	if (isStale())
+	{
+		build();
+	}
+
+	if (!mIsUploaded)
+	{
+		if (mVertexBufferId == 0)
+		{
+			glGenBuffers(1, &mVertexBufferId);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, mVertexBufferId);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mVertices.size() * sizeof(float)), mVertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		mIsUploaded = true;
+	}
+
+	return mVertexBufferId;
+}
+
+
+const std::vector<TextMesh::Batch>& TextMesh::batches() const
+{
+	return mBatches;
+}
+
+
+/**
+ * Lays out the text and builds a pair of triangles for each visible glyph.
+ *
+ * Consecutive glyphs on the same texture are merged into one batch.
+ */
+void TextMesh::build() const
+{
+	mVertices.clear();
+	mBatches.clear();
+	mIsUploaded = false;
+
+	mFont->beginGlyphBatch();
+	const auto layout = TextLayout{*mFont, mText};
+	mSize = layout.size();
+
+	int vertexCount = 0;
+	for (const auto& glyph : layout.glyphs())
+	{
+		const auto& metrics = mFont->glyph(glyph.codepoint);
+		if (metrics.size.x <= 0 || metrics.size.y <= 0)
+		{
+			continue;
+		}
+
+		if (mBatches.empty() || mBatches.back().textureId != metrics.textureId)
+		{
+			mBatches.push_back({metrics.textureId, vertexCount, 0, 0});
+		}
+
+		const auto quad = Rectangle{Point{0, 0} + glyph.offset + metrics.offset, metrics.size}.to<float>();
+		const auto p1 = quad.position;
+		const auto p2 = quad.endPoint();
+		const auto t1 = metrics.uvRect.position;
+		const auto t2 = metrics.uvRect.endPoint();
+		mVertices.insert(mVertices.end(), {
+			p1.x, p1.y, t1.x, t1.y,
+			p1.x, p2.y, t1.x, t2.y,
+			p2.x, p2.y, t2.x, t2.y,
+			p2.x, p2.y, t2.x, t2.y,
+			p2.x, p1.y, t2.x, t1.y,
+			p1.x, p1.y, t1.x, t1.y,
+		});
+
+		vertexCount += 6;
+		mBatches.back().vertexCount += 6;
+	}
+
+	// Pages used by this batch are not evicted while building, so generations
+	// recorded now only change when a later draw evicts one of them
+	for (auto& batch : mBatches)
+	{
+		batch.pageGeneration = mFont->glyphPageGeneration(batch.textureId);
+	}
+}
+
+
+/**
+ * Checks if a glyph cache page used by the glyph quads was evicted since they were built.
+ */
+bool TextMesh::isStale() const
+{
+	return std::any_of(mBatches.begin(), mBatches.end(), [this](const Batch& batch) {
+		return batch.pageGeneration != mFont->glyphPageGeneration(batch.textureId);
+	});
+}
+
+
+void TextMesh::deleteVertexBuffer()
+{
+	if (mVertexBufferId != 0)
+	{
+		glDeleteBuffers(1, &mVertexBufferId);
+		mVertexBufferId = 0;
+	}
+}
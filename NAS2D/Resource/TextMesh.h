@@ -0,0 +1,93 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Renderer/Color.h"
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Font;
+
+
+	/**
+	 * Text whose glyph quads are built once and kept in a GPU vertex buffer.
+	 *
+	 * Intended for text that rarely changes, such as button captions and
+	 * labels. Drawing with Renderer::drawText submits the stored buffer
+	 * instead of building quads for each glyph every frame. The quads are
+	 * only rebuilt when the text is changed, or when a glyph cache page it
+	 * uses was evicted from the Font's glyph cache.
+	 *
+	 * Text is laid out like TextLayout, so newlines start new lines.
+	 *
+	 * \note	The mesh refers to the Font it was created with, which must
+	 *			outlive it.
+	 */
+	class TextMesh
+	{
+	public:
+		TextMesh(const Font& font, std::string_view text, Color color = Color::White);
+		TextMesh(const TextMesh&) = delete;
+		TextMesh& operator=(const TextMesh&) = delete;
+		TextMesh(TextMesh&& other) noexcept;
+		TextMesh& operator=(TextMesh&& other) noexcept;
+		~TextMesh();
+
+		const Font& font() const;
+
+		const std::string& text() const;
+		void text(std::string_view text);
+
+		Color color() const;
+		void color(Color color);
+
+		Vector<int> size() const;
+
+	protected:
+		friend class RendererOpenGL;
+
+		/**
+		 * Glyph quads drawn from the same texture, as a range of vertices.
+		 */
+		struct Batch
+		{
+			unsigned int textureId;
+			int firstVertex;
+			int vertexCount;
+			std::size_t pageGeneration; /**< Glyph cache page generation of the texture when built. */
+		};
+
+		static constexpr std::size_t FloatsPerVertex{4}; /**< Position x, y and texture coordinates u, v. */
+
+		unsigned int vertexBufferId() const;
+		const std::vector<Batch>& batches() const;
+
+	private:
+		void build() const;
+		bool isStale() const;
+		void deleteVertexBuffer();
+
+		const Font* mFont;
+		std::string mText;
+		Color mColor;
+		mutable Vector<int> mSize{0, 0};
+		mutable std::vector<float> mVertices{};
+		mutable std::vector<Batch> mBatches{};
+		mutable unsigned int mVertexBufferId{0u};
+		mutable bool mIsUploaded{false};
+	};
+} // namespace NAS2D
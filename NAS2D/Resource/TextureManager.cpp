@@ -0,0 +1,192 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "TextureManager.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+using namespace NAS2D;
+
+
+/**
+ * Creates a TextureManager with a memory budget.
+ *
+ * \param	budget	Maximum number of bytes of evictable texture memory to keep resident.
+ */
+TextureManager::TextureManager(std::size_t budget) :
+	mBudget{budget}
+{
+}
+
+
+/**
+ * Gets the memory budget in bytes.
+ */
+std::size_t TextureManager::budget() const
+{
+	return mBudget;
+}
+
+
+/**
+ * Sets the memory budget in bytes.
+ *
+ * Textures are evicted immediately if the new budget is already exceeded.
+ */
+void TextureManager::budget(std::size_t bytes)
+{
+	mBudget = bytes;
+	evictToBudget(0);
+}
+
+
+/**
+ * Registers a newly uploaded texture.
+ *
+ * The texture is treated as the most recently used texture. If the budget is
+ * exceeded, other textures are evicted until it is met again.
+ *
+ * \param	textureId		OpenGL texture name.
+ * \param	byteSize		Size of the texture in GPU memory.
+ * \param	evictDelegate	Called when the texture is evicted. An empty delegate pins the texture.
+ */
+void TextureManager::add(unsigned int textureId, std::size_t byteSize, EvictDelegate evictDelegate)
+{
+	if (mEntryLookup.find(textureId) != mEntryLookup.end())
+	{
+		throw std::runtime_error("TextureManager texture is already registered: " + std::to_string(textureId));
+	}
+
+	mEntries.push_front(Entry{textureId, byteSize, evictDelegate});
+	mEntryLookup.try_emplace(textureId, mEntries.begin());
+
+	mStatistics.bytesUsed += byteSize;
+	mStatistics.peakBytesUsed = std::max(mStatistics.peakBytesUsed, mStatistics.bytesUsed);
+	++mStatistics.uploads;
+
+	evictToBudget(textureId);
+}
+
+
+/**
+ * Unregisters a texture. The eviction callback is not invoked.
+ *
+ * Should be called by the owner when it deletes the texture itself.
+ */
+void TextureManager::remove(unsigned int textureId)
+{
+	const auto iterator = mEntryLookup.find(textureId);
+	if (iterator == mEntryLookup.end())
+	{
+		return;
+	}
+
+	mStatistics.bytesUsed -= iterator->second->byteSize;
+	mEntries.erase(iterator->second);
+	mEntryLookup.erase(iterator);
+}
+
+
+/**
+ * Marks a texture as the most recently used.
+ *
+ * Should be called whenever the texture is drawn.
+ */
+void TextureManager::touch(unsigned int textureId)
+{
+	const auto iterator = mEntryLookup.find(textureId);
+	if (iterator != mEntryLookup.end())
+	{
+		mEntries.splice(mEntries.begin(), mEntries, iterator->second);
+	}
+}
+
+
+/**
+ * Prevents a registered texture from being evicted.
+ *
+ * Used for textures whose contents can not be restored from their source
+ * data, such as the target of render to texture operations.
+ */
+void TextureManager::pin(unsigned int textureId)
+{
+	const auto iterator = mEntryLookup.find(textureId);
+	if (iterator != mEntryLookup.end())
+	{
+		iterator->second->evictDelegate.clear();
+	}
+}
+
+
+bool TextureManager::contains(unsigned int textureId) const
+{
+	return mEntryLookup.find(textureId) != mEntryLookup.end();
+}
+
+
+TextureManager::Statistics TextureManager::statistics() const
+{
+	auto statistics = mStatistics;
+	statistics.budget = mBudget;
+	statistics.textureCount = mEntries.size();
+	statistics.pinnedCount = static_cast<std::size_t>(std::count_if(mEntries.begin(), mEntries.end(), [](const Entry& entry) { return entry.evictDelegate.empty(); }));
+	return statistics;
+}
+
+
+/**
+ * Whether texture uploads convert pixel data to premultiplied alpha.
+ */
+bool TextureManager::premultipliedAlpha() const
+{
+	return mPremultipliedAlpha;
+}
+
+
+/**
+ * Sets whether texture uploads convert pixel data to premultiplied alpha.
+ *
+ * \note	Only affects textures uploaded afterwards. Should be set once before
+ *			any resources are loaded, normally by the Renderer.
+ */
+void TextureManager::premultipliedAlpha(bool premultiplied)
+{
+	mPremultipliedAlpha = premultiplied;
+}
+
+
+/**
+ * Evicts least recently used textures until the budget is met.
+ *
+ * \param	keepTextureId	Texture which must not be evicted, such as the one just added.
+ */
+void TextureManager::evictToBudget(unsigned int keepTextureId)
+{
+	auto iterator = mEntries.end();
+	while (mStatistics.bytesUsed > mBudget && iterator != mEntries.begin())
+	{
+		--iterator;
+		if (iterator->textureId == keepTextureId || iterator->evictDelegate.empty())
+		{
+			continue;
+		}
+
+		// Unregister before the callback so the owner is free to upload again immediately
+		const auto evictDelegate = iterator->evictDelegate;
+		mStatistics.bytesUsed -= iterator->byteSize;
+		++mStatistics.evictions;
+		mEntryLookup.erase(iterator->textureId);
+		iterator = mEntries.erase(iterator);
+
+		evictDelegate();
+	}
+}
@@ -0,0 +1,96 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Signal/Delegate.h"
+
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <unordered_map>
+
+
+namespace NAS2D
+{
+	/**
+	 * Tracks GPU memory used by textures and enforces a memory budget.
+	 *
+	 * Textures are registered with their size in bytes and an eviction callback.
+	 * When the total size of registered textures exceeds the budget, the least
+	 * recently used textures are evicted by invoking their callback. Owners are
+	 * expected to release the texture in the callback and upload it again from
+	 * their retained source data the next time it is needed.
+	 *
+	 * Textures registered without an eviction callback are pinned. They count
+	 * towards the budget but are never evicted.
+	 *
+	 * The TextureManager also holds upload settings shared by all textures,
+	 * such as whether pixel data is converted to premultiplied alpha.
+	 *
+	 * \note	The budget should be larger than the set of textures drawn in a
+	 *			single frame, otherwise textures will be evicted and uploaded
+	 *			again every frame.
+	 */
+	class TextureManager
+	{
+	public:
+		using EvictDelegate = Delegate<void()>;
+
+		struct Statistics
+		{
+			std::size_t budget{0};
+			std::size_t bytesUsed{0};
+			std::size_t peakBytesUsed{0};
+			std::size_t textureCount{0};
+			std::size_t pinnedCount{0};
+			std::size_t uploads{0};
+			std::size_t evictions{0};
+		};
+
+		static constexpr std::size_t Unlimited{std::numeric_limits<std::size_t>::max()};
+
+		TextureManager() = default;
+		explicit TextureManager(std::size_t budget);
+		TextureManager(const TextureManager&) = delete;
+		TextureManager& operator=(const TextureManager&) = delete;
+
+		std::size_t budget() const;
+		void budget(std::size_t bytes);
+
+		void add(unsigned int textureId, std::size_t byteSize, EvictDelegate evictDelegate = {});
+		void remove(unsigned int textureId);
+		void touch(unsigned int textureId);
+		void pin(unsigned int textureId);
+
+		bool contains(unsigned int textureId) const;
+		Statistics statistics() const;
+
+		bool premultipliedAlpha() const;
+		void premultipliedAlpha(bool premultiplied);
+
+	private:
+		struct Entry
+		{
+			unsigned int textureId;
+			std::size_t byteSize;
+			EvictDelegate evictDelegate;
+		};
+
+		using EntryList = std::list<Entry>;
+
+		void evictToBudget(unsigned int keepTextureId);
+
+		std::size_t mBudget{Unlimited};
+		EntryList mEntries{};
+		std::unordered_map<unsigned int, EntryList::iterator> mEntryLookup{};
+		Statistics mStatistics{};
+		bool mPremultipliedAlpha{false};
+	};
+} // namespace
@@ -0,0 +1,192 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace NAS2D
+{
+	/**
+	 * Decodes the codepoint starting at a byte offset of a UTF-8 string.
+	 *
+	 * Invalid, overlong and truncated sequences decode one byte at a time as
+	 * the Latin-1 codepoint of that byte. This keeps strings that predate
+	 * UTF-8 support, which use Latin-1 bytes for characters 128 - 255,
+	 * displaying as they always have.
+	 *
+	 * \param	string	UTF-8 encoded string.
+	 * \param	index	Byte offset of the sequence to decode. Advanced past the decoded sequence.
+	 */
+	constexpr char32_t decodeUtf8(std::string_view string, std::size_t& index)
+	{
+		const auto byte = [&string](std::size_t offset) { return static_cast<char32_t>(static_cast<unsigned char>(string[offset])); };
+		const auto isContinuation = [&string, &byte](std::size_t offset) { return offset < string.size() && (byte(offset) & 0xC0) == 0x80; };
+
+		const auto lead = byte(index);
+		if (lead >= 0xC2 && lead <= 0xDF && isContinuation(index + 1))
+		{
+			const auto codepoint = ((lead & 0x1F) << 6) | (byte(index + 1) & 0x3F);
+			index += 2;
+			return codepoint;
+		}
+		if (lead >= 0xE0 && lead <= 0xEF && isContinuation(index + 1) && isContinuation(index + 2))
+		{
+			const auto codepoint = ((lead & 0x0F) << 12) | ((byte(index + 1) & 0x3F) << 6) | (byte(index + 2) & 0x3F);
+			// Reject overlong encodings and UTF-16 surrogates
+			if (codepoint >= 0x800 && (codepoint < 0xD800 || codepoint > 0xDFFF))
+			{
+				index += 3;
+				return codepoint;
+			}
+		}
+		if (lead >= 0xF0 && lead <= 0xF4 && isContinuation(index + 1) && isContinuation(index + 2) && isContinuation(index + 3))
+		{
+			const auto codepoint = ((lead & 0x07) << 18) | ((byte(index + 1) & 0x3F) << 12) | ((byte(index + 2) & 0x3F) << 6) | (byte(index + 3) & 0x3F);
+			if (codepoint >= 0x10000 && codepoint <= 0x10FFFF)
+			{
+				index += 4;
+				return codepoint;
+			}
+		}
+
+		++index;
+		return lead;
+	}
+
+
+	/**
+	 * Appends the UTF-8 encoding of a codepoint to a string.
+	 *
+	 * Codepoints which can not be encoded, such as UTF-16 surrogates and
+	 * values above 0x10FFFF, are appended as U+FFFD REPLACEMENT CHARACTER.
+	 */
+	inline void appendUtf8(std::string& string, char32_t codepoint)
+	{
+		if ((codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+		{
+			codepoint = 0xFFFD;
+		}
+
+		const auto append = [&string](char32_t byte) { string.push_back(static_cast<char>(byte)); };
+		if (codepoint < 0x80)
+		{
+			append(codepoint);
+		}
+		else if (codepoint < 0x800)
+		{
+			append(0xC0 | (codepoint >> 6));
+			append(0x80 | (codepoint & 0x3F));
+		}
+		else if (codepoint < 0x10000)
+		{
+			append(0xE0 | (codepoint >> 12));
+			append(0x80 | ((codepoint >> 6) & 0x3F));
+			append(0x80 | (codepoint & 0x3F));
+		}
+		else
+		{
+			append(0xF0 | (codepoint >> 18));
+			append(0x80 | ((codepoint >> 12) & 0x3F));
+			append(0x80 | ((codepoint >> 6) & 0x3F));
+			append(0x80 | (codepoint & 0x3F));
+		}
+	}
+
+
+	/**
+	 * Iterates over the codepoints of a UTF-8 string without allocating.
+	 *
+	 * \code
+	 * for (const auto codepoint : Utf8Range{text}) { ... }
+	 * \endcode
+	 *
+	 * \see decodeUtf8 for handling of invalid sequences.
+	 */
+	class Utf8Range
+	{
+	public:
+		class Iterator
+		{
+		public:
+			constexpr Iterator(std::string_view string, std::size_t index) :
+				mString{string},
+				mIndex{index},
+				mNextIndex{index}
+			{
+				decode();
+			}
+
+			constexpr Iterator& operator++()
+			{
+				mIndex = mNextIndex;
+				decode();
+				return *this;
+			}
+
+			constexpr bool operator==(const Iterator& other) const
+			{
+				return mIndex == other.mIndex;
+			}
+
+			constexpr bool operator!=(const Iterator& other) const
+			{
+				return !(*this == other);
+			}
+
+			constexpr char32_t operator*() const
+			{
+				return mCodepoint;
+			}
+
+			/**
+			 * Byte offset of the current codepoint in the string.
+			 */
+			constexpr std::size_t index() const
+			{
+				return mIndex;
+			}
+
+		private:
+			constexpr void decode()
+			{
+				if (mIndex < mString.size())
+				{
+					mCodepoint = decodeUtf8(mString, mNextIndex);
+				}
+			}
+
+			std::string_view mString;
+			std::size_t mIndex;
+			std::size_t mNextIndex;
+			char32_t mCodepoint{0};
+		};
+
+
+		constexpr Utf8Range(std::string_view string) :
+			mString{string}
+		{}
+
+		constexpr Iterator begin() const
+		{
+			return Iterator{mString, 0};
+		}
+
+		constexpr Iterator end() const
+		{
+			return Iterator{mString, mString.size()};
+		}
+
+	private:
+		std::string_view mString;
+	};
+} // namespace NAS2D
@@ -0,0 +1,148 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+/**
+ * Number of workers to use for a task, one per hardware thread.
+ *
+ * \param	maxSize	Largest number of workers that are useful for the task.
+ */
+unsigned int WorkerPool::defaultSize(unsigned int maxSize)
+{
+	return std::clamp(std::thread::hardware_concurrency(), 1u, std::max(maxSize, 1u));
+}
+
+
+/**
+ * \param	size	Number of workers, including the thread calling run.
+ */
+WorkerPool::WorkerPool(unsigned int size)
+{
+	try
+	{
+		for (unsigned int worker = 1; worker < size; ++worker)
+		{
+			mThreads.emplace_back(&WorkerPool::work, this, worker);
+		}
+	}
+	catch (...)
+	{
+		stop();
+		throw;
+	}
+}
+
+
+WorkerPool::~WorkerPool()
+{
+	stop();
+}
+
+
+/**
+ * Number of workers, including the thread calling run.
+ */
+unsigned int WorkerPool::size() const
+{
+	return static_cast<unsigned int>(mThreads.size()) + 1;
+}
+
+
+/**
+ * Calls a task once for each worker, and waits for all calls to finish.
+ *
+ * \throw	The first exception thrown by a call of the task.
+ */
+void WorkerPool::run(const Task& task)
+{
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		mTask = &task;
+		mPending = mThreads.size();
+		++mGeneration;
+	}
+	mWake.notify_all();
+
+	runTask(task, 0);
+
+	std::unique_lock<std::mutex> lock{mMutex};
+	mDone.wait(lock, [this]() { return mPending == 0; });
+	mTask = nullptr;
+	if (mError)
+	{
+		std::rethrow_exception(std::exchange(mError, nullptr));
+	}
+}
+
+
+void WorkerPool::work(unsigned int worker)
+{
+	std::uint64_t generation = 0;
+	std::unique_lock<std::mutex> lock{mMutex};
+	while (true)
+	{
+		mWake.wait(lock, [this, generation]() { return mStopping || mGeneration != generation; });
+		if (mStopping)
+		{
+			return;
+		}
+
+		generation = mGeneration;
+		const auto& task = *mTask;
+		lock.unlock();
+		runTask(task, worker);
+		lock.lock();
+
+		if (--mPending == 0)
+		{
+			mDone.notify_one();
+		}
+	}
+}
+
+
+void WorkerPool::runTask(const Task& task, unsigned int worker)
+{
+	try
+	{
+		task(worker);
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		if (!mError)
+		{
+			mError = std::current_exception();
+		}
+	}
+}
+
+
+void WorkerPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock{mMutex};
+		mStopping = true;
+	}
+	mWake.notify_all();
+
+	for (auto& thread : mThreads)
+	{
+		thread.join();
+	}
+	mThreads.clear();
+}
@@ -0,0 +1,67 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Fixed set of threads that run a task in parallel.
+	 *
+	 * run calls a task once for each worker, with the index of the worker,
+	 * and returns when every call has finished. Worker 0 is the calling
+	 * thread. The other threads are created once, and wait between runs, so
+	 * tasks run every frame do not pay for creating threads.
+	 *
+	 * If a call throws, the first exception is rethrown by run after every
+	 * call has finished. Threads are always joined before the pool is
+	 * destroyed, including when creating one of them fails.
+	 */
+	class WorkerPool
+	{
+	public:
+		using Task = std::function<void(unsigned int worker)>;
+
+		static unsigned int defaultSize(unsigned int maxSize);
+
+		explicit WorkerPool(unsigned int size);
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+		~WorkerPool();
+
+		unsigned int size() const;
+
+		void run(const Task& task);
+
+	private:
+		void work(unsigned int worker);
+		void runTask(const Task& task, unsigned int worker);
+		void stop();
+
+		std::vector<std::thread> mThreads{};
+		std::mutex mMutex{};
+		std::condition_variable mWake{};
+		std::condition_variable mDone{};
+		const Task* mTask{nullptr};
+		std::uint64_t mGeneration{0};
+		std::size_t mPending{0};
+		std::exception_ptr mError{};
+		bool mStopping{false};
+	};
+} // namespace NAS2D
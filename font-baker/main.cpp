@@ -0,0 +1,128 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include <NAS2D/Resource/BakedFont.h>
+#include <NAS2D/Resource/Font.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	constexpr unsigned long MaxPointSize = 1000;
+
+
+	void printUsage()
+	{
+		std::cout << "Usage: font-baker [--distance-field] <font file> <output file> <point size>..." << std::endl;
+		std::cout << std::endl;
+		std::cout << "Bakes the glyph atlas and metrics of a TrueType or OpenType font at each" << std::endl;
+		std::cout << "point size into a single baked font file, which NAS2D::Font loads without" << std::endl;
+		std::cout << "rasterizing glyphs." << std::endl;
+	}
+
+
+	std::string readFile(const std::string& path)
+	{
+		std::ifstream file{path, std::ios::binary};
+		if (!file)
+		{
+			throw std::runtime_error("Could not open file: " + path);
+		}
+		return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	}
+
+
+	/**
+	 * Parses a point size argument, which must be a whole number from 1 to MaxPointSize.
+	 *
+	 * \throw	std::runtime_error if the argument is not a valid point size.
+	 */
+	unsigned int parsePointSize(const std::string& argument)
+	{
+		const auto isDigits = !argument.empty() && std::all_of(argument.begin(), argument.end(), [](char c) { return c >= '0' && c <= '9'; });
+		if (!isDigits || argument.size() > 4)
+		{
+			throw std::runtime_error("Invalid point size: " + argument);
+		}
+
+		const auto ptSize = std::stoul(argument);
+		if (ptSize < 1 || ptSize > MaxPointSize)
+		{
+			throw std::runtime_error("Point size must be from 1 to " + std::to_string(MaxPointSize) + ": " + argument);
+		}
+		return static_cast<unsigned int>(ptSize);
+	}
+
+
+	void writeFile(const std::string& path, const std::string& data)
+	{
+		std::ofstream file{path, std::ios::binary};
+		file.write(data.data(), static_cast<std::streamsize>(data.size()));
+		if (!file)
+		{
+			throw std::runtime_error("Could not write file: " + path);
+		}
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+
+	auto renderMode = NAS2D::FontRenderMode::Coverage;
+	if (!arguments.empty() && arguments.front() == "--distance-field")
+	{
+		renderMode = NAS2D::FontRenderMode::DistanceField;
+		arguments.erase(arguments.begin());
+	}
+
+	if (arguments.size() < 3)
+	{
+		printUsage();
+		return 1;
+	}
+
+	try
+	{
+		std::vector<unsigned int> ptSizes;
+		for (auto argument = arguments.begin() + 2; argument != arguments.end(); ++argument)
+		{
+			ptSizes.push_back(parsePointSize(*argument));
+		}
+
+		const auto fontData = readFile(arguments[0]);
+
+		std::vector<NAS2D::BakedFont> bakedFonts;
+		for (const auto ptSize : ptSizes)
+		{
+			bakedFonts.push_back(NAS2D::Font::bake(fontData, ptSize, renderMode));
+			const auto& bakedFont = bakedFonts.back();
+			std::cout << "Baked " << ptSize << "pt: " << bakedFont.atlasSize.x << "x" << bakedFont.atlasSize.y << " atlas, " << bakedFont.kerningPairs.size() << " kerning pairs, ";
+			std::cout << NAS2D::textureByteSize(bakedFont) << " texture bytes (" << NAS2D::gridTextureByteSize(bakedFont) << " as a glyph grid)" << std::endl;
+		}
+
+		writeFile(arguments[1], NAS2D::writeBakedFontFile(fontData, bakedFonts));
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include <NAS2D/Resource/SpriteDefinition.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "Usage: sprite-compiler <sprite file>..." << std::endl;
+		std::cout << std::endl;
+		std::cout << "Compiles each sprite XML definition into a binary sprite file next to it," << std::endl;
+		std::cout << "named after the sprite file with a .bin extension appended. NAS2D loads" << std::endl;
+		std::cout << "the compiled file instead of parsing the XML when it is present." << std::endl;
+	}
+
+
+	std::string readFile(const std::string& path)
+	{
+		std::ifstream file{path, std::ios::binary};
+		if (!file)
+		{
+			throw std::runtime_error("Could not open file: " + path);
+		}
+		return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	}
+
+
+	void writeFile(const std::string& path, const std::string& data)
+	{
+		std::ofstream file{path, std::ios::binary};
+		file.write(data.data(), static_cast<std::streamsize>(data.size()));
+		if (!file)
+		{
+			throw std::runtime_error("Could not write file: " + path);
+		}
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	const std::vector<std::string> arguments(argv + 1, argv + argc);
+	if (arguments.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	for (const auto& spritePath : arguments)
+	{
+		try
+		{
+			const auto definition = NAS2D::parseSpriteXml(readFile(spritePath));
+			const auto compiledPath = NAS2D::compiledSpritePath(spritePath);
+			writeFile(compiledPath, NAS2D::writeCompiledSpriteFile(definition));
+			std::cout << "Compiled " << spritePath << ": " << definition.imageSheets.size() << " image sheets, " << definition.actions.size() << " actions" << std::endl;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << "Error compiling " << spritePath << ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
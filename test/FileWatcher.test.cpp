@@ -0,0 +1,66 @@
+#include "NAS2D/FileWatcher.h"
+#include "NAS2D/Filesystem.h"
+#include "NAS2D/Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+
+class FileWatcher : public ::testing::Test {
+protected:
+	static constexpr auto AppName = "NAS2DUnitTests";
+	static constexpr auto OrganizationName = "LairWorks";
+	static constexpr auto FileName = "FileWatcherTestFile.txt";
+
+	FileWatcher() :
+		fs(NAS2D::Utility<NAS2D::Filesystem>::init(AppName, OrganizationName))
+	{
+		fs.mountReadWrite(fs.prefPath());
+	}
+
+	~FileWatcher() override {
+		if (fs.exists(FileName)) {
+			fs.del(FileName);
+		}
+		NAS2D::Utility<NAS2D::Filesystem>::clear();
+	}
+
+	void touch() {
+		std::filesystem::last_write_time(fs.prefPath() / FileName, fs.lastWriteTime(FileName) + std::chrono::seconds{1});
+	}
+
+	NAS2D::Filesystem& fs;
+	NAS2D::FileWatcher watcher;
+};
+
+
+TEST_F(FileWatcher, firstCheckIsUnchanged) {
+	EXPECT_FALSE(watcher.hasChanged(FileName));
+
+	fs.writeFile(FileName, "Contents");
+	NAS2D::FileWatcher otherWatcher;
+	EXPECT_FALSE(otherWatcher.hasChanged(FileName));
+	EXPECT_FALSE(otherWatcher.hasChanged(FileName));
+}
+
+TEST_F(FileWatcher, modified) {
+	fs.writeFile(FileName, "Contents");
+	EXPECT_FALSE(watcher.hasChanged(FileName));
+
+	touch();
+	EXPECT_TRUE(watcher.hasChanged(FileName));
+	EXPECT_FALSE(watcher.hasChanged(FileName));
+}
+
+TEST_F(FileWatcher, createdAndDeleted) {
+	EXPECT_FALSE(watcher.hasChanged(FileName));
+
+	fs.writeFile(FileName, "Contents");
+	EXPECT_TRUE(watcher.hasChanged(FileName));
+	EXPECT_FALSE(watcher.hasChanged(FileName));
+
+	fs.del(FileName);
+	EXPECT_TRUE(watcher.hasChanged(FileName));
+	EXPECT_FALSE(watcher.hasChanged(FileName));
+}
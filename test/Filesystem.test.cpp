@@ -99,6 +99,11 @@ TEST_F(Filesystem, exists) {
 	EXPECT_TRUE(fs.exists("file.txt"));
 }
 
+TEST_F(Filesystem, lastWriteTime) {
+	EXPECT_NE(std::filesystem::file_time_type::min(), fs.lastWriteTime("file.txt"));
+	EXPECT_THROW(fs.lastWriteTime("FileDoesNotExist.txt"), std::runtime_error);
+}
+
 TEST_F(Filesystem, read) {
 	const auto data = fs.readFile("file.txt");
 	EXPECT_THAT(data, testing::StartsWith("Test data"));
@@ -0,0 +1,41 @@
+#include "NAS2D/Math/ShelfPacker.h"
+
+#include <gtest/gtest.h>
+
+
+TEST(ShelfPacker, insert) {
+	auto packer = NAS2D::ShelfPacker{{10, 10}};
+
+	EXPECT_EQ((NAS2D::Point{0, 0}), packer.insert({4, 5}));
+	EXPECT_EQ((NAS2D::Point{4, 0}), packer.insert({4, 3}));
+	// Too wide for the first shelf
+	EXPECT_EQ((NAS2D::Point{0, 5}), packer.insert({3, 4}));
+	// Fits on the shortest shelf that is tall enough
+	EXPECT_EQ((NAS2D::Point{3, 5}), packer.insert({2, 2}));
+	EXPECT_EQ(9, packer.usedHeight());
+
+	EXPECT_EQ(std::nullopt, packer.insert({11, 1}));
+	EXPECT_EQ(std::nullopt, packer.insert({1, 10}));
+}
+
+TEST(ShelfPacker, padding) {
+	auto packer = NAS2D::ShelfPacker{{8, 8}, 1};
+
+	EXPECT_EQ((NAS2D::Point{0, 0}), packer.insert({3, 3}));
+	EXPECT_EQ((NAS2D::Point{4, 0}), packer.insert({3, 3}));
+	EXPECT_EQ((NAS2D::Point{0, 4}), packer.insert({3, 3}));
+	EXPECT_EQ(8, packer.usedHeight());
+	EXPECT_EQ((NAS2D::Point{4, 4}), packer.insert({3, 3}));
+	EXPECT_EQ(std::nullopt, packer.insert({1, 1}));
+}
+
+TEST(ShelfPacker, clear) {
+	auto packer = NAS2D::ShelfPacker{{4, 4}};
+
+	EXPECT_EQ((NAS2D::Point{0, 0}), packer.insert({4, 4}));
+	EXPECT_EQ(std::nullopt, packer.insert({1, 1}));
+	packer.clear();
+	EXPECT_EQ(0, packer.usedHeight());
+	EXPECT_EQ((NAS2D::Point{0, 0}), packer.insert({1, 1}));
+	EXPECT_EQ((NAS2D::Vector{4, 4}), packer.size());
+}
@@ -32,3 +32,11 @@ TEST(Color, alphaFade) {
 	EXPECT_EQ((NAS2D::Color{0, 0, 255, 128}), NAS2D::Color::Blue.alphaFade(128));
 	EXPECT_EQ((NAS2D::Color{0, 0, 255, 0}), NAS2D::Color::Blue.alphaFade(0));
 }
+
+TEST(Color, premultiplied) {
+	EXPECT_EQ((NAS2D::Color{255, 255, 255, 255}), NAS2D::Color::White.premultiplied());
+	EXPECT_EQ((NAS2D::Color{128, 128, 128, 128}), NAS2D::Color::White.alphaFade(128).premultiplied());
+	EXPECT_EQ((NAS2D::Color{0, 0, 0, 0}), NAS2D::Color::White.alphaFade(0).premultiplied());
+	EXPECT_EQ((NAS2D::Color{0, 64, 128, 128}), (NAS2D::Color{0, 128, 255, 128}.premultiplied()));
+	EXPECT_EQ((NAS2D::Color{1, 2, 3, 255}), (NAS2D::Color{1, 2, 3, 255}.premultiplied()));
+}
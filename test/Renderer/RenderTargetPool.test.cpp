@@ -0,0 +1,88 @@
+#include "NAS2D/Renderer/RenderTargetPool.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+class RenderTargetPool : public ::testing::Test {
+protected:
+	NAS2D::RenderTarget create(NAS2D::Vector<int> size, NAS2D::RenderTargetFormat format) {
+		++nextId;
+		return {nextId, nextId, size, format};
+	}
+
+	void destroy(const NAS2D::RenderTarget& renderTarget) {
+		deleted.push_back(renderTarget.frameBufferObjectId);
+	}
+
+	unsigned int nextId{0};
+	std::vector<unsigned int> deleted{};
+	NAS2D::RenderTargetPool pool{
+		[this](NAS2D::Vector<int> size, NAS2D::RenderTargetFormat format) { return create(size, format); },
+		[this](const NAS2D::RenderTarget& renderTarget) { destroy(renderTarget); },
+		2
+	};
+};
+
+
+TEST_F(RenderTargetPool, reuseReleased) {
+	const auto target1 = pool.acquire({64, 32}, NAS2D::RenderTargetFormat::Rgba8);
+	EXPECT_EQ((NAS2D::Vector{64, 32}), target1.size);
+	EXPECT_EQ(1u, pool.acquiredCount());
+	EXPECT_EQ(0u, pool.freeCount());
+
+	pool.release(target1);
+	EXPECT_EQ(0u, pool.acquiredCount());
+	EXPECT_EQ(1u, pool.freeCount());
+
+	// Same size and format reuses the released target
+	const auto target2 = pool.acquire({64, 32}, NAS2D::RenderTargetFormat::Rgba8);
+	EXPECT_EQ(target1.frameBufferObjectId, target2.frameBufferObjectId);
+	EXPECT_EQ(1u, nextId);
+	EXPECT_EQ(0u, pool.freeCount());
+	pool.release(target2);
+
+	// Other sizes and formats create new targets
+	const auto otherFormat = pool.acquire({64, 32}, NAS2D::RenderTargetFormat::Rgba16F);
+	const auto otherSize = pool.acquire({32, 64}, NAS2D::RenderTargetFormat::Rgba8);
+	EXPECT_EQ(3u, nextId);
+	EXPECT_EQ(NAS2D::RenderTargetFormat::Rgba16F, otherFormat.format);
+	EXPECT_NE(target1.frameBufferObjectId, otherFormat.frameBufferObjectId);
+	EXPECT_NE(target1.frameBufferObjectId, otherSize.frameBufferObjectId);
+	EXPECT_EQ(2u, pool.acquiredCount());
+	EXPECT_TRUE(deleted.empty());
+}
+
+TEST_F(RenderTargetPool, releaseChecksAcquired) {
+	const auto target = pool.acquire({8, 8}, NAS2D::RenderTargetFormat::Rgba8);
+	pool.release(target);
+	EXPECT_THROW(pool.release(target), std::runtime_error);
+	EXPECT_THROW(pool.release({99, 99, {8, 8}, NAS2D::RenderTargetFormat::Rgba8}), std::runtime_error);
+}
+
+TEST_F(RenderTargetPool, boundedFreeTargets) {
+	const auto target1 = pool.acquire({8, 8}, NAS2D::RenderTargetFormat::Rgba8);
+	const auto target2 = pool.acquire({8, 8}, NAS2D::RenderTargetFormat::Rgba8);
+	const auto target3 = pool.acquire({8, 8}, NAS2D::RenderTargetFormat::Rgba8);
+	pool.release(target1);
+	pool.release(target2);
+	EXPECT_TRUE(deleted.empty());
+
+	// Least recently released target is deleted once the free list is full
+	pool.release(target3);
+	EXPECT_EQ(2u, pool.freeCount());
+	EXPECT_EQ((std::vector<unsigned int>{target1.frameBufferObjectId}), deleted);
+}
+
+TEST_F(RenderTargetPool, clear) {
+	const auto target1 = pool.acquire({8, 8}, NAS2D::RenderTargetFormat::Rgba8);
+	pool.acquire({8, 8}, NAS2D::RenderTargetFormat::Rgba8);
+	pool.release(target1);
+
+	pool.clear();
+	EXPECT_EQ(0u, pool.acquiredCount());
+	EXPECT_EQ(0u, pool.freeCount());
+	EXPECT_EQ(2u, deleted.size());
+}
@@ -0,0 +1,58 @@
+#include "NAS2D/Resource/AnimationSet.h"
+#include "NAS2D/Resource/Image.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+
+namespace {
+	constexpr uint32_t o = 0xFF000000;
+
+	// Frame at {1, 1} of size 6x5, with opaque pixels from {3, 2} to {4, 4}
+	uint32_t pixels[8 * 7] = {
+		0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, o, 0, 0, 0, 0,
+		0, 0, 0, o, o, 0, 0, 0,
+		0, 0, 0, 0, o, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0,
+	};
+	const NAS2D::Rectangle<int> frameBounds{{1, 1}, {6, 5}};
+	const NAS2D::Vector<int> frameAnchorOffset{3, 4};
+}
+
+
+TEST(AnimationSet, trimmedFrameNearest) {
+	const NAS2D::Image image{pixels, 4, {8, 7}, NAS2D::TextureFilter::Nearest};
+	const auto frame = NAS2D::AnimationSet::Frame{image, frameBounds, frameAnchorOffset, 10}.trimmed();
+
+	EXPECT_EQ((NAS2D::Rectangle<int>{{3, 2}, {2, 3}}), frame.bounds);
+	EXPECT_EQ((NAS2D::Vector{2, 1}), frame.trimOffset);
+	EXPECT_EQ((NAS2D::Vector{2, 1}), frame.trimMargin);
+	EXPECT_EQ((NAS2D::Vector{1, 3}), frame.anchorOffset);
+	EXPECT_EQ(frameBounds.size, frame.size());
+	EXPECT_EQ(10u, frame.frameDelay);
+}
+
+TEST(AnimationSet, trimmedFrameLinear) {
+	const NAS2D::Image image{pixels, 4, {8, 7}};
+	const auto frame = NAS2D::AnimationSet::Frame{image, frameBounds, frameAnchorOffset, 10}.trimmed();
+
+	// A transparent border is kept for filtering, clamped to the top and bottom of the frame
+	EXPECT_EQ((NAS2D::Rectangle<int>{{2, 1}, {4, 5}}), frame.bounds);
+	EXPECT_EQ((NAS2D::Vector{1, 0}), frame.trimOffset);
+	EXPECT_EQ((NAS2D::Vector{1, 0}), frame.trimMargin);
+	EXPECT_EQ((NAS2D::Vector{2, 4}), frame.anchorOffset);
+	EXPECT_EQ(frameBounds.size, frame.size());
+}
+
+TEST(AnimationSet, trimmedFrameTransparent) {
+	const NAS2D::Image image{pixels, 4, {8, 7}};
+	const auto frame = NAS2D::AnimationSet::Frame{image, {{5, 1}, {2, 2}}, {1, 1}, 10}.trimmed();
+
+	EXPECT_TRUE(frame.bounds.empty());
+	EXPECT_EQ((NAS2D::Vector{2, 2}), frame.size());
+	EXPECT_EQ((NAS2D::Vector{1, 1}), frame.anchorOffset);
+}
@@ -0,0 +1,104 @@
+#include "NAS2D/Resource/BakedFont.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+namespace
+{
+	NAS2D::BakedFont makeBakedFont(unsigned int ptSize)
+	{
+		NAS2D::BakedFont bakedFont;
+		bakedFont.pointSize = ptSize;
+		bakedFont.renderMode = NAS2D::FontRenderMode::DistanceField;
+		bakedFont.height = 14;
+		bakedFont.ascent = -11;
+		bakedFont.atlasSize = {2, 3};
+		bakedFont.glyphs = {{-1, 2, 3, 4, 5, {0, 1}, {2, 2}, {-1, 6}}};
+		bakedFont.kerningPairs = {{'A', 'V', -2}};
+		bakedFont.atlas = {0, 1, 2, 3, 254, 255};
+		return bakedFont;
+	}
+}
+
+
+TEST(BakedFont, isBakedFontFile) {
+	EXPECT_TRUE(NAS2D::isBakedFontFile(NAS2D::writeBakedFontFile("", {})));
+	EXPECT_FALSE(NAS2D::isBakedFontFile(""));
+	EXPECT_FALSE(NAS2D::isBakedFontFile("\x00\x01\x00\x00"));
+}
+
+TEST(BakedFont, roundTrip) {
+	const auto fileData = NAS2D::writeBakedFontFile("font data", {makeBakedFont(10), makeBakedFont(12)});
+
+	EXPECT_EQ("font data", NAS2D::readBakedFontData(fileData));
+
+	const auto bakedFont = NAS2D::readBakedFont(fileData, 12);
+	const auto expected = makeBakedFont(12);
+	EXPECT_EQ(expected.pointSize, bakedFont.pointSize);
+	EXPECT_EQ(expected.renderMode, bakedFont.renderMode);
+	EXPECT_EQ(expected.height, bakedFont.height);
+	EXPECT_EQ(expected.ascent, bakedFont.ascent);
+	EXPECT_EQ(expected.atlasSize, bakedFont.atlasSize);
+	EXPECT_EQ(expected.atlas, bakedFont.atlas);
+
+	ASSERT_EQ(1u, bakedFont.glyphs.size());
+	const auto& glyph = bakedFont.glyphs[0];
+	EXPECT_EQ(-1, glyph.minX);
+	EXPECT_EQ(2, glyph.minY);
+	EXPECT_EQ(3, glyph.maxX);
+	EXPECT_EQ(4, glyph.maxY);
+	EXPECT_EQ(5, glyph.advance);
+	EXPECT_EQ((NAS2D::Point{0, 1}), glyph.position);
+	EXPECT_EQ((NAS2D::Vector{2, 2}), glyph.size);
+	EXPECT_EQ((NAS2D::Vector{-1, 6}), glyph.offset);
+
+	ASSERT_EQ(1u, bakedFont.kerningPairs.size());
+	EXPECT_EQ(U'A', bakedFont.kerningPairs[0].previous);
+	EXPECT_EQ(U'V', bakedFont.kerningPairs[0].current);
+	EXPECT_EQ(-2, bakedFont.kerningPairs[0].amount);
+}
+
+TEST(BakedFont, missingPointSize) {
+	const auto fileData = NAS2D::writeBakedFontFile("font data", {makeBakedFont(10)});
+	EXPECT_THROW(NAS2D::readBakedFont(fileData, 12), std::runtime_error);
+}
+
+TEST(BakedFont, malformed) {
+	auto fileData = NAS2D::writeBakedFontFile("font data", {makeBakedFont(10)});
+	fileData.pop_back();
+	EXPECT_THROW(NAS2D::readBakedFont(fileData, 10), std::runtime_error);
+	EXPECT_THROW(NAS2D::readBakedFont("font data", 10), std::runtime_error);
+	EXPECT_THROW(NAS2D::readBakedFontData("font data"), std::runtime_error);
+}
+
+TEST(BakedFont, malformedRecord) {
+	const auto fileData = NAS2D::writeBakedFontFile("font data", {makeBakedFont(10)});
+	// Magic, version, font data size and contents, point size count
+	const auto recordSizeOffset = 8u + 4u + 4u + 9u + 4u;
+	const auto renderModeOffset = recordSizeOffset + 4u + 4u;
+
+	auto trailingBytes = fileData;
+	trailingBytes[recordSizeOffset] = static_cast<char>(trailingBytes[recordSizeOffset] + 1);
+	trailingBytes.push_back('\0');
+	EXPECT_THROW(NAS2D::readBakedFont(trailingBytes, 10), std::runtime_error);
+
+	auto unknownRenderMode = fileData;
+	unknownRenderMode[renderModeOffset] = 7;
+	EXPECT_THROW(NAS2D::readBakedFont(unknownRenderMode, 10), std::runtime_error);
+
+	EXPECT_NO_THROW(NAS2D::readBakedFont(fileData, 10));
+}
+
+TEST(BakedFont, textureByteSize) {
+	auto bakedFont = makeBakedFont(12);
+	bakedFont.atlasSize = {20, 10};
+	bakedFont.height = 14;
+	bakedFont.glyphs = {{0, 0, 0, 0, 5}, {0, 0, 0, 0, 9}};
+	EXPECT_EQ(20u * 10u * 4u, NAS2D::textureByteSize(bakedFont));
+
+	// Cells are 16x16, as the widest advance of 9 and the height of 14 round up to 16
+	EXPECT_EQ(256u * 256u * 4u, NAS2D::gridTextureByteSize(bakedFont));
+	EXPECT_LT(NAS2D::textureByteSize(bakedFont), NAS2D::gridTextureByteSize(bakedFont));
+}
@@ -0,0 +1,50 @@
+#include "NAS2D/Resource/BinaryData.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+TEST(BinaryData, roundTrip) {
+	std::string data;
+	NAS2D::BinaryWriter writer{data};
+	writer.writeUint32(0x01020304u);
+	writer.writeInt32(-2);
+	writer.writeString("abc");
+	writer.writeBytes("xy");
+	EXPECT_EQ(std::string("\x04\x03\x02\x01", 4), data.substr(0, 4));
+
+	NAS2D::BinaryReader reader{data, "Test data"};
+	EXPECT_EQ(0x01020304u, reader.readUint32());
+	EXPECT_EQ(-2, reader.readInt32());
+	EXPECT_EQ("abc", reader.readString());
+	EXPECT_EQ(2u, reader.remaining());
+	EXPECT_EQ("xy", reader.readBytes(2));
+	EXPECT_NO_THROW(reader.expectEnd());
+}
+
+TEST(BinaryData, truncated) {
+	std::string data;
+	NAS2D::BinaryWriter writer{data};
+	writer.writeString("abc");
+	data.pop_back();
+
+	NAS2D::BinaryReader reader{data, "Test data"};
+	EXPECT_THROW(reader.readString(), std::runtime_error);
+	EXPECT_THROW(NAS2D::BinaryReader("abc", "Test data").readUint32(), std::runtime_error);
+}
+
+TEST(BinaryData, expectRemaining) {
+	NAS2D::BinaryReader reader{"12345678", "Test data"};
+	EXPECT_NO_THROW(reader.expectRemaining(2, 4));
+	EXPECT_THROW(reader.expectRemaining(3, 4), std::runtime_error);
+	EXPECT_THROW(reader.expectRemaining(0xFFFFFFFFu, 4), std::runtime_error);
+}
+
+TEST(BinaryData, expectEnd) {
+	NAS2D::BinaryReader reader{"12345", "Test data"};
+	reader.readUint32();
+	EXPECT_THROW(reader.expectEnd(), std::runtime_error);
+	reader.readBytes(1);
+	EXPECT_NO_THROW(reader.expectEnd());
+}
@@ -0,0 +1,72 @@
+#include "NAS2D/Resource/BitmapGlyphColumns.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace {
+	constexpr std::uint32_t AlphaMask = 0xFF000000;
+	constexpr int MatrixSize = 16;
+	const NAS2D::Vector<int> GlyphSize{4, 3};
+
+
+	// Image of a 16x16 glyph matrix, with rows padded to a longer pitch
+	struct GlyphMatrix
+	{
+		static constexpr std::size_t PixelsPerRow{MatrixSize * 4 + 2};
+
+		std::vector<std::uint32_t> pixels = std::vector<std::uint32_t>(PixelsPerRow * MatrixSize * 3, 0);
+
+		void set(int glyph, int x, int y, std::uint32_t pixel)
+		{
+			const auto imageX = (glyph % MatrixSize) * GlyphSize.x + x;
+			const auto imageY = (glyph / MatrixSize) * GlyphSize.y + y;
+			pixels[static_cast<std::size_t>(imageY) * PixelsPerRow + static_cast<std::size_t>(imageX)] = pixel;
+		}
+
+		std::vector<std::pair<int, int>> columns() const
+		{
+			return NAS2D::bitmapGlyphColumns(pixels.data(), PixelsPerRow, GlyphSize, AlphaMask);
+		}
+	};
+}
+
+
+TEST(BitmapGlyphColumns, emptyCells) {
+	const GlyphMatrix matrix;
+	const auto columns = matrix.columns();
+	ASSERT_EQ(256u, columns.size());
+	for (const auto& column : columns)
+	{
+		EXPECT_EQ((std::pair{0, 0}), column);
+	}
+}
+
+TEST(BitmapGlyphColumns, coveredColumns) {
+	GlyphMatrix matrix;
+	// Covered columns of any row count
+	matrix.set('A', 1, 0, 0xFF000000);
+	matrix.set('A', 2, 2, 0x80000000);
+	// Full width
+	matrix.set('W', 0, 1, 0xFF000000);
+	matrix.set('W', 3, 0, 0x01000000);
+	// Single column, in the last cell of the last row
+	matrix.set(255, 3, 2, 0xFF000000);
+
+	const auto columns = matrix.columns();
+	EXPECT_EQ((std::pair{1, 3}), columns['A']);
+	EXPECT_EQ((std::pair{0, 4}), columns['W']);
+	EXPECT_EQ((std::pair{3, 4}), columns[255]);
+	EXPECT_EQ((std::pair{0, 0}), columns['B']);
+}
+
+TEST(BitmapGlyphColumns, colorWithoutAlphaIsNotCovered) {
+	GlyphMatrix matrix;
+	matrix.set('A', 0, 0, 0x00FFFFFF);
+	matrix.set('A', 2, 1, 0xFF000000);
+
+	const auto columns = matrix.columns();
+	EXPECT_EQ((std::pair{2, 3}), columns['A']);
+}
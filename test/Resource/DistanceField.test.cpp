@@ -0,0 +1,43 @@
+#include "NAS2D/Resource/DistanceField.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+
+TEST(DistanceField, size) {
+	EXPECT_EQ(7u * 5u, NAS2D::distanceField(std::vector<std::uint8_t>(3 * 1, 0), {3, 1}, 2).size());
+	EXPECT_EQ(3u * 1u, NAS2D::distanceField(std::vector<std::uint8_t>(3 * 1, 0), {3, 1}, 0).size());
+}
+
+TEST(DistanceField, empty) {
+	const auto field = NAS2D::distanceField(std::vector<std::uint8_t>(4 * 4, 127), {4, 4}, 2);
+	EXPECT_TRUE(std::all_of(field.begin(), field.end(), [](auto value) { return value == 0; }));
+}
+
+TEST(DistanceField, singlePixel) {
+	const auto field = NAS2D::distanceField({255}, {1, 1}, 2);
+	ASSERT_EQ(25u, field.size());
+
+	const auto at = [&field](std::size_t x, std::size_t y) { return field[y * 5 + x]; };
+	// Inside is above the edge value of 128, outside below
+	EXPECT_EQ(159, at(2, 2));
+	EXPECT_EQ(96, at(1, 2));
+	EXPECT_EQ(96, at(3, 2));
+	EXPECT_EQ(96, at(2, 1));
+	EXPECT_EQ(96, at(2, 3));
+	EXPECT_EQ(69, at(1, 1));
+	EXPECT_EQ(32, at(0, 2));
+	EXPECT_EQ(0, at(0, 0));
+}
+
+TEST(DistanceField, filledSquare) {
+	const auto field = NAS2D::distanceField(std::vector<std::uint8_t>(3 * 3, 255), {3, 3}, 1);
+	ASSERT_EQ(25u, field.size());
+
+	const auto at = [&field](std::size_t x, std::size_t y) { return field[y * 5 + x]; };
+	EXPECT_EQ(255, at(2, 2));
+	EXPECT_EQ(191, at(1, 2));
+	EXPECT_EQ(64, at(0, 2));
+	EXPECT_EQ(11, at(0, 0));
+}
@@ -0,0 +1,32 @@
+#include "NAS2D/Resource/DynamicImage.h"
+#include "NAS2D/Math/Rectangle.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+TEST(DynamicImage, size) {
+	const auto image = NAS2D::DynamicImage{{3, 2}};
+	EXPECT_EQ((NAS2D::Vector{3, 2}), image.size());
+	EXPECT_EQ((NAS2D::Color{0, 0, 0, 0}), image.pixelColor({2, 1}));
+}
+
+TEST(DynamicImage, update) {
+	auto image = NAS2D::DynamicImage{{3, 2}};
+
+	const uint8_t pixels[]{1, 2, 3, 4, 5, 6, 7, 8};
+	image.update({{1, 0}, {1, 2}}, pixels);
+	EXPECT_EQ((NAS2D::Color{0, 0, 0, 0}), image.pixelColor({0, 0}));
+	EXPECT_EQ((NAS2D::Color{1, 2, 3, 4}), image.pixelColor({1, 0}));
+	EXPECT_EQ((NAS2D::Color{5, 6, 7, 8}), image.pixelColor({1, 1}));
+	EXPECT_EQ((NAS2D::Color{0, 0, 0, 0}), image.pixelColor({2, 1}));
+
+	// Region from a larger source buffer
+	const uint8_t source[]{9, 9, 9, 9, 10, 11, 12, 13, 9, 9, 9, 9, 14, 15, 16, 17};
+	image.update({{2, 0}, {1, 2}}, source + 4, 8);
+	EXPECT_EQ((NAS2D::Color{10, 11, 12, 13}), image.pixelColor({2, 0}));
+	EXPECT_EQ((NAS2D::Color{14, 15, 16, 17}), image.pixelColor({2, 1}));
+
+	EXPECT_THROW(image.update({{2, 1}, {2, 1}}, pixels), std::runtime_error);
+}
@@ -0,0 +1,25 @@
+#include "TestFont.h"
+
+#include <gtest/gtest.h>
+
+
+namespace {
+	void narrowLetterI(std::vector<NAS2D::Font::GlyphMetrics>& metrics) {
+		metrics['i'].advance = 4;
+	}
+}
+
+
+TEST(Font, width) {
+	const TestFont font{narrowLetterI};
+	EXPECT_EQ(0, font.width(""));
+	EXPECT_EQ(24, font.width("aib"));
+	EXPECT_EQ((NAS2D::Vector{24, 16}), font.size("aib"));
+}
+
+TEST(Font, widthScaled) {
+	const TestFont font{narrowLetterI};
+	EXPECT_FLOAT_EQ(0.0f, font.width("", 2.0f));
+	EXPECT_FLOAT_EQ(48.0f, font.width("aib", 2.0f));
+	EXPECT_FLOAT_EQ(12.0f, font.width("aib", 0.5f));
+}
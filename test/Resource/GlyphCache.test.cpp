@@ -0,0 +1,118 @@
+#include "NAS2D/Resource/GlyphCache.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+
+TEST(GlyphCache, invalidFontData) {
+	EXPECT_THROW((NAS2D::GlyphCache{"Not a font", 12}), std::runtime_error);
+}
+
+TEST(GlyphPageUsage, leastRecentlyUsed) {
+	NAS2D::GlyphPageUsage pageUsage;
+	EXPECT_EQ(NAS2D::GlyphPageUsage::NoPage, pageUsage.leastRecentlyUsed());
+
+	pageUsage.addPage();
+	pageUsage.addPage();
+	pageUsage.addPage();
+	EXPECT_EQ(3u, pageUsage.pageCount());
+
+	pageUsage.use(0);
+	pageUsage.use(2);
+	pageUsage.use(1);
+	pageUsage.beginBatch();
+	EXPECT_EQ(0u, pageUsage.leastRecentlyUsed());
+
+	pageUsage.beginBatch();
+	pageUsage.use(0);
+	pageUsage.beginBatch();
+	EXPECT_EQ(2u, pageUsage.leastRecentlyUsed());
+}
+
+TEST(GlyphPageUsage, batchPagesAreNotEvicted) {
+	NAS2D::GlyphPageUsage pageUsage;
+	pageUsage.addPage();
+	pageUsage.addPage();
+
+	pageUsage.beginBatch();
+	pageUsage.use(0);
+	EXPECT_TRUE(pageUsage.isInBatch(0));
+	EXPECT_FALSE(pageUsage.isInBatch(1));
+	EXPECT_EQ(1u, pageUsage.leastRecentlyUsed());
+
+	// A page holding glyphs queued for the current batch must be kept, even if least recently used
+	pageUsage.use(1);
+	EXPECT_EQ(NAS2D::GlyphPageUsage::NoPage, pageUsage.leastRecentlyUsed());
+
+	pageUsage.beginBatch();
+	EXPECT_FALSE(pageUsage.isInBatch(0));
+	EXPECT_EQ(0u, pageUsage.leastRecentlyUsed());
+}
+
+TEST(GlyphPageUsage, generation) {
+	NAS2D::GlyphPageUsage pageUsage;
+	pageUsage.addPage();
+	pageUsage.addPage();
+	EXPECT_EQ(0u, pageUsage.generation(0));
+	EXPECT_EQ(0u, pageUsage.generation(1));
+
+	// Only the evicted page changes, so users of other pages keep their glyphs
+	pageUsage.evict(1);
+	EXPECT_EQ(0u, pageUsage.generation(0));
+	EXPECT_EQ(1u, pageUsage.generation(1));
+
+	pageUsage.use(1);
+	EXPECT_EQ(1u, pageUsage.generation(1));
+}
+
+namespace
+{
+	int textKerning(NAS2D::KerningTable& kerningTable, std::u32string_view text)
+	{
+		int kerning = 0;
+		for (std::size_t index = 1; index < text.size(); ++index)
+		{
+			kerning += kerningTable.kerning(text[index - 1], text[index]);
+		}
+		return kerning;
+	}
+}
+
+TEST(KerningTable, repeatedTextDoesNotQueryFont) {
+	int queryCount = 0;
+	NAS2D::KerningTable kerningTable{[&queryCount](char32_t, char32_t) { ++queryCount; return -1; }};
+	kerningTable.preload(256, {{U'A', U'V', -2}, {U'V', U'A', -3}});
+
+	// Preloaded characters are never queried, even on first use
+	EXPECT_EQ(-5, textKerning(kerningTable, U"AVA TAR"));
+	EXPECT_EQ(0, queryCount);
+
+	// Other pairs are queried once, then cached
+	EXPECT_EQ(-2, textKerning(kerningTable, U"Жук"));
+	EXPECT_EQ(2, queryCount);
+	EXPECT_EQ(-2, textKerning(kerningTable, U"Жук"));
+	EXPECT_EQ(-5, textKerning(kerningTable, U"AVA TAR"));
+	EXPECT_EQ(2, queryCount);
+	EXPECT_EQ(2u, kerningTable.cachedPairCount());
+}
+
+TEST(KerningTable, leastRecentlyUsedPairIsEvicted) {
+	std::u32string queries;
+	NAS2D::KerningTable kerningTable{[&queries](char32_t previous, char32_t) { queries += previous; return 0; }, 2};
+
+	kerningTable.kerning(U'Ж', U'a');
+	kerningTable.kerning(U'Д', U'a');
+	kerningTable.kerning(U'Ж', U'a');
+	EXPECT_EQ(U"ЖД", queries);
+
+	// Only the least recently used pair is evicted, not the whole cache
+	kerningTable.kerning(U'Ф', U'a');
+	EXPECT_EQ(2u, kerningTable.cachedPairCount());
+	kerningTable.kerning(U'Ж', U'a');
+	EXPECT_EQ(U"ЖДФ", queries);
+	kerningTable.kerning(U'Д', U'a');
+	EXPECT_EQ(U"ЖДФД", queries);
+}
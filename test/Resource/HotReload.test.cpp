@@ -0,0 +1,81 @@
+#include "NAS2D/Resource/HotReload.h"
+#include "NAS2D/Resource/AnimationSet.h"
+#include "NAS2D/Resource/SpriteCaches.h"
+#include "NAS2D/Filesystem.h"
+#include "NAS2D/Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+class HotReload : public ::testing::Test {
+protected:
+	static constexpr auto AppName = "NAS2DUnitTests";
+	static constexpr auto OrganizationName = "LairWorks";
+	static constexpr auto SpriteFileName = "HotReloadTest.sprite";
+	static constexpr auto SpriteXml = "<sprite version=\"0.99\"></sprite>";
+
+	class Handler {
+	public:
+		void onReload(const std::string& filePath) { reloaded.push_back(filePath); }
+		void onReloadFailed(const std::string& filePath, const std::string&) { failed.push_back(filePath); }
+
+		std::vector<std::string> reloaded;
+		std::vector<std::string> failed;
+	};
+
+	HotReload() :
+		fs(NAS2D::Utility<NAS2D::Filesystem>::init(AppName, OrganizationName))
+	{
+		fs.mountReadWrite(fs.prefPath());
+		fs.writeFile(SpriteFileName, SpriteXml);
+		NAS2D::spriteAnimationCache().load(SpriteFileName);
+	}
+
+	~HotReload() override {
+		NAS2D::spriteAnimationCache().unload(SpriteFileName);
+		fs.del(SpriteFileName);
+		NAS2D::Utility<NAS2D::Filesystem>::clear();
+	}
+
+	// Keeps changing the file until update reports a result, as the first poll only records modification times
+	void touchUntil(NAS2D::HotReload& hotReload, const std::vector<std::string>& results) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+		while (results.empty() && std::chrono::steady_clock::now() < deadline) {
+			std::filesystem::last_write_time(fs.prefPath() / SpriteFileName, fs.lastWriteTime(SpriteFileName) + std::chrono::seconds{1});
+			std::this_thread::sleep_for(std::chrono::milliseconds{5});
+			hotReload.update();
+		}
+	}
+
+	NAS2D::Filesystem& fs;
+	Handler handler;
+};
+
+
+TEST_F(HotReload, reloadChangedSpriteFile) {
+	NAS2D::HotReload hotReload{std::chrono::milliseconds{1}};
+	hotReload.reloadSignalSource().connect({&handler, &Handler::onReload});
+	hotReload.reloadFailedSignalSource().connect({&handler, &Handler::onReloadFailed});
+
+	touchUntil(hotReload, handler.reloaded);
+	ASSERT_FALSE(handler.reloaded.empty());
+	EXPECT_EQ(SpriteFileName, handler.reloaded.front());
+	EXPECT_TRUE(handler.failed.empty());
+}
+
+TEST_F(HotReload, reportFailedSpriteFile) {
+	NAS2D::HotReload hotReload{std::chrono::milliseconds{1}};
+	hotReload.reloadSignalSource().connect({&handler, &Handler::onReload});
+	hotReload.reloadFailedSignalSource().connect({&handler, &Handler::onReloadFailed});
+
+	fs.writeFile(SpriteFileName, "<sprite>");
+	touchUntil(hotReload, handler.failed);
+	ASSERT_FALSE(handler.failed.empty());
+	EXPECT_EQ(SpriteFileName, handler.failed.front());
+	EXPECT_TRUE(handler.reloaded.empty());
+}
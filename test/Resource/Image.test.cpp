@@ -1,7 +1,10 @@
 #include "NAS2D/Resource/Image.h"
+#include "NAS2D/Math/Rectangle.h"
 
 #include <gtest/gtest.h>
 
+#include <stdexcept>
+
 
 TEST(Image, size) {
 	{
@@ -20,3 +23,39 @@ TEST(Image, size) {
 		EXPECT_EQ((NAS2D::Vector{1, 2}), image.size());
 	}
 }
+
+TEST(Image, filter) {
+	uint32_t buffer[1 * 1]{};
+	EXPECT_EQ(NAS2D::TextureFilter::Linear, (NAS2D::Image{&buffer, 4, {1, 1}}.filter()));
+	EXPECT_EQ(NAS2D::TextureFilter::Nearest, (NAS2D::Image{&buffer, 4, {1, 1}, NAS2D::TextureFilter::Nearest}.filter()));
+	EXPECT_EQ(NAS2D::TextureFilter::Trilinear, (NAS2D::Image{&buffer, 4, {1, 1}, NAS2D::TextureFilter::Trilinear}.filter()));
+}
+
+TEST(Image, opaqueBounds) {
+	const uint32_t o = 0xFF000000;
+	uint32_t buffer[5 * 4]{
+		0, 0, 0, 0, 0,
+		0, 0, o, 0, 0,
+		0, o, 0, 0, 0,
+		0, 0, 0, o, 0,
+	};
+	const auto image = NAS2D::Image{&buffer, 4, {5, 4}};
+	EXPECT_EQ((NAS2D::Rectangle<int>{{1, 1}, {3, 3}}), image.opaqueBounds({{0, 0}, {5, 4}}));
+	EXPECT_EQ((NAS2D::Rectangle<int>{{2, 1}, {1, 1}}), image.opaqueBounds({{2, 0}, {1, 3}}));
+	EXPECT_TRUE(image.opaqueBounds({{4, 0}, {1, 4}}).empty());
+	EXPECT_THROW(image.opaqueBounds({{1, 1}, {5, 4}}), std::runtime_error);
+}
+
+TEST(Image, swap) {
+	uint32_t buffer1[1 * 1]{0xFF0000FF};
+	uint32_t buffer2[2 * 1]{0xFF00FF00, 0xFF00FF00};
+	auto image1 = NAS2D::Image{&buffer1, 4, {1, 1}, NAS2D::TextureFilter::Nearest};
+	auto image2 = NAS2D::Image{&buffer2, 4, {2, 1}};
+
+	image1.swap(image2);
+	EXPECT_EQ((NAS2D::Vector{2, 1}), image1.size());
+	EXPECT_EQ(NAS2D::Color::Green, image1.pixelColor({1, 0}));
+	EXPECT_EQ(NAS2D::TextureFilter::Nearest, image1.filter());
+	EXPECT_EQ((NAS2D::Vector{1, 1}), image2.size());
+	EXPECT_EQ(NAS2D::Color::Red, image2.pixelColor({0, 0}));
+}
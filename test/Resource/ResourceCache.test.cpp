@@ -2,6 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 
 TEST(ResourceCache, load) {
 	class MockResource {
@@ -48,3 +53,71 @@ TEST(ResourceCache, load) {
 	EXPECT_NO_THROW(cache.clear());
 	EXPECT_EQ(0u, cache.size());
 }
+
+TEST(ResourceCache, loadConcurrent) {
+	static std::atomic<int> constructionCount{0};
+	class MockResource {
+	public:
+		MockResource(int initValue) :
+			value{initValue}
+		{
+			++constructionCount;
+		}
+
+		int value;
+	};
+
+	NAS2D::ResourceCache<MockResource, int> cache;
+
+	std::vector<std::thread> threads;
+	std::vector<const MockResource*> loaded(8);
+	for (std::size_t i = 0; i < loaded.size(); ++i) {
+		threads.emplace_back([&cache, &loaded, i]() {
+			for (int value = 0; value < 100; ++value) {
+				cache.load(value);
+			}
+			loaded[i] = &cache.load(0);
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(100, constructionCount);
+	EXPECT_EQ(100u, cache.size());
+	for (const auto* resource : loaded) {
+		EXPECT_EQ(loaded.front(), resource);
+	}
+}
+
+TEST(ResourceCache, loadThrows) {
+	class MockResource {
+	public:
+		MockResource(int initValue) {
+			if (initValue < 0) {
+				throw std::runtime_error("Negative value");
+			}
+		}
+	};
+
+	NAS2D::ResourceCache<MockResource, int> cache;
+
+	EXPECT_THROW(cache.load(-1), std::runtime_error);
+	EXPECT_EQ(0u, cache.size());
+	EXPECT_NO_THROW(cache.load(1));
+	EXPECT_EQ(1u, cache.size());
+}
+
+TEST(ResourceCache, findKeys) {
+	NAS2D::ResourceCache<std::string, std::string> cache;
+	EXPECT_EQ(nullptr, cache.find("abc"));
+
+	const auto& value = cache.load("abc");
+	cache.load("def");
+	EXPECT_EQ(&value, cache.find("abc"));
+	EXPECT_EQ((std::vector<std::tuple<std::string>>{{"abc"}, {"def"}}), cache.keys());
+
+	// Resources can be changed in place, keeping references valid
+	*cache.find("abc") = "xyz";
+	EXPECT_EQ("xyz", value);
+}
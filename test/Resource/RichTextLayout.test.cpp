@@ -0,0 +1,64 @@
+#include "NAS2D/Resource/RichTextLayout.h"
+
+#include <gtest/gtest.h>
+
+
+TEST(RichTextLayout, parseMarkupPlainText) {
+	const auto markupText = NAS2D::parseMarkup("abc", NAS2D::Color::Red);
+	EXPECT_EQ("abc", markupText.text);
+	ASSERT_EQ(3u, markupText.styles.size());
+	for (const auto& style : markupText.styles)
+	{
+		EXPECT_EQ(NAS2D::Color::Red, style.color);
+		EXPECT_FALSE(style.hasShadow);
+	}
+}
+
+TEST(RichTextLayout, parseMarkupColor) {
+	const auto markupText = NAS2D::parseMarkup("a[color=00FF00]b[color=0000FF80]c[/color]d[/color]e");
+	EXPECT_EQ("abcde", markupText.text);
+	ASSERT_EQ(5u, markupText.styles.size());
+	EXPECT_EQ(NAS2D::Color::White, markupText.styles[0].color);
+	EXPECT_EQ((NAS2D::Color{0, 255, 0}), markupText.styles[1].color);
+	EXPECT_EQ((NAS2D::Color{0, 0, 255, 128}), markupText.styles[2].color);
+	EXPECT_EQ((NAS2D::Color{0, 255, 0}), markupText.styles[3].color);
+	EXPECT_EQ(NAS2D::Color::White, markupText.styles[4].color);
+}
+
+TEST(RichTextLayout, parseMarkupAlpha) {
+	const auto markupText = NAS2D::parseMarkup("[alpha=64]a[color=#FF0000]b[/color][/alpha]c");
+	EXPECT_EQ("abc", markupText.text);
+	ASSERT_EQ(3u, markupText.styles.size());
+	EXPECT_EQ((NAS2D::Color{255, 255, 255, 64}), markupText.styles[0].color);
+	EXPECT_EQ((NAS2D::Color{255, 0, 0, 64}), markupText.styles[1].color);
+	EXPECT_EQ(NAS2D::Color::White, markupText.styles[2].color);
+}
+
+TEST(RichTextLayout, parseMarkupShadow) {
+	const auto markupText = NAS2D::parseMarkup("[shadow]a[shadow=FF000080]b[/shadow][/shadow]c");
+	EXPECT_EQ("abc", markupText.text);
+	ASSERT_EQ(3u, markupText.styles.size());
+	EXPECT_TRUE(markupText.styles[0].hasShadow);
+	EXPECT_EQ(NAS2D::Color::Black, markupText.styles[0].shadowColor);
+	EXPECT_TRUE(markupText.styles[1].hasShadow);
+	EXPECT_EQ((NAS2D::Color{255, 0, 0, 128}), markupText.styles[1].shadowColor);
+	EXPECT_FALSE(markupText.styles[2].hasShadow);
+}
+
+TEST(RichTextLayout, parseMarkupLiteralText) {
+	EXPECT_EQ("[a]", NAS2D::parseMarkup("[[a]").text);
+	EXPECT_EQ("[b]", NAS2D::parseMarkup("[b]").text);
+	EXPECT_EQ("[color=red]", NAS2D::parseMarkup("[color=red]").text);
+	EXPECT_EQ("[alpha=256]", NAS2D::parseMarkup("[alpha=256]").text);
+	EXPECT_EQ("[/color]", NAS2D::parseMarkup("[/color]").text);
+	EXPECT_EQ("[color", NAS2D::parseMarkup("[color").text);
+}
+
+TEST(RichTextLayout, parseMarkupMultibyte) {
+	const auto markupText = NAS2D::parseMarkup("[color=FF0000]\xC3\xA9\n[/color]x");
+	EXPECT_EQ("\xC3\xA9\nx", markupText.text);
+	ASSERT_EQ(3u, markupText.styles.size());
+	EXPECT_EQ(NAS2D::Color::Red, markupText.styles[0].color);
+	EXPECT_EQ(NAS2D::Color::Red, markupText.styles[1].color);
+	EXPECT_EQ(NAS2D::Color::White, markupText.styles[2].color);
+}
@@ -0,0 +1,86 @@
+#include "NAS2D/Resource/SkeletalSprite.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+
+class SkeletalSprite : public ::testing::Test {
+protected:
+	// Use a derived class to access protected methods
+	class SkeletalSpriteDerived : public NAS2D::SkeletalSprite {
+	public:
+		SkeletalSpriteDerived(const NAS2D::Skeleton& skeleton, const std::string& initialAnimation) :
+			NAS2D::SkeletalSprite{skeleton, initialAnimation}
+		{}
+		// Re-export protected method as public
+		using NAS2D::SkeletalSprite::advanceByTimeDelta;
+	};
+
+	class MockHandler {
+	public:
+		MOCK_CONST_METHOD0(MockMethod, void());
+	};
+
+	NAS2D::Skeleton skeleton{
+		{{"body", NAS2D::Skeleton::NoParent, {}}},
+		{},
+		{{"loop", {100, true, {}}}, {"once", {100, false, {}}}},
+	};
+	SkeletalSpriteDerived sprite{skeleton, "loop"};
+	MockHandler handler{};
+};
+
+
+TEST_F(SkeletalSprite, advanceLooping) {
+	sprite.animationCompleteSignalSource().connect({&handler, &MockHandler::MockMethod});
+
+	EXPECT_CALL(handler, MockMethod()).Times(0);
+	sprite.advanceByTimeDelta(99);
+	EXPECT_EQ(99u, sprite.time());
+	testing::Mock::VerifyAndClearExpectations(&handler);
+
+	EXPECT_CALL(handler, MockMethod());
+	sprite.advanceByTimeDelta(1);
+	EXPECT_EQ(0u, sprite.time());
+	testing::Mock::VerifyAndClearExpectations(&handler);
+
+	// Each wrap signals completion
+	EXPECT_CALL(handler, MockMethod()).Times(2);
+	sprite.advanceByTimeDelta(250);
+	EXPECT_EQ(50u, sprite.time());
+}
+
+TEST_F(SkeletalSprite, advanceOnce) {
+	sprite.play("once");
+	sprite.animationCompleteSignalSource().connect({&handler, &MockHandler::MockMethod});
+
+	// Stops at the end, and signals once
+	EXPECT_CALL(handler, MockMethod());
+	sprite.advanceByTimeDelta(250);
+	EXPECT_EQ(100u, sprite.time());
+	sprite.advanceByTimeDelta(100);
+	EXPECT_EQ(100u, sprite.time());
+	testing::Mock::VerifyAndClearExpectations(&handler);
+
+	EXPECT_CALL(handler, MockMethod());
+	sprite.play("once");
+	EXPECT_EQ(0u, sprite.time());
+	sprite.advanceByTimeDelta(100);
+}
+
+TEST_F(SkeletalSprite, pauseAndSeek) {
+	sprite.pause();
+	sprite.advanceByTimeDelta(50);
+	EXPECT_EQ(0u, sprite.time());
+
+	sprite.resume();
+	sprite.advanceByTimeDelta(50);
+	EXPECT_EQ(50u, sprite.time());
+
+	sprite.seek(230);
+	EXPECT_EQ(30u, sprite.time());
+
+	sprite.play("once");
+	sprite.seek(230);
+	EXPECT_EQ(100u, sprite.time());
+}
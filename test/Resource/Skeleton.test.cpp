@@ -0,0 +1,196 @@
+#include "NAS2D/Resource/Skeleton.h"
+#include "NAS2D/Math/Trig.h"
+#include "NAS2D/Filesystem.h"
+#include "NAS2D/Utility.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+	using Skeleton = NAS2D::Skeleton;
+
+	// Body at the origin, with an arm 10 pixels to the right, and a hand 5 pixels further
+	std::vector<Skeleton::Bone> bones() {
+		return {
+			{"body", Skeleton::NoParent, {{0, 0}, 0}},
+			{"arm", 0, {{10, 0}, 0}},
+			{"hand", 1, {{5, 0}, 0}},
+		};
+	}
+
+	std::map<std::string, Skeleton::Animation> animations() {
+		return {
+			{"still", {0, true, {}}},
+			{"raise", {1000, false, {{1, {{0, {{10, 0}, 0}}, {1000, {{10, 0}, 90}}}}}}},
+			{"swing", {1000, true, {{0, {{0, {{0, 0}, 0}}, {500, {{0, 0}, 180}}, {1000, {{0, 0}, 0}}}}}}},
+		};
+	}
+}
+
+
+TEST(Skeleton, animationId) {
+	const Skeleton skeleton{bones(), {}, animations()};
+	EXPECT_EQ((std::vector<std::string>{"raise", "still", "swing"}), skeleton.animationNames());
+	EXPECT_EQ(1000u, skeleton.animation(skeleton.animationId("raise")).duration);
+	EXPECT_THROW(skeleton.animationId("missing"), std::runtime_error);
+}
+
+TEST(Skeleton, invalidBones) {
+	EXPECT_THROW((Skeleton{{{"child", 1, {}}, {"parent", Skeleton::NoParent, {}}}, {}, {}}), std::runtime_error);
+	EXPECT_THROW((Skeleton{bones(), {}, {{"bad", {100, true, {{3, {{0, {}}}}}}}}}), std::runtime_error);
+	EXPECT_THROW((Skeleton{bones(), {}, {{"empty", {100, true, {{0, {}}}}}}}), std::runtime_error);
+}
+
+TEST(Skeleton, poseBind) {
+	const Skeleton skeleton{bones(), {}, animations()};
+	Skeleton::Pose pose;
+
+	skeleton.pose(skeleton.animationId("still"), 0, {{100, 50}, 0}, pose);
+	ASSERT_EQ(3u, pose.x.size());
+	EXPECT_FLOAT_EQ(100, pose.x[0]);
+	EXPECT_FLOAT_EQ(110, pose.x[1]);
+	EXPECT_FLOAT_EQ(115, pose.x[2]);
+	EXPECT_FLOAT_EQ(50, pose.y[2]);
+
+	// Root rotation turns the whole skeleton
+	skeleton.pose(skeleton.animationId("still"), 0, {{100, 50}, 90}, pose);
+	EXPECT_NEAR(100, pose.x[2], 0.001f);
+	EXPECT_NEAR(65, pose.y[2], 0.001f);
+	EXPECT_FLOAT_EQ(90, pose.rotation[2]);
+}
+
+TEST(Skeleton, poseInterpolates) {
+	const Skeleton skeleton{bones(), {}, animations()};
+	const auto raise = skeleton.animationId("raise");
+	Skeleton::Pose pose;
+
+	skeleton.pose(raise, 500, {}, pose);
+	EXPECT_FLOAT_EQ(10, pose.x[1]);
+	EXPECT_FLOAT_EQ(45, pose.rotation[1]);
+	EXPECT_FLOAT_EQ(45, pose.rotation[2]);
+	EXPECT_NEAR(10 + 5 * std::cos(NAS2D::PI / 4), pose.x[2], 0.001f);
+	EXPECT_NEAR(5 * std::sin(NAS2D::PI / 4), pose.y[2], 0.001f);
+
+	// Non looping animations hold their last keyframe
+	skeleton.pose(raise, 5000, {}, pose);
+	EXPECT_FLOAT_EQ(90, pose.rotation[1]);
+	EXPECT_NEAR(10, pose.x[2], 0.001f);
+	EXPECT_NEAR(5, pose.y[2], 0.001f);
+}
+
+TEST(Skeleton, poseLoops) {
+	const Skeleton skeleton{bones(), {}, animations()};
+	const auto swing = skeleton.animationId("swing");
+	Skeleton::Pose pose;
+
+	skeleton.pose(swing, 2250, {}, pose);
+	EXPECT_FLOAT_EQ(90, pose.rotation[0]);
+	EXPECT_FLOAT_EQ(90, pose.rotation[2]);
+	EXPECT_NEAR(0, pose.x[2], 0.001f);
+	EXPECT_NEAR(15, pose.y[2], 0.001f);
+}
+
+
+class SkeletonFile : public ::testing::Test {
+protected:
+	static constexpr auto AppName = "NAS2DUnitTests";
+	static constexpr auto OrganizationName = "LairWorks";
+	static constexpr auto FileName = "SkeletonTest.xml";
+
+	SkeletonFile() :
+		fs(NAS2D::Utility<NAS2D::Filesystem>::init(AppName, OrganizationName))
+	{
+		fs.mountReadWrite(fs.prefPath());
+	}
+
+	~SkeletonFile() override {
+		if (fs.exists(FileName)) {
+			fs.del(FileName);
+		}
+		NAS2D::Utility<NAS2D::Filesystem>::clear();
+	}
+
+	Skeleton load(const std::string& xml) {
+		fs.writeFile(FileName, xml);
+		return Skeleton{FileName};
+	}
+
+	// Loads a skeleton with the given elements, expecting an error message containing the given text
+	void expectError(const std::string& elements, const std::string& messagePart) {
+		const auto xml = "<skeleton version=\"1.0\">\n" + elements + "</skeleton>\n";
+		try {
+			load(xml);
+			ADD_FAILURE() << "Expected error: " << messagePart;
+		}
+		catch (const std::runtime_error& error) {
+			EXPECT_THAT(error.what(), testing::HasSubstr(messagePart));
+		}
+	}
+
+	NAS2D::Filesystem& fs;
+};
+
+
+TEST_F(SkeletonFile, parse) {
+	const auto skeleton = load(
+		"<skeleton version=\"1.0\">\n"
+		"	<bone name=\"body\" />\n"
+		"	<bone name=\"arm\" parent=\"body\" x=\"10\" y=\"-4\" rotation=\"15\" />\n"
+		"	<animation name=\"wave\" duration=\"1000\">\n"
+		"		<key bone=\"arm\" time=\"500\" rotation=\"30\" />\n"
+		"		<key bone=\"arm\" time=\"0\" y=\"2\" />\n"
+		"	</animation>\n"
+		"	<animation name=\"rest\" duration=\"200\" loop=\"false\" />\n"
+		"</skeleton>\n"
+	);
+
+	const auto& bones = skeleton.bones();
+	ASSERT_EQ(2u, bones.size());
+	EXPECT_EQ("body", bones[0].name);
+	EXPECT_EQ(Skeleton::NoParent, bones[0].parent);
+	EXPECT_EQ("arm", bones[1].name);
+	EXPECT_EQ(0u, bones[1].parent);
+	EXPECT_EQ((NAS2D::Vector<float>{10, -4}), bones[1].transform.position);
+	EXPECT_FLOAT_EQ(15, bones[1].transform.rotation);
+	EXPECT_TRUE(skeleton.parts().empty());
+
+	EXPECT_EQ((std::vector<std::string>{"rest", "wave"}), skeleton.animationNames());
+	const auto& rest = skeleton.animation(skeleton.animationId("rest"));
+	EXPECT_EQ(200u, rest.duration);
+	EXPECT_FALSE(rest.loops);
+	EXPECT_TRUE(rest.tracks.empty());
+
+	// Keys are sorted by time, and values left out keep those of the bone
+	const auto& wave = skeleton.animation(skeleton.animationId("wave"));
+	EXPECT_EQ(1000u, wave.duration);
+	EXPECT_TRUE(wave.loops);
+	ASSERT_EQ(1u, wave.tracks.size());
+	EXPECT_EQ(1u, wave.tracks[0].bone);
+	const auto& keyframes = wave.tracks[0].keyframes;
+	ASSERT_EQ(2u, keyframes.size());
+	EXPECT_EQ(0u, keyframes[0].time);
+	EXPECT_EQ((NAS2D::Vector<float>{10, 2}), keyframes[0].transform.position);
+	EXPECT_FLOAT_EQ(15, keyframes[0].transform.rotation);
+	EXPECT_EQ(500u, keyframes[1].time);
+	EXPECT_EQ((NAS2D::Vector<float>{10, -4}), keyframes[1].transform.position);
+	EXPECT_FLOAT_EQ(30, keyframes[1].transform.rotation);
+}
+
+TEST_F(SkeletonFile, parseErrors) {
+	EXPECT_THROW(load("<skeleton"), std::runtime_error);
+	EXPECT_THROW(load("<sprite version=\"1.0\" />"), std::runtime_error);
+	EXPECT_THROW(load("<skeleton version=\"0.9\" />"), std::runtime_error);
+
+	expectError("<bone />\n", "Missing names: {name}");
+	expectError("<bone name=\"\" />\n", "'name' of length zero:  (Row: 2)");
+	expectError("<bone name=\"a\" />\n<bone name=\"a\" />\n", "bone redefinition: 'a'  (Row: 3)");
+	expectError("<bone name=\"a\" parent=\"b\" />\n<bone name=\"b\" />\n", "undefined bone: 'b'  (Row: 2)");
+	expectError("<imagesheet id=\"sheet\" />\n", "Missing names: {src}");
+	expectError("<bone name=\"a\" />\n<part bone=\"a\" sheetid=\"sheet\" x=\"0\" y=\"0\" width=\"1\" height=\"1\" anchorx=\"0\" anchory=\"0\" />\n", "undefined imagesheet: 'sheet'  (Row: 3)");
+	expectError("<bone name=\"a\" />\n<animation name=\"idle\" duration=\"10\">\n<key bone=\"b\" time=\"0\" />\n</animation>\n", "undefined bone: 'b'  (Row: 4)");
+	expectError("<animation name=\"idle\" duration=\"10\" />\n<animation name=\"idle\" duration=\"10\" />\n", "animation redefinition: 'idle'  (Row: 3)");
+}
@@ -67,3 +67,77 @@ TEST_F(Sprite, animationCompleteSignal) {
 		sprite.advanceByTimeDelta(i);
 	}
 }
+
+TEST_F(Sprite, playActionId) {
+	const auto actionId = sprite.actionId("frameStopAction");
+	EXPECT_EQ(actionId, testAnimationSet.actionId("frameStopAction"));
+	EXPECT_NE(actionId, sprite.actionId("defaultAction"));
+	EXPECT_THROW(sprite.actionId("undefinedAction"), std::runtime_error);
+
+	sprite.play(actionId);
+	EXPECT_EQ(0u, sprite.advanceByTimeDelta(1u));
+	EXPECT_EQ(0u, sprite.advanceByTimeDelta(2u));
+}
+
+TEST_F(Sprite, animationSetActions) {
+	EXPECT_EQ((std::vector<std::string>{"defaultAction", "frameStopAction"}), testAnimationSet.actionNames());
+	EXPECT_EQ(&testAnimationSet.frames("defaultAction"), &testAnimationSet.frames(testAnimationSet.actionId("defaultAction")));
+	EXPECT_THROW(testAnimationSet.frames(NAS2D::AnimationSet::ActionId{2}), std::runtime_error);
+}
+
+TEST_F(Sprite, animationSetTimeline) {
+	const auto defaultAction = testAnimationSet.actionId("defaultAction");
+	const auto frameStopAction = testAnimationSet.actionId("frameStopAction");
+	EXPECT_EQ(frame.frameDelay, testAnimationSet.duration(defaultAction));
+	EXPECT_EQ(0u, testAnimationSet.duration(frameStopAction));
+
+	const auto loops = 1000000u;
+	const auto result = testAnimationSet.advance(defaultAction, 0, loops * frame.frameDelay + 1);
+	EXPECT_EQ(0u, result.frameIndex);
+	EXPECT_EQ(loops * frame.frameDelay, result.elapsed);
+	EXPECT_EQ(loops, result.completions);
+	EXPECT_FALSE(result.stopped);
+
+	const auto stopResult = testAnimationSet.advance(frameStopAction, 0, loops);
+	EXPECT_EQ(0u, stopResult.frameIndex);
+	EXPECT_EQ(1u, stopResult.completions);
+	EXPECT_TRUE(stopResult.stopped);
+}
+
+TEST_F(Sprite, animationSetReload) {
+	const auto defaultAction = testAnimationSet.actionId("defaultAction");
+	const auto* defaultFrames = &testAnimationSet.frames(defaultAction);
+	sprite.setFrame(0);
+
+	testAnimationSet.reload(NAS2D::AnimationSet{{}, {{"defaultAction", {frameStop, frame}}, {"newAction", {frame}}}});
+	EXPECT_EQ(defaultAction, testAnimationSet.actionId("defaultAction"));
+	EXPECT_EQ(defaultFrames, &testAnimationSet.frames(defaultAction));
+	EXPECT_EQ(2u, testAnimationSet.frames(defaultAction).size());
+	EXPECT_EQ(NAS2D::AnimationSet::ActionId{2}, testAnimationSet.actionId("newAction"));
+	EXPECT_EQ(1u, testAnimationSet.frames("frameStopAction").size());
+
+	// Sprite now plays the reloaded frames
+	EXPECT_EQ(0u, sprite.advanceByTimeDelta(10));
+	EXPECT_EQ(sprite.size(), frameStop.size());
+}
+
+TEST_F(Sprite, copyAndMove) {
+	sprite.rotation(90.0f);
+	sprite.color(NAS2D::Color::Red);
+
+	SpriteDerived copy{sprite};
+	EXPECT_EQ(90.0f, copy.rotation());
+	EXPECT_EQ(NAS2D::Color::Red, copy.color());
+
+	// Copies animate independently
+	copy.rotation(45.0f);
+	EXPECT_EQ(90.0f, sprite.rotation());
+	sprite.play("frameStopAction");
+	sprite.advanceByTimeDelta(0u);
+	EXPECT_EQ(0u, sprite.advanceByTimeDelta(2u));
+	EXPECT_EQ(2u, copy.advanceByTimeDelta(2u));
+
+	SpriteDerived moved{std::move(copy)};
+	EXPECT_EQ(45.0f, moved.rotation());
+	EXPECT_EQ(2u, moved.advanceByTimeDelta(2u));
+}
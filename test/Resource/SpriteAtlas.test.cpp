@@ -0,0 +1,75 @@
+#include "NAS2D/Resource/SpriteAtlas.h"
+#include "NAS2D/Resource/AnimationSet.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace {
+	constexpr uint32_t Opaque = 0xFF000000;
+	constexpr uint32_t Red = Opaque | 0x0000FF;
+	constexpr uint32_t Green = Opaque | 0x00FF00;
+}
+
+
+TEST(SpriteAtlas, add) {
+	uint32_t pixels[4 * 4] = {
+		0, 0, 0, 0,
+		0, 0, 0, 0,
+		0, Red, Green, 0,
+		0, 0, 0, 0,
+	};
+	NAS2D::Image imageSheet{pixels, 4, {4, 4}};
+	NAS2D::SpriteAtlas atlas{{16, 16}};
+
+	const auto regions = atlas.add(imageSheet, {{{0, 0}, {4, 4}}, {{0, 0}, {2, 2}}, {{0, 0}, {4, 4}}});
+	ASSERT_EQ(3u, regions.size());
+	EXPECT_EQ(1u, atlas.pageCount());
+
+	const auto& region = regions[0];
+	EXPECT_EQ(&atlas.page(0), &region.image);
+	EXPECT_EQ((NAS2D::Vector{2, 1}), region.bounds.size);
+	EXPECT_EQ((NAS2D::Vector{1, 2}), region.trimOffset);
+	EXPECT_EQ((NAS2D::Vector{1, 1}), region.trimMargin);
+	EXPECT_EQ(NAS2D::Color::Red, region.image.pixelColor(region.bounds.position));
+	EXPECT_EQ(NAS2D::Color::Green, region.image.pixelColor(region.bounds.position + NAS2D::Vector{1, 0}));
+
+	// Fully transparent frames are empty
+	EXPECT_TRUE(regions[1].bounds.null());
+	EXPECT_EQ((NAS2D::Vector{2, 2}), regions[1].trimMargin);
+
+	// Frames with the same bounds are packed once
+	EXPECT_EQ(region.bounds, regions[2].bounds);
+
+	EXPECT_THROW(atlas.add(imageSheet, {{{2, 2}, {4, 4}}}), std::runtime_error);
+}
+
+TEST(SpriteAtlas, addPages) {
+	uint32_t pixels[8 * 4];
+	std::fill(std::begin(pixels), std::end(pixels), Red);
+	NAS2D::Image imageSheet{pixels, 4, {8, 4}};
+	NAS2D::SpriteAtlas atlas{{4, 4}};
+
+	const auto regions = atlas.add(imageSheet, {{{0, 0}, {3, 3}}, {{1, 0}, {3, 3}}, {{0, 0}, {8, 4}}});
+	EXPECT_EQ(3u, atlas.pageCount());
+	EXPECT_EQ(&atlas.page(0), &regions[0].image);
+	EXPECT_EQ(&atlas.page(1), &regions[1].image);
+	EXPECT_EQ(&atlas.page(2), &regions[2].image);
+	EXPECT_EQ((NAS2D::Vector{9, 5}), atlas.page(2).size());
+	EXPECT_THROW(atlas.page(3), std::runtime_error);
+}
+
+TEST(SpriteAtlas, trimmedFrameDrawPosition) {
+	uint32_t pixels[1] = {Red};
+	NAS2D::Image image{pixels, 4, {1, 1}};
+	const NAS2D::AnimationSet::Frame frame{image, {{0, 0}, {2, 1}}, {-1, -2}, 1, {1, 2}, {1, 1}};
+	EXPECT_EQ((NAS2D::Vector{4, 4}), frame.size());
+
+	// Same place as the bounds would be drawn if the whole frame was drawn and rotated
+	EXPECT_EQ((NAS2D::Point<float>{1, 2}), frame.drawPosition({0, 0}, 0));
+	const auto rotated = frame.drawPosition({0, 0}, 180);
+	EXPECT_NEAR(1.0f, rotated.x, 0.0001f);
+	EXPECT_NEAR(1.0f, rotated.y, 0.0001f);
+}
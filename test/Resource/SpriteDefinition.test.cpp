@@ -0,0 +1,111 @@
+#include "NAS2D/Resource/SpriteDefinition.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+namespace {
+	const std::string spriteXml =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<sprite version=\"0.99\">\n"
+		"	<imagesheet id=\"sheet1\" src=\"sheet1.png\" />\n"
+		"	<imagesheet id=\"sheet2\" src=\"sub/sheet2.png\" />\n"
+		"	<action name=\"walk\">\n"
+		"		<frame sheetid=\"sheet1\" delay=\"100\" x=\"0\" y=\"0\" width=\"32\" height=\"16\" anchorx=\"16\" anchory=\"8\" />\n"
+		"		<frame sheetid=\"sheet2\" x=\"32\" y=\"0\" width=\"32\" height=\"16\" anchorx=\"-1\" anchory=\"8\" />\n"
+		"	</action>\n"
+		"	<action name=\"idle\">\n"
+		"		<frame sheetid=\"sheet2\" delay=\"50\" x=\"1\" y=\"2\" width=\"3\" height=\"4\" anchorx=\"5\" anchory=\"6\" />\n"
+		"	</action>\n"
+		"</sprite>\n";
+
+	void expectEqual(const NAS2D::SpriteDefinition& expected, const NAS2D::SpriteDefinition& actual) {
+		ASSERT_EQ(expected.imageSheets.size(), actual.imageSheets.size());
+		for (std::size_t i = 0; i < expected.imageSheets.size(); ++i) {
+			EXPECT_EQ(expected.imageSheets[i].id, actual.imageSheets[i].id);
+			EXPECT_EQ(expected.imageSheets[i].path, actual.imageSheets[i].path);
+		}
+		ASSERT_EQ(expected.actions.size(), actual.actions.size());
+		for (std::size_t i = 0; i < expected.actions.size(); ++i) {
+			EXPECT_EQ(expected.actions[i].name, actual.actions[i].name);
+			ASSERT_EQ(expected.actions[i].frames.size(), actual.actions[i].frames.size());
+			for (std::size_t j = 0; j < expected.actions[i].frames.size(); ++j) {
+				const auto& expectedFrame = expected.actions[i].frames[j];
+				const auto& actualFrame = actual.actions[i].frames[j];
+				EXPECT_EQ(expectedFrame.sheetIndex, actualFrame.sheetIndex);
+				EXPECT_EQ(expectedFrame.bounds, actualFrame.bounds);
+				EXPECT_EQ(expectedFrame.anchorOffset, actualFrame.anchorOffset);
+				EXPECT_EQ(expectedFrame.frameDelay, actualFrame.frameDelay);
+			}
+		}
+	}
+}
+
+
+TEST(SpriteDefinition, parseSpriteXml) {
+	const auto definition = NAS2D::parseSpriteXml(spriteXml);
+
+	ASSERT_EQ(2u, definition.imageSheets.size());
+	EXPECT_EQ("sheet1", definition.imageSheets[0].id);
+	EXPECT_EQ("sub/sheet2.png", definition.imageSheets[1].path);
+
+	ASSERT_EQ(2u, definition.actions.size());
+	EXPECT_EQ("walk", definition.actions[0].name);
+	ASSERT_EQ(2u, definition.actions[0].frames.size());
+	const auto& frame = definition.actions[0].frames[1];
+	EXPECT_EQ(1u, frame.sheetIndex);
+	EXPECT_EQ((NAS2D::Rectangle<int>{{32, 0}, {32, 16}}), frame.bounds);
+	EXPECT_EQ((NAS2D::Vector{-1, 8}), frame.anchorOffset);
+	EXPECT_EQ(0u, frame.frameDelay);
+	EXPECT_EQ(100u, definition.actions[0].frames[0].frameDelay);
+}
+
+TEST(SpriteDefinition, parseSpriteXmlErrors) {
+	EXPECT_THROW(NAS2D::parseSpriteXml("<sprite>"), std::runtime_error);
+	EXPECT_THROW(NAS2D::parseSpriteXml("<sprite version=\"0.99\"><action name=\"a\"></action></sprite>"), std::runtime_error);
+	EXPECT_THROW(NAS2D::parseSpriteXml("<sprite version=\"0.99\"><action name=\"a\"><frame sheetid=\"missing\" x=\"0\" y=\"0\" width=\"1\" height=\"1\" anchorx=\"0\" anchory=\"0\" /></action></sprite>"), std::runtime_error);
+}
+
+TEST(SpriteDefinition, compiledSpritePath) {
+	EXPECT_EQ("data/unit.sprite.bin", NAS2D::compiledSpritePath("data/unit.sprite"));
+}
+
+TEST(SpriteDefinition, roundTrip) {
+	const auto definition = NAS2D::parseSpriteXml(spriteXml);
+	const auto fileData = NAS2D::writeCompiledSpriteFile(definition);
+
+	EXPECT_TRUE(NAS2D::isCompiledSpriteFile(fileData));
+	EXPECT_FALSE(NAS2D::isCompiledSpriteFile(spriteXml));
+	expectEqual(definition, NAS2D::readCompiledSpriteFile(fileData));
+}
+
+TEST(SpriteDefinition, readCompiledSpriteFileErrors) {
+	const auto fileData = NAS2D::writeCompiledSpriteFile(NAS2D::parseSpriteXml(spriteXml));
+
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(spriteXml), std::runtime_error);
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(std::string_view{fileData}.substr(0, fileData.size() - 1)), std::runtime_error);
+
+	auto wrongVersion = fileData;
+	wrongVersion[8] = 2;
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(wrongVersion), std::runtime_error);
+}
+
+TEST(SpriteDefinition, readCompiledSpriteFileInvalidContents) {
+	const auto definition = NAS2D::parseSpriteXml(spriteXml);
+	const auto fileData = NAS2D::writeCompiledSpriteFile(definition);
+
+	auto hugeCount = fileData;
+	hugeCount.replace(12, 4, "\xFF\xFF\xFF\xFF");
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(hugeCount), std::runtime_error);
+
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(fileData + '\0'), std::runtime_error);
+
+	auto emptyAction = definition;
+	emptyAction.actions[1].frames.clear();
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(NAS2D::writeCompiledSpriteFile(emptyAction)), std::runtime_error);
+
+	auto duplicateAction = definition;
+	duplicateAction.actions[1].name = duplicateAction.actions[0].name;
+	EXPECT_THROW(NAS2D::readCompiledSpriteFile(NAS2D::writeCompiledSpriteFile(duplicateAction)), std::runtime_error);
+}
@@ -0,0 +1,208 @@
+#include "NAS2D/Resource/SpriteSystem.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+
+class SpriteSystem : public ::testing::Test {
+protected:
+	class MockHandler {
+	public:
+		MOCK_CONST_METHOD1(MockMethod, void(NAS2D::SpriteSystem::Id));
+	};
+
+	uint32_t imageBuffer[1 * 1];
+	NAS2D::Image image{&imageBuffer, 4, {1, 1}};
+	NAS2D::AnimationSet::Frame frame1{image, {{0, 0}, {1, 1}}, {0, 0}, 2};
+	NAS2D::AnimationSet::Frame frame2{image, {{0, 0}, {1, 1}}, {0, 0}, 3};
+	NAS2D::AnimationSet::Frame frameStop{image, {{0, 0}, {1, 1}}, {0, 0}, 0};
+	NAS2D::AnimationSet testAnimationSet{{}, {{"defaultAction", {frame1, frame2}}, {"frameStopAction", {frame1, frameStop}}}};
+	NAS2D::SpriteSystem spriteSystem{};
+};
+
+
+TEST_F(SpriteSystem, addRemove) {
+	const auto id1 = spriteSystem.add(testAnimationSet, "defaultAction", {1, 2});
+	const auto id2 = spriteSystem.add(testAnimationSet, "defaultAction", {3, 4});
+	EXPECT_EQ(2u, spriteSystem.count());
+	EXPECT_TRUE(spriteSystem.contains(id1));
+	EXPECT_TRUE(spriteSystem.contains(id2));
+
+	spriteSystem.remove(id1);
+	EXPECT_EQ(1u, spriteSystem.count());
+	EXPECT_FALSE(spriteSystem.contains(id1));
+	EXPECT_EQ((NAS2D::Point<float>{3, 4}), spriteSystem.position(id2));
+	EXPECT_THROW(spriteSystem.position(id1), std::runtime_error);
+
+	const auto id3 = spriteSystem.add(testAnimationSet, "defaultAction");
+	EXPECT_EQ(id1, id3);
+	EXPECT_EQ((NAS2D::Point<float>{0, 0}), spriteSystem.position(id3));
+	EXPECT_EQ((NAS2D::Point<float>{3, 4}), spriteSystem.position(id2));
+
+	EXPECT_THROW(spriteSystem.add(testAnimationSet, "undefinedAction"), std::runtime_error);
+}
+
+TEST_F(SpriteSystem, update) {
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction");
+	spriteSystem.update(100);
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+	spriteSystem.update(101);
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+	spriteSystem.update(102);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+	spriteSystem.update(104);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+	spriteSystem.update(105);
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+	spriteSystem.update(112);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+}
+
+TEST_F(SpriteSystem, pause) {
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction");
+	spriteSystem.update(0);
+	spriteSystem.update(1);
+	spriteSystem.pause(id);
+	spriteSystem.update(100);
+	EXPECT_TRUE(spriteSystem.isPaused(id));
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+
+	spriteSystem.resume(id);
+	spriteSystem.update(101);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+}
+
+TEST_F(SpriteSystem, animationCompleteSignal) {
+	MockHandler handler{};
+	spriteSystem.animationCompleteSignalSource().connect({&handler, &MockHandler::MockMethod});
+
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction");
+	const auto stopId = spriteSystem.add(testAnimationSet, "frameStopAction");
+	spriteSystem.update(0);
+
+	EXPECT_CALL(handler, MockMethod(stopId));
+	spriteSystem.update(4);
+	EXPECT_TRUE(spriteSystem.isPaused(stopId));
+
+	EXPECT_CALL(handler, MockMethod(id)).Times(2);
+	spriteSystem.update(10);
+
+	EXPECT_CALL(handler, MockMethod(stopId));
+	spriteSystem.play(stopId, "frameStopAction");
+	spriteSystem.update(12);
+}
+
+TEST_F(SpriteSystem, updateMany) {
+	std::vector<NAS2D::SpriteSystem::Id> ids;
+	for (auto i = 0; i < 40000; ++i) {
+		ids.push_back(spriteSystem.add(testAnimationSet, (i % 2 == 0) ? "defaultAction" : "frameStopAction"));
+	}
+
+	MockHandler handler{};
+	spriteSystem.animationCompleteSignalSource().connect({&handler, &MockHandler::MockMethod});
+	EXPECT_CALL(handler, MockMethod(testing::_)).Times(20000);
+
+	spriteSystem.update(0);
+	spriteSystem.update(2);
+	for (std::size_t i = 0; i < ids.size(); ++i) {
+		EXPECT_EQ(1u, spriteSystem.frame(ids[i]));
+		EXPECT_EQ(i % 2 != 0, spriteSystem.isPaused(ids[i]));
+	}
+}
+
+TEST_F(SpriteSystem, seek) {
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction");
+	spriteSystem.seek(id, 1);
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+	spriteSystem.seek(id, 5 * 1000000 + 2);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+
+	// Playback continues from the time seeked to
+	spriteSystem.update(0);
+	spriteSystem.update(2);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+	spriteSystem.update(3);
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+
+	const auto stopId = spriteSystem.add(testAnimationSet, "frameStopAction");
+	spriteSystem.seek(stopId, 1000);
+	EXPECT_EQ(1u, spriteSystem.frame(stopId));
+	EXPECT_TRUE(spriteSystem.isPaused(stopId));
+}
+
+TEST_F(SpriteSystem, copy) {
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction", {1, 2});
+	spriteSystem.setFrame(id, 1);
+	spriteSystem.rotation(id, 90.0f);
+	spriteSystem.color(id, NAS2D::Color::Red);
+
+	const auto copyId = spriteSystem.copy(id);
+	EXPECT_NE(id, copyId);
+	EXPECT_EQ(2u, spriteSystem.count());
+	EXPECT_EQ(1u, spriteSystem.frame(copyId));
+	EXPECT_EQ((NAS2D::Point<float>{1, 2}), spriteSystem.position(copyId));
+	EXPECT_EQ(90.0f, spriteSystem.rotation(copyId));
+	EXPECT_EQ(NAS2D::Color::Red, spriteSystem.color(copyId));
+	EXPECT_EQ(&testAnimationSet, &spriteSystem.animationSet(copyId));
+	EXPECT_EQ(spriteSystem.action(id), spriteSystem.action(copyId));
+
+	spriteSystem.remove(id);
+	EXPECT_EQ(1u, spriteSystem.frame(copyId));
+}
+
+TEST_F(SpriteSystem, advanceSprite) {
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction");
+	const auto result = spriteSystem.advance(id, 3);
+	EXPECT_EQ(1u, result.frameIndex);
+	EXPECT_EQ(2u, result.elapsed);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+
+	// Time is given from the start of the current frame, and left over time is not kept
+	EXPECT_EQ(1u, spriteSystem.advance(id, 2).frameIndex);
+	const auto loopResult = spriteSystem.advance(id, 3);
+	EXPECT_EQ(0u, loopResult.frameIndex);
+	EXPECT_EQ(1u, loopResult.completions);
+
+	// Signals are left to the caller
+	MockHandler handler{};
+	spriteSystem.animationCompleteSignalSource().connect({&handler, &MockHandler::MockMethod});
+	EXPECT_CALL(handler, MockMethod(testing::_)).Times(0);
+	spriteSystem.advance(id, 5);
+}
+
+TEST_F(SpriteSystem, dormant) {
+	const auto id = spriteSystem.add(testAnimationSet, "defaultAction");
+	spriteSystem.dormant(id, true);
+	EXPECT_TRUE(spriteSystem.dormant(id));
+
+	// Time accumulates while dormant, and the frame is found when asked for
+	spriteSystem.update(0);
+	spriteSystem.update(5 * 1000 + 2);
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+
+	MockHandler handler{};
+	spriteSystem.animationCompleteSignalSource().connect({&handler, &MockHandler::MockMethod});
+	EXPECT_CALL(handler, MockMethod(id)).Times(1001);
+	spriteSystem.dormant(id, false);
+	EXPECT_FALSE(spriteSystem.dormant(id));
+	EXPECT_EQ(1u, spriteSystem.frame(id));
+
+	spriteSystem.update(5 * 1000 + 5);
+	EXPECT_EQ(0u, spriteSystem.frame(id));
+}
+
+TEST_F(SpriteSystem, cull) {
+	const auto inside = spriteSystem.add(testAnimationSet, "defaultAction", {5, 5});
+	const auto outside = spriteSystem.add(testAnimationSet, "defaultAction", {20, 5});
+	const auto rotated = spriteSystem.add(testAnimationSet, "defaultAction", {10.2f, 5});
+	spriteSystem.rotation(rotated, 45);
+
+	spriteSystem.cull({{0, 0}, {10, 10}});
+	EXPECT_FALSE(spriteSystem.dormant(inside));
+	EXPECT_TRUE(spriteSystem.dormant(outside));
+	EXPECT_FALSE(spriteSystem.dormant(rotated));
+
+	spriteSystem.position(outside, {9, 9});
+	spriteSystem.cull({{0, 0}, {10, 10}});
+	EXPECT_FALSE(spriteSystem.dormant(outside));
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "NAS2D/Resource/Font.h"
+#include "NAS2D/Resource/GlyphCache.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Font built from glyph metrics, without a font file or texture.
+ *
+ * Glyphs of the first 256 characters advance 10 pixels, and lines are 16
+ * pixels high. Tests change the metrics of particular glyphs with the
+ * function passed to the constructor.
+ */
+class TestFont : public NAS2D::Font {
+public:
+	using MetricsFunction = std::function<void(std::vector<NAS2D::Font::GlyphMetrics>& metrics)>;
+
+	explicit TestFont(const MetricsFunction& adjustMetrics = {}) :
+		NAS2D::Font{makeFontInfo(adjustMetrics)}
+	{}
+
+private:
+	static FontInfo makeFontInfo(const MetricsFunction& adjustMetrics) {
+		FontInfo fontInfo;
+		fontInfo.height = 16;
+		fontInfo.metrics.resize(256);
+		for (auto& metrics : fontInfo.metrics)
+		{
+			metrics.advance = 10;
+		}
+		if (adjustMetrics)
+		{
+			adjustMetrics(fontInfo.metrics);
+		}
+		return fontInfo;
+	}
+};
@@ -0,0 +1,81 @@
+#include "NAS2D/Resource/TextLayout.h"
+#include "TestFont.h"
+
+#include <gtest/gtest.h>
+
+
+namespace {
+	// Glyphs start a pixel after the pen position, which does not add to the width of text
+	void offsetGlyphs(std::vector<NAS2D::Font::GlyphMetrics>& metrics) {
+		for (auto& glyphMetrics : metrics)
+		{
+			glyphMetrics.minX = 1;
+		}
+	}
+}
+
+
+TEST(TextLayout, singleLine) {
+	const TestFont font{offsetGlyphs};
+	const NAS2D::TextLayout layout{font, "abc"};
+
+	ASSERT_EQ(3u, layout.glyphs().size());
+	EXPECT_EQ((NAS2D::Vector{0, 0}), layout.glyphs()[0].offset);
+	EXPECT_EQ((NAS2D::Vector{20, 0}), layout.glyphs()[2].offset);
+	EXPECT_EQ(1u, layout.lines().size());
+	EXPECT_EQ((NAS2D::Vector{30, 16}), layout.size());
+
+	// Measured width matches the laid out width
+	EXPECT_EQ(layout.size().x, font.width("abc"));
+}
+
+TEST(TextLayout, newlines) {
+	const TestFont font{offsetGlyphs};
+	const NAS2D::TextLayout layout{font, "a\nbc\n"};
+
+	ASSERT_EQ(3u, layout.lines().size());
+	EXPECT_EQ(10, layout.lines()[0].width);
+	EXPECT_EQ(20, layout.lines()[1].width);
+	EXPECT_EQ(0, layout.lines()[2].width);
+	ASSERT_EQ(3u, layout.glyphs().size());
+	EXPECT_EQ((NAS2D::Vector{0, 16}), layout.glyphs()[1].offset);
+	EXPECT_EQ((NAS2D::Vector{10, 16}), layout.glyphs()[2].offset);
+	EXPECT_EQ((NAS2D::Vector{20, 48}), layout.size());
+}
+
+TEST(TextLayout, wrap) {
+	const TestFont font{offsetGlyphs};
+	const NAS2D::TextLayout layout{font, "ab cd", 35};
+
+	ASSERT_EQ(2u, layout.lines().size());
+	EXPECT_EQ(3u, layout.lines()[0].glyphCount);
+	// Trailing spaces do not count towards the line width
+	EXPECT_EQ(20, layout.lines()[0].width);
+	EXPECT_EQ(20, layout.lines()[1].width);
+	EXPECT_EQ((NAS2D::Vector{0, 16}), layout.glyphs()[3].offset);
+	EXPECT_EQ((NAS2D::Vector{10, 16}), layout.glyphs()[4].offset);
+	EXPECT_EQ((NAS2D::Vector{20, 32}), layout.size());
+}
+
+TEST(TextLayout, wrapLongWord) {
+	const TestFont font{offsetGlyphs};
+	const NAS2D::TextLayout layout{font, "abcdef", 35};
+
+	// A single word wider than the maximum width is not broken
+	EXPECT_EQ(1u, layout.lines().size());
+	EXPECT_EQ((NAS2D::Vector{60, 16}), layout.size());
+}
+
+TEST(TextLayout, alignment) {
+	const TestFont font{offsetGlyphs};
+
+	const NAS2D::TextLayout right{font, "ab", 50, NAS2D::TextAlignment::Right};
+	EXPECT_EQ((NAS2D::Vector{30, 0}), right.glyphs()[0].offset);
+
+	const NAS2D::TextLayout center{font, "ab", 50, NAS2D::TextAlignment::Center};
+	EXPECT_EQ((NAS2D::Vector{15, 0}), center.glyphs()[0].offset);
+
+	// Without a maximum width, lines align within the widest line
+	const NAS2D::TextLayout lines{font, "abcd\nab", 0, NAS2D::TextAlignment::Right};
+	EXPECT_EQ((NAS2D::Vector{20, 16}), lines.glyphs()[4].offset);
+}
@@ -0,0 +1,48 @@
+#include "NAS2D/Resource/TextLayoutCache.h"
+#include "TestFont.h"
+
+#include <gtest/gtest.h>
+
+
+TEST(TextLayoutCache, hit) {
+	const TestFont font;
+	NAS2D::TextLayoutCache cache;
+
+	const auto& layout = cache.layout(font, "abc");
+	EXPECT_EQ((NAS2D::Vector{30, 16}), layout.size());
+	EXPECT_EQ(&layout, &cache.layout(font, "abc"));
+	EXPECT_EQ(1u, cache.size());
+}
+
+TEST(TextLayoutCache, keyedByLayoutParameters) {
+	const TestFont font;
+	const TestFont otherFont;
+	NAS2D::TextLayoutCache cache;
+
+	cache.layout(font, "a bc");
+	cache.layout(font, "a bd");
+	cache.layout(font, "a bc", 20);
+	cache.layout(font, "a bc", 0, NAS2D::TextAlignment::Right);
+	cache.layout(otherFont, "a bc");
+	EXPECT_EQ(5u, cache.size());
+
+	EXPECT_EQ(1u, cache.layout(font, "a bc").lines().size());
+	EXPECT_EQ(2u, cache.layout(font, "a bc", 20).lines().size());
+	EXPECT_EQ(5u, cache.size());
+}
+
+TEST(TextLayoutCache, evictsLeastRecentlyUsed) {
+	const TestFont font;
+	NAS2D::TextLayoutCache cache{2};
+
+	const auto* first = &cache.layout(font, "a");
+	cache.layout(font, "b");
+	EXPECT_EQ(first, &cache.layout(font, "a"));
+
+	cache.layout(font, "c");
+	EXPECT_EQ(2u, cache.size());
+	EXPECT_EQ(first, &cache.layout(font, "a"));
+
+	cache.clear();
+	EXPECT_EQ(0u, cache.size());
+}
@@ -0,0 +1,97 @@
+#include "NAS2D/Resource/TextMesh.h"
+#include "TestFont.h"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+
+
+namespace {
+	// Every glyph is 8x12 pixels. Spaces have nothing to draw, and digits are
+	// on a second texture.
+	void glyphSizes(std::vector<NAS2D::Font::GlyphMetrics>& metrics) {
+		for (std::size_t glyph = 0; glyph < metrics.size(); ++glyph)
+		{
+			metrics[glyph].size = {8, 12};
+			metrics[glyph].textureId = (glyph >= '0' && glyph <= '9') ? 2u : 1u;
+		}
+		metrics[' '].size = {0, 0};
+	}
+
+
+	class TestTextMesh : public NAS2D::TextMesh
+	{
+	public:
+		using TextMesh::TextMesh;
+		using TextMesh::batches;
+		using TextMesh::FloatsPerVertex;
+	};
+}
+
+
+TEST(TextMesh, build) {
+	const TestFont font{glyphSizes};
+	const TestTextMesh mesh{font, "ab 1\nc"};
+
+	EXPECT_EQ("ab 1\nc", mesh.text());
+	EXPECT_EQ((NAS2D::Vector{40, 32}), mesh.size());
+
+	// Consecutive glyphs on the same texture share a batch, and the space is skipped
+	const auto& batches = mesh.batches();
+	ASSERT_EQ(3u, batches.size());
+	EXPECT_EQ(1u, batches[0].textureId);
+	EXPECT_EQ(0, batches[0].firstVertex);
+	EXPECT_EQ(12, batches[0].vertexCount);
+	EXPECT_EQ(2u, batches[1].textureId);
+	EXPECT_EQ(12, batches[1].firstVertex);
+	EXPECT_EQ(6, batches[1].vertexCount);
+	EXPECT_EQ(1u, batches[2].textureId);
+	EXPECT_EQ(18, batches[2].firstVertex);
+	EXPECT_EQ(6, batches[2].vertexCount);
+}
+
+TEST(TextMesh, text) {
+	const TestFont font{glyphSizes};
+	TestTextMesh mesh{font, "ab"};
+	EXPECT_EQ((NAS2D::Vector{20, 16}), mesh.size());
+
+	mesh.text("abcd");
+	EXPECT_EQ("abcd", mesh.text());
+	EXPECT_EQ((NAS2D::Vector{40, 16}), mesh.size());
+	ASSERT_EQ(1u, mesh.batches().size());
+	EXPECT_EQ(24, mesh.batches()[0].vertexCount);
+
+	mesh.text("");
+	EXPECT_EQ((NAS2D::Vector{0, 16}), mesh.size());
+	EXPECT_TRUE(mesh.batches().empty());
+}
+
+TEST(TextMesh, color) {
+	const TestFont font{glyphSizes};
+	TestTextMesh mesh{font, "ab", NAS2D::Color::Red};
+	EXPECT_EQ(NAS2D::Color::Red, mesh.color());
+
+	mesh.color(NAS2D::Color::Blue);
+	EXPECT_EQ(NAS2D::Color::Blue, mesh.color());
+	EXPECT_EQ(1u, mesh.batches().size());
+}
+
+TEST(TextMesh, move) {
+	const TestFont font{glyphSizes};
+	TestTextMesh mesh{font, "ab1"};
+
+	TestTextMesh moved{std::move(mesh)};
+	EXPECT_EQ("ab1", moved.text());
+	EXPECT_EQ((NAS2D::Vector{30, 16}), moved.size());
+	EXPECT_EQ(2u, moved.batches().size());
+	EXPECT_EQ(&font, &moved.font());
+
+	EXPECT_TRUE(mesh.text().empty());
+	EXPECT_TRUE(mesh.batches().empty());
+
+	TestTextMesh assigned{font, "x"};
+	assigned = std::move(moved);
+	EXPECT_EQ("ab1", assigned.text());
+	EXPECT_EQ(2u, assigned.batches().size());
+	EXPECT_TRUE(moved.batches().empty());
+}
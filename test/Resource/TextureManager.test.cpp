@@ -0,0 +1,72 @@
+#include "NAS2D/Resource/TextureManager.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+
+class TextureManager : public ::testing::Test {
+protected:
+	class MockHandler {
+	public:
+		MOCK_METHOD0(MockMethod, void());
+	};
+
+	NAS2D::TextureManager textureManager{100};
+	MockHandler handler1{};
+	MockHandler handler2{};
+	MockHandler handler3{};
+};
+
+
+TEST_F(TextureManager, statistics) {
+	textureManager.add(1, 40, {&handler1, &MockHandler::MockMethod});
+	textureManager.add(2, 20);
+
+	const auto statistics = textureManager.statistics();
+	EXPECT_EQ(100u, statistics.budget);
+	EXPECT_EQ(60u, statistics.bytesUsed);
+	EXPECT_EQ(60u, statistics.peakBytesUsed);
+	EXPECT_EQ(2u, statistics.textureCount);
+	EXPECT_EQ(1u, statistics.pinnedCount);
+	EXPECT_EQ(2u, statistics.uploads);
+	EXPECT_EQ(0u, statistics.evictions);
+
+	textureManager.remove(1);
+	EXPECT_EQ(20u, textureManager.statistics().bytesUsed);
+	EXPECT_EQ(60u, textureManager.statistics().peakBytesUsed);
+	EXPECT_FALSE(textureManager.contains(1));
+	EXPECT_TRUE(textureManager.contains(2));
+	EXPECT_NO_THROW(textureManager.remove(1));
+
+	EXPECT_THROW(textureManager.add(2, 20), std::runtime_error);
+}
+
+TEST_F(TextureManager, evictsLeastRecentlyUsed) {
+	textureManager.add(1, 40, {&handler1, &MockHandler::MockMethod});
+	textureManager.add(2, 40, {&handler2, &MockHandler::MockMethod});
+	textureManager.touch(1);
+
+	EXPECT_CALL(handler1, MockMethod()).Times(0);
+	EXPECT_CALL(handler2, MockMethod());
+	textureManager.add(3, 40, {&handler3, &MockHandler::MockMethod});
+
+	EXPECT_TRUE(textureManager.contains(1));
+	EXPECT_FALSE(textureManager.contains(2));
+	EXPECT_TRUE(textureManager.contains(3));
+	EXPECT_EQ(80u, textureManager.statistics().bytesUsed);
+	EXPECT_EQ(1u, textureManager.statistics().evictions);
+}
+
+TEST_F(TextureManager, pinnedTexturesAreNotEvicted) {
+	textureManager.add(1, 60, {&handler1, &MockHandler::MockMethod});
+	textureManager.pin(1);
+
+	EXPECT_CALL(handler1, MockMethod()).Times(0);
+	EXPECT_CALL(handler2, MockMethod()).Times(0);
+	textureManager.add(2, 60, {&handler2, &MockHandler::MockMethod});
+	EXPECT_EQ(120u, textureManager.statistics().bytesUsed);
+
+	EXPECT_CALL(handler2, MockMethod());
+	textureManager.budget(80);
+	EXPECT_EQ(60u, textureManager.statistics().bytesUsed);
+}
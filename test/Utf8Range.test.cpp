@@ -0,0 +1,71 @@
+#include "NAS2D/Utf8Range.h"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <vector>
+
+
+namespace
+{
+	std::vector<char32_t> decode(std::string_view string)
+	{
+		std::vector<char32_t> codepoints;
+		for (const auto codepoint : NAS2D::Utf8Range{string})
+		{
+			codepoints.push_back(codepoint);
+		}
+		return codepoints;
+	}
+}
+
+
+TEST(Utf8Range, ascii) {
+	EXPECT_EQ((std::vector<char32_t>{}), decode(""));
+	EXPECT_EQ((std::vector<char32_t>{'a', 'b', 'c'}), decode("abc"));
+}
+
+TEST(Utf8Range, multiByte) {
+	EXPECT_EQ((std::vector<char32_t>{0xE9}), decode("\xC3\xA9"));
+	EXPECT_EQ((std::vector<char32_t>{0x20AC}), decode("\xE2\x82\xAC"));
+	EXPECT_EQ((std::vector<char32_t>{0x1F600}), decode("\xF0\x9F\x98\x80"));
+	EXPECT_EQ((std::vector<char32_t>{'a', 0x4E2D, 'b'}), decode("a\xE4\xB8\xAD" "b"));
+}
+
+TEST(Utf8Range, invalidBytesDecodeAsLatin1) {
+	EXPECT_EQ((std::vector<char32_t>{0xE9, 't', 0xE9}), decode("\xE9t\xE9"));
+	EXPECT_EQ((std::vector<char32_t>{0xC3}), decode("\xC3"));
+	// Overlong encoding of '/'
+	EXPECT_EQ((std::vector<char32_t>{0xC0, 0xAF}), decode("\xC0\xAF"));
+	// UTF-16 surrogate
+	EXPECT_EQ((std::vector<char32_t>{0xED, 0xA0, 0x80}), decode("\xED\xA0\x80"));
+}
+
+TEST(Utf8Range, decodeUtf8) {
+	constexpr std::string_view string{"a\xE2\x82\xAC"};
+	std::size_t index = 0;
+	EXPECT_EQ(U'a', NAS2D::decodeUtf8(string, index));
+	EXPECT_EQ(1u, index);
+	EXPECT_EQ(U'€', NAS2D::decodeUtf8(string, index));
+	EXPECT_EQ(4u, index);
+}
+
+TEST(Utf8Range, appendUtf8) {
+	const auto encode = [](char32_t codepoint) {
+		std::string string;
+		NAS2D::appendUtf8(string, codepoint);
+		return string;
+	};
+
+	EXPECT_EQ("a", encode('a'));
+	EXPECT_EQ("\xC3\xA9", encode(0xE9));
+	EXPECT_EQ("\xE2\x82\xAC", encode(0x20AC));
+	EXPECT_EQ("\xF0\x9F\x98\x80", encode(0x1F600));
+	EXPECT_EQ("\xEF\xBF\xBD", encode(0xD800));
+	EXPECT_EQ("\xEF\xBF\xBD", encode(0x110000));
+
+	for (const char32_t codepoint : {char32_t{0x7F}, char32_t{0x80}, char32_t{0x7FF}, char32_t{0x800}, char32_t{0xFFFF}, char32_t{0x10000}, char32_t{0x10FFFF}})
+	{
+		EXPECT_EQ((std::vector<char32_t>{codepoint}), decode(encode(codepoint)));
+	}
+}
@@ -0,0 +1,58 @@
+#include "NAS2D/WorkerPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(WorkerPool, defaultSize) {
+	EXPECT_EQ(1u, NAS2D::WorkerPool::defaultSize(0));
+	EXPECT_EQ(1u, NAS2D::WorkerPool::defaultSize(1));
+	EXPECT_LE(NAS2D::WorkerPool::defaultSize(4), 4u);
+}
+
+TEST(WorkerPool, runCallsEachWorkerOnce) {
+	NAS2D::WorkerPool workers{4};
+	EXPECT_EQ(4u, workers.size());
+
+	for (int run = 0; run < 3; ++run)
+	{
+		std::vector<std::atomic<int>> calls(workers.size());
+		workers.run([&calls](unsigned int worker) { ++calls[worker]; });
+		for (const auto& count : calls)
+		{
+			EXPECT_EQ(1, count);
+		}
+	}
+}
+
+TEST(WorkerPool, runOnCallingThread) {
+	NAS2D::WorkerPool workers{1};
+	EXPECT_EQ(1u, workers.size());
+
+	unsigned int calledWorker = 1;
+	workers.run([&calledWorker](unsigned int worker) { calledWorker = worker; });
+	EXPECT_EQ(0u, calledWorker);
+}
+
+TEST(WorkerPool, runRethrows) {
+	NAS2D::WorkerPool workers{3};
+	std::atomic<int> calls{0};
+	const auto task = [&calls](unsigned int worker) {
+		++calls;
+		if (worker == 2)
+		{
+			throw std::runtime_error("Worker failed");
+		}
+	};
+
+	EXPECT_THROW(workers.run(task), std::runtime_error);
+	EXPECT_EQ(3, calls);
+
+	// The pool is still usable after a failed run
+	calls = 0;
+	workers.run([&calls](unsigned int) { ++calls; });
+	EXPECT_EQ(3, calls);
+}